@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Trees/ConcurrentRedBlackTree/ConcurrentRedBlackTree.hpp"
+#include "Trees/ConcurrentSkipList/ConcurrentSkipList.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/ShardedTree/ShardedTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Workloads.hpp"
+
+#ifndef BENCHMARK_MAX_THREADS
+#define BENCHMARK_MAX_THREADS 32
+#endif
+
+namespace Benchmarks {
+
+    using Key = std::int64_t;
+
+    // half of the universe is in the tree, so lookups hit every other time
+    constexpr std::uint64_t TreeSize = std::uint64_t(1) << 20;
+    constexpr std::uint64_t Universe = TreeSize * 2;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Containers
+    ///////////////////////////////////////////////////////////////////////////////
+    // the baseline: a RedBlackTree behind one global mutex
+    struct LockedRedBlackTree {
+        std::mutex                             Mutex;
+        DataStructures::RedBlackTree<Key, Key> Tree;
+    };
+
+    using ConcurrentRedBlackTree = DataStructures::ConcurrentRedBlackTree<Key, Key>;
+    using ConcurrentSkipList     = DataStructures::ConcurrentSkipList<Key, Key>;
+    using ShardedRedBlackTree    = DataStructures::ShardedTree<DataStructures::RedBlackTree, Key, Key>;
+    using ShardedSplayTree       = DataStructures::ShardedTree<DataStructures::SplayTree, Key, Key>;
+
+    inline bool Contains(LockedRedBlackTree& locked, Key key) {
+        std::lock_guard<std::mutex> lock(locked.Mutex);
+
+        return locked.Tree.IsExists(key);
+    }
+
+    inline void Insert(LockedRedBlackTree& locked, Key key) {
+        std::lock_guard<std::mutex> lock(locked.Mutex);
+
+        locked.Tree.Push(key, key);
+    }
+
+    inline void Erase(LockedRedBlackTree& locked, Key key) {
+        std::lock_guard<std::mutex> lock(locked.Mutex);
+
+        locked.Tree.Pop(key);
+    }
+
+    inline bool Contains(ConcurrentRedBlackTree& tree, Key key) { return tree.IsExists(key); }
+    inline void Insert(ConcurrentRedBlackTree& tree, Key key) { tree.Push(key, key); }
+    inline void Erase(ConcurrentRedBlackTree& tree, Key key) { tree.Pop(key); }
+
+    inline bool Contains(ConcurrentSkipList& list, Key key) { return list.IsExists(key); }
+    inline void Insert(ConcurrentSkipList& list, Key key) { list.Push(key, key); }
+    inline void Erase(ConcurrentSkipList& list, Key key) { list.Pop(key); }
+
+    template <template <typename, typename> typename Engine>
+    inline bool Contains(DataStructures::ShardedTree<Engine, Key, Key>& tree, Key key) { return tree.IsExists(key); }
+
+    template <template <typename, typename> typename Engine>
+    inline void Insert(DataStructures::ShardedTree<Engine, Key, Key>& tree, Key key) { tree.Push(key, key); }
+
+    template <template <typename, typename> typename Engine>
+    inline void Erase(DataStructures::ShardedTree<Engine, Key, Key>& tree, Key key) { tree.Pop(key); }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Shared state
+    ///////////////////////////////////////////////////////////////////////////////
+    // Threads of one run share the container and the operation stream, both are
+    // built before the threads start and dropped after they finish.
+    template <typename Container>
+    struct Shared {
+        static inline std::unique_ptr<Container>  Tree;
+        static inline std::vector<std::uint64_t> Stream;
+    };
+
+    template <typename Container>
+    void Setup(const benchmark::State&) {
+        Shared<Container>::Tree   = std::make_unique<Container>();
+        Shared<Container>::Stream = MakeStream(Workload::Uniform, Universe, TreeSize, 2);
+
+        for (std::uint64_t index : MakeStream(Workload::Uniform, TreeSize, TreeSize, 1))
+            Insert(*Shared<Container>::Tree, static_cast<Key>(index * 2));
+    }
+
+    template <typename Container>
+    void Teardown(const benchmark::State&) {
+        Shared<Container>::Tree.reset();
+        Shared<Container>::Stream.clear();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Benchmarks
+    ///////////////////////////////////////////////////////////////////////////////
+    // WritePercent of the operations alternate between Push and Pop of random
+    // keys, which keeps the size around TreeSize, the rest are lookups.
+    template <typename Container, int WritePercent>
+    void BM_Mixed(benchmark::State& state) {
+        Container&                        container = *Shared<Container>::Tree;
+        const std::vector<std::uint64_t>& stream    = Shared<Container>::Stream;
+
+        // threads start at different points of the stream
+        std::size_t   position   = static_cast<std::size_t>(state.thread_index()) * 7919 % stream.size();
+        std::uint64_t operations = 0;
+
+        for (auto _ : state) {
+            const auto key  = static_cast<Key>(stream[position]);
+            const int  kind = static_cast<int>(operations % 100);
+
+            if (kind >= WritePercent)
+                benchmark::DoNotOptimize(Contains(container, key));
+            else if (kind & 1)
+                Insert(container, key);
+            else
+                Erase(container, key);
+
+            if (++position == stream.size())
+                position = 0;
+
+            ++operations;
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(operations));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Registration
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Container, int WritePercent>
+    void Register(const std::string& name, const char* mix) {
+        const std::string fullName = std::string(mix) + "/" + name;
+
+        benchmark::RegisterBenchmark(fullName.c_str(), &BM_Mixed<Container, WritePercent>)
+            ->Setup(&Setup<Container>)
+            ->Teardown(&Teardown<Container>)
+            ->ThreadRange(1, BENCHMARK_MAX_THREADS)
+            ->UseRealTime();
+    }
+
+    template <typename Container>
+    void RegisterContainer(const std::string& name) {
+        Register<Container, 0>(name, "ReadOnly");
+        Register<Container, 10>(name, "ReadMostly");
+        Register<Container, 50>(name, "Balanced");
+    }
+
+} // namespace Benchmarks
+
+int main(int argc, char** argv) {
+    Benchmarks::RegisterContainer<Benchmarks::LockedRedBlackTree>("LockedRedBlackTree");
+    Benchmarks::RegisterContainer<Benchmarks::ConcurrentRedBlackTree>("ConcurrentRedBlackTree");
+    Benchmarks::RegisterContainer<Benchmarks::ConcurrentSkipList>("ConcurrentSkipList");
+    Benchmarks::RegisterContainer<Benchmarks::ShardedRedBlackTree>("ShardedRedBlackTree");
+    Benchmarks::RegisterContainer<Benchmarks::ShardedSplayTree>("ShardedSplayTree");
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,819 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "Trees/BTree/BTree.hpp"
+#include "Trees/ConcurrentSkipList/ConcurrentSkipList.hpp"
+#include "Trees/FrozenTree/FrozenTree.hpp"
+#include "Trees/PagedTree/PagedTree.hpp"
+#include "Trees/PersistentRedBlackTree/PersistentRedBlackTree.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+#include "Trees/TreeImage/TreeImage.hpp"
+
+#include "Workloads.hpp"
+
+#ifndef BENCHMARK_MAX_SIZE
+#define BENCHMARK_MAX_SIZE 1000000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// Allocation counting
+///////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::atomic<std::uint64_t> g_AllocationCount { 0 };
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Benchmarks {
+
+    using Key = std::int64_t;
+
+    using BTree                  = DataStructures::BTree<Key, Key>;
+    using ConcurrentSkipList     = DataStructures::ConcurrentSkipList<Key, Key>;
+    using FrozenTree             = DataStructures::FrozenTree<Key, Key>;
+    using PersistentRedBlackTree = DataStructures::PersistentRedBlackTree<Key, Key>;
+    using RedBlackTree           = DataStructures::RedBlackTree<Key, Key>;
+    using SplayTree              = DataStructures::SplayTree<Key, Key>;
+    using TreeImage              = DataStructures::TreeImage<Key, Key>;
+    using Map                    = std::map<Key, Key>;
+    using Set                    = std::set<Key>;
+
+    // string keys looked up by std::string_view, built into a std::string first
+    // unless the order is transparent
+    template <template <typename, typename, bool, typename, template <typename> typename, typename> typename Tree>
+    using StringTree = Tree<std::string, Key, false, void, DataStructures::NodePool, DataStructures::KeyLess<std::string>>;
+
+    template <template <typename, typename, bool, typename, template <typename> typename, typename> typename Tree>
+    using TransparentStringTree = Tree<std::string, Key, false, void, DataStructures::NodePool, DataStructures::KeyLess<>>;
+
+    // lookups cycle through a stream of at most this many keys
+    constexpr std::size_t MaxQueryCount = std::size_t(1) << 20;
+
+    // keys per call of the batched operations
+    constexpr std::size_t BatchSize = 256;
+
+    // PagedTree caches 4 MiB of its pages, a fraction of the larger trees
+    constexpr std::size_t PagedTreeMemoryBudget = std::size_t(4) << 20;
+
+    // images are saved to and loaded from this file, it is removed on exit
+    inline std::string GetImagePath() {
+        static const std::string path = (std::filesystem::temp_directory_path() / "TreeBenchmarks.image").string();
+
+        return path;
+    }
+
+    inline std::string GetPagedTreePath() {
+        static const std::string path = (std::filesystem::temp_directory_path() / "TreeBenchmarks.pages").string();
+
+        return path;
+    }
+
+    // The suite builds and returns containers by value, a PagedTree cannot move
+    // since its pool refers to its file. Every one starts from a new file.
+    class PagedTree {
+    public:
+        using Tree = DataStructures::PagedTree<Key, Key>;
+
+        PagedTree()
+            : m_Tree((std::filesystem::remove(GetPagedTreePath()), std::make_unique<Tree>(GetPagedTreePath(), PagedTreeMemoryBudget))) {}
+
+        inline void Push(Key key, Key value) { m_Tree->Push(key, value); }
+        inline void Pop(Key key) { m_Tree->Pop(key); }
+        [[nodiscard]] inline Key Get(Key key) const { return m_Tree->Get(key); }
+        [[nodiscard]] inline bool IsExists(Key key) const { return m_Tree->IsExists(key); }
+        inline void Clear() { m_Tree->Clear(); }
+
+        [[nodiscard]] Tree::ConstIterator begin() const { return m_Tree->begin(); }
+        [[nodiscard]] Tree::ConstIterator end() const { return m_Tree->end(); }
+
+    private:
+        std::unique_ptr<Tree> m_Tree;
+
+    }; // class PagedTree
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Container adapters
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Tree>
+    inline void Insert(Tree& tree, Key key) { tree.Push(key, key); }
+    inline void Insert(Map& map, Key key) { map.emplace(key, key); }
+    inline void Insert(Set& set, Key key) { set.insert(key); }
+
+    template <typename Tree>
+    inline void Erase(Tree& tree, Key key) { tree.Pop(key); }
+    inline void Erase(Map& map, Key key) { map.erase(key); }
+    inline void Erase(Set& set, Key key) { set.erase(key); }
+
+    template <typename Tree>
+    inline Key Get(Tree& tree, Key key) { return tree.Get(key); }
+    inline Key Get(Map& map, Key key) { return map.find(key)->second; }
+    inline Key Get(Set& set, Key key) { return *set.find(key); }
+
+    template <typename Tree>
+    inline bool Contains(Tree& tree, Key key) { return tree.IsExists(key); }
+    inline bool Contains(Map& map, Key key) { return map.count(key) != 0; }
+    inline bool Contains(Set& set, Key key) { return set.count(key) != 0; }
+
+    template <typename Tree>
+    inline void Clear(Tree& tree) { tree.Clear(); }
+    inline void Clear(Map& map) { map.clear(); }
+    inline void Clear(Set& set) { set.clear(); }
+
+    // a point-in-time copy the writer can keep changing the tree under
+    inline PersistentRedBlackTree::View TakeSnapshot(const PersistentRedBlackTree& tree) { return tree.Snapshot(); }
+    inline RedBlackTree TakeSnapshot(const RedBlackTree& tree) { return RedBlackTree::FromSorted(tree.begin(), tree.end()); }
+
+    template <typename Tree>
+    inline Key GetByView(Tree& tree, std::string_view key) {
+        using Compare = std::decay_t<decltype(tree.GetCompare())>;
+
+        if constexpr (DataStructures::IsTransparent<Compare, std::string_view>::value)
+            return tree.Get(key);
+        else
+            return tree.Get(std::string(key));
+    }
+
+    template <typename Pair>
+    inline Key GetKey(const Pair& pair) { return pair.first; }
+    inline Key GetKey(Key key) { return key; }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Reporting
+    ///////////////////////////////////////////////////////////////////////////////
+    // 0 where getrusage is not available
+    inline double GetPeakResidentMiB() {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage {};
+
+        getrusage(RUSAGE_SELF, &usage);
+
+#if defined(__APPLE__)
+        // ru_maxrss is in bytes on macOS
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+        // and in KiB on Linux
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+#else
+        return 0.0;
+#endif
+    }
+
+    // time/op and allocs/op are averaged over every timed operation; peak RSS is
+    // the high-water mark of the whole process, so run a single benchmark with
+    // --benchmark_filter to attribute it.
+    inline void Report(benchmark::State& state, std::uint64_t operationCount, std::uint64_t allocationCount) {
+        const auto operations = static_cast<double>(operationCount);
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(operationCount));
+
+        state.counters["time/op"]   = benchmark::Counter(operations, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+        state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocationCount) / operations);
+        state.counters["peak_MiB"]  = benchmark::Counter(GetPeakResidentMiB());
+    }
+
+    template <typename Container>
+    void Fill(Container& container, const std::vector<std::uint64_t>& stream) {
+        for (std::uint64_t index : stream)
+            Insert(container, static_cast<Key>(index * 2));
+    }
+
+    template <typename Container>
+    Container Build(const std::vector<std::uint64_t>& stream) {
+        Container container;
+
+        Fill(container, stream);
+
+        return container;
+    }
+
+    // snapshots are read-only, they are frozen from a tree holding the same keys
+    template <>
+    FrozenTree Build<FrozenTree>(const std::vector<std::uint64_t>& stream) {
+        return Build<RedBlackTree>(stream).Freeze();
+    }
+
+    template <>
+    TreeImage Build<TreeImage>(const std::vector<std::uint64_t>& stream) {
+        Build<RedBlackTree>(stream).Save(GetImagePath());
+
+        return TreeImage::Open(GetImagePath());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Benchmarks
+    ///////////////////////////////////////////////////////////////////////////////
+    // Keys are even indices of the workload stream, so odd keys are guaranteed misses.
+    template <typename Container>
+    void BM_Push(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        std::optional<Container> container;
+
+        // Construction and destruction stay out of the timing: PagedTree creates
+        // its file in one and flushes it in the other.
+        for (auto _ : state) {
+            state.PauseTiming();
+            container.emplace();
+            state.ResumeTiming();
+
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            Fill(*container, stream);
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += stream.size();
+
+            state.PauseTiming();
+            container.reset();
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    template <typename Container>
+    void BM_Pop(benchmark::State& state, Workload workload) {
+        const auto size    = static_cast<std::uint64_t>(state.range(0));
+        const auto content = MakeStream(Workload::Uniform, size, size, 1);
+        const auto stream  = MakeStream(workload, size, size, 2);
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        std::optional<Container> container;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            container.emplace();
+            Fill(*container, content);
+            state.ResumeTiming();
+
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            for (std::uint64_t index : stream)
+                Erase(*container, static_cast<Key>(index * 2));
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += stream.size();
+
+            state.PauseTiming();
+            container.reset();
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    template <typename Container, bool IsMissAllowed>
+    void BM_Lookup(benchmark::State& state, Workload workload) {
+        const auto size    = static_cast<std::uint64_t>(state.range(0));
+        const auto content = MakeStream(Workload::Uniform, size, size, 1);
+        const auto stream  = MakeStream(workload, size, std::min<std::uint64_t>(size, MaxQueryCount), 2);
+
+        Container container = Build<Container>(content);
+
+        std::vector<Key> queries(stream.size());
+
+        // IsExists queries miss every other time
+        for (std::size_t i = 0; i < stream.size(); ++i)
+            queries[i] = static_cast<Key>(stream[i] * 2 + (IsMissAllowed ? i & 1 : 0));
+
+        std::uint64_t operations = 0;
+        std::size_t   position   = 0;
+
+        const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+        for (auto _ : state) {
+            if constexpr (IsMissAllowed)
+                benchmark::DoNotOptimize(Contains(container, queries[position]));
+            else
+                benchmark::DoNotOptimize(Get(container, queries[position]));
+
+            if (++position == queries.size())
+                position = 0;
+
+            ++operations;
+        }
+
+        Report(state, operations, g_AllocationCount.load(std::memory_order_relaxed) - before);
+    }
+
+    template <typename Container>
+    void BM_Get(benchmark::State& state, Workload workload) {
+        BM_Lookup<Container, false>(state, workload);
+    }
+
+    template <typename Container>
+    void BM_IsExists(benchmark::State& state, Workload workload) {
+        BM_Lookup<Container, true>(state, workload);
+    }
+
+    // The batched operations against the same keys one at a time: GetBatch and
+    // IsExistsBatch time BatchSize lookups per iteration, PushBatch fills the
+    // tree in batches of BatchSize.
+    template <typename Container, bool IsMissAllowed>
+    void BM_LookupBatch(benchmark::State& state, Workload workload) {
+        const auto size    = static_cast<std::uint64_t>(state.range(0));
+        const auto content = MakeStream(Workload::Uniform, size, size, 1);
+        const auto stream  = MakeStream(workload, size, std::max<std::uint64_t>(std::min<std::uint64_t>(size, MaxQueryCount), BatchSize), 2);
+
+        Container container = Build<Container>(content);
+
+        std::vector<Key> queries(stream.size());
+
+        for (std::size_t i = 0; i < stream.size(); ++i)
+            queries[i] = static_cast<Key>(stream[i] * 2 + (IsMissAllowed ? i & 1 : 0));
+
+        bool isExists[BatchSize];
+        Key* values[BatchSize];
+
+        std::uint64_t operations = 0;
+        std::size_t   position   = 0;
+
+        const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+        for (auto _ : state) {
+            if (position + BatchSize > queries.size())
+                position = 0;
+
+            if constexpr (IsMissAllowed) {
+                container.ContainsBatch(queries.data() + position, BatchSize, isExists);
+                benchmark::DoNotOptimize(isExists);
+            } else {
+                container.GetBatch(queries.data() + position, BatchSize, values);
+                benchmark::DoNotOptimize(values);
+            }
+
+            position   += BatchSize;
+            operations += BatchSize;
+        }
+
+        Report(state, operations, g_AllocationCount.load(std::memory_order_relaxed) - before);
+    }
+
+    template <typename Container>
+    void BM_GetBatch(benchmark::State& state, Workload workload) {
+        BM_LookupBatch<Container, false>(state, workload);
+    }
+
+    template <typename Container>
+    void BM_IsExistsBatch(benchmark::State& state, Workload workload) {
+        BM_LookupBatch<Container, true>(state, workload);
+    }
+
+    template <typename Container>
+    void BM_PushBatch(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        std::vector<Key> keys(stream.size());
+
+        for (std::size_t i = 0; i < stream.size(); ++i)
+            keys[i] = static_cast<Key>(stream[i] * 2);
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        std::optional<Container> container;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            container.emplace();
+            state.ResumeTiming();
+
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            for (std::size_t first = 0; first < keys.size(); first += BatchSize)
+                container->PushBatch(keys.data() + first, keys.data() + first, std::min(BatchSize, keys.size() - first));
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += keys.size();
+
+            state.PauseTiming();
+            container.reset();
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    enum class MergeOperation : int {
+        PushLoop = 0,
+        Union,
+        Intersection,
+        Difference
+    };
+
+    inline DataStructures::ThreadPool& GetThreadPool() {
+        static DataStructures::ThreadPool pool;
+
+        return pool;
+    }
+
+    inline std::vector<std::pair<Key, Key>> MakeSortedPairs(const std::vector<std::uint64_t>& stream, std::uint64_t scale) {
+        std::vector<std::pair<Key, Key>> pairs;
+
+        pairs.reserve(stream.size());
+
+        for (std::uint64_t index : stream)
+            pairs.emplace_back(static_cast<Key>(index * scale), static_cast<Key>(index));
+
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first; }), pairs.end());
+
+        return pairs;
+    }
+
+    // Combines a base tree of even keys with a delta a quarter of its size, about
+    // half of whose keys are odd and new to the base. PushLoop is the merge by
+    // hand: every delta key assigned into the base. time/op is per delta key.
+    template <MergeOperation Operation, bool IsParallel>
+    void BM_Merge(benchmark::State& state, Workload workload) {
+        const auto size  = static_cast<std::uint64_t>(state.range(0));
+        const auto base  = MakeSortedPairs(MakeStream(workload, size, size, 1), 2);
+        const auto delta = MakeSortedPairs(MakeStream(workload, size, size / 4, 2), 1);
+
+        DataStructures::ThreadPool* pool = IsParallel ? &GetThreadPool() : nullptr;
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            RedBlackTree tree  = RedBlackTree::FromSorted(base.begin(), base.end());
+            RedBlackTree other = RedBlackTree::FromSorted(delta.begin(), delta.end());
+            state.ResumeTiming();
+
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            if constexpr (Operation == MergeOperation::PushLoop) {
+                for (const auto& [key, value] : delta)
+                    tree[key] = value;
+            } else if constexpr (Operation == MergeOperation::Union) {
+                tree = RedBlackTree::Union(std::move(tree), std::move(other), pool);
+            } else if constexpr (Operation == MergeOperation::Intersection) {
+                tree = RedBlackTree::Intersection(std::move(tree), std::move(other), pool);
+            } else {
+                tree = RedBlackTree::Difference(std::move(tree), std::move(other), pool);
+            }
+
+            benchmark::DoNotOptimize(tree.GetRoot());
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += delta.size();
+
+            state.PauseTiming();
+            Clear(tree);
+            Clear(other);
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    template <typename Container>
+    void BM_TakeSnapshot(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        Container container = Build<Container>(stream);
+
+        std::uint64_t operations = 0;
+
+        const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+        for (auto _ : state) {
+            auto snapshot = TakeSnapshot(container);
+
+            benchmark::DoNotOptimize(snapshot);
+
+            ++operations;
+        }
+
+        Report(state, operations, g_AllocationCount.load(std::memory_order_relaxed) - before);
+    }
+
+    // Keys long enough to live on the heap, sharing a prefix like the paths or
+    // qualified names a parser looks up.
+    inline std::string MakeStringKey(std::uint64_t index) {
+        std::string key = "Ng/DataStructures/Trees/";
+
+        key += std::to_string(index);
+
+        return key;
+    }
+
+    // The queries are views into one buffer, as a parser would hand them out.
+    template <typename Container>
+    void BM_GetByView(benchmark::State& state, Workload workload) {
+        const auto size    = static_cast<std::uint64_t>(state.range(0));
+        const auto content = MakeStream(Workload::Uniform, size, size, 1);
+        const auto stream  = MakeStream(workload, size, std::min<std::uint64_t>(size, MaxQueryCount), 2);
+
+        Container container;
+
+        for (std::uint64_t index : content)
+            container.Push(MakeStringKey(index), static_cast<Key>(index));
+
+        std::string                   buffer;
+        std::vector<std::size_t>      offsets;
+        std::vector<std::string_view> queries;
+
+        for (std::uint64_t index : stream) {
+            offsets.push_back(buffer.size());
+            buffer += MakeStringKey(index);
+        }
+
+        offsets.push_back(buffer.size());
+
+        for (std::size_t i = 0; i < stream.size(); ++i)
+            queries.emplace_back(buffer.data() + offsets[i], offsets[i + 1] - offsets[i]);
+
+        std::uint64_t operations = 0;
+        std::size_t   position   = 0;
+
+        const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(GetByView(container, queries[position]));
+
+            if (++position == queries.size())
+                position = 0;
+
+            ++operations;
+        }
+
+        Report(state, operations, g_AllocationCount.load(std::memory_order_relaxed) - before);
+    }
+
+    // A warm restart: the tree is loaded from an image in the page cache, against
+    // refilling it with Push.
+    template <typename Container>
+    void BM_Load(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        Build<Container>(stream).Save(GetImagePath());
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        for (auto _ : state) {
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            Container container = Container::Load(GetImagePath());
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += static_cast<std::uint64_t>(container.GetSize());
+
+            state.PauseTiming();
+            Clear(container);
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    template <typename Container>
+    void BM_Iterate(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        Container container = Build<Container>(stream);
+
+        std::uint64_t operations = 0;
+
+        const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+        for (auto _ : state) {
+            Key sum = 0;
+
+            for (const auto& element : container)
+                sum += GetKey(element);
+
+            benchmark::DoNotOptimize(sum);
+
+            operations += size;
+        }
+
+        Report(state, operations, g_AllocationCount.load(std::memory_order_relaxed) - before);
+    }
+
+    template <typename Container>
+    void BM_Teardown(benchmark::State& state, Workload workload) {
+        const auto size   = static_cast<std::uint64_t>(state.range(0));
+        const auto stream = MakeStream(workload, size, size, 1);
+
+        std::uint64_t operations  = 0;
+        std::uint64_t allocations = 0;
+
+        std::optional<Container> container;
+
+        // only Clear is timed, the destructor runs on the empty container
+        for (auto _ : state) {
+            state.PauseTiming();
+            container.emplace();
+            Fill(*container, stream);
+            state.ResumeTiming();
+
+            const std::uint64_t before = g_AllocationCount.load(std::memory_order_relaxed);
+
+            Clear(*container);
+
+            allocations += g_AllocationCount.load(std::memory_order_relaxed) - before;
+            operations  += size;
+
+            state.PauseTiming();
+            container.reset();
+            state.ResumeTiming();
+        }
+
+        Report(state, operations, allocations);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Registration
+    ///////////////////////////////////////////////////////////////////////////////
+    using Function = void (*)(benchmark::State&, Workload);
+
+    using Operation = std::tuple<const char*, Function, benchmark::TimeUnit>;
+
+    template <std::size_t Count>
+    void Register(const std::string& name, const Operation (&operations)[Count]) {
+        const Workload workloads[] = { Workload::Uniform, Workload::Sequential, Workload::Zipfian, Workload::Shifting };
+
+        for (const auto& [operation, function, unit] : operations) {
+            for (Workload workload : workloads) {
+                const std::string fullName = std::string(operation) + "/" + name + "/" + GetName(workload);
+
+                auto* benchmark = benchmark::RegisterBenchmark(fullName.c_str(), function, workload);
+
+                for (std::int64_t size = 1000; size <= BENCHMARK_MAX_SIZE; size *= 10)
+                    benchmark->Arg(size);
+
+                benchmark->Unit(unit);
+            }
+        }
+    }
+
+    template <typename Container>
+    void RegisterContainer(const std::string& name) {
+        // lookups time a single operation per iteration, the rest a pass over the whole tree
+        const Operation operations[] = {
+            { "Push",     &BM_Push<Container>,     benchmark::kMillisecond },
+            { "Pop",      &BM_Pop<Container>,      benchmark::kMillisecond },
+            { "Get",      &BM_Get<Container>,      benchmark::kNanosecond  },
+            { "IsExists", &BM_IsExists<Container>, benchmark::kNanosecond  },
+            { "Iterate",  &BM_Iterate<Container>,  benchmark::kMillisecond },
+            { "Teardown", &BM_Teardown<Container>, benchmark::kMillisecond }
+        };
+
+        Register(name, operations);
+    }
+
+    template <typename Container>
+    void RegisterBatched(const std::string& name) {
+        const Operation operations[] = {
+            { "PushBatch",     &BM_PushBatch<Container>,     benchmark::kMillisecond },
+            { "GetBatch",      &BM_GetBatch<Container>,      benchmark::kMicrosecond },
+            { "IsExistsBatch", &BM_IsExistsBatch<Container>, benchmark::kMicrosecond }
+        };
+
+        Register(name, operations);
+    }
+
+    // the parallel runs use a pool of one thread per core
+    inline void RegisterMerges(const std::string& name) {
+        const Operation operations[] = {
+            { "MergePushLoop",        &BM_Merge<MergeOperation::PushLoop, false>,     benchmark::kMillisecond },
+            { "Union",                &BM_Merge<MergeOperation::Union, false>,        benchmark::kMillisecond },
+            { "UnionParallel",        &BM_Merge<MergeOperation::Union, true>,         benchmark::kMillisecond },
+            { "Intersection",         &BM_Merge<MergeOperation::Intersection, false>, benchmark::kMillisecond },
+            { "IntersectionParallel", &BM_Merge<MergeOperation::Intersection, true>,  benchmark::kMillisecond },
+            { "Difference",           &BM_Merge<MergeOperation::Difference, false>,   benchmark::kMillisecond },
+            { "DifferenceParallel",   &BM_Merge<MergeOperation::Difference, true>,    benchmark::kMillisecond }
+        };
+
+        Register(name, operations);
+    }
+
+    // RedBlackTree takes a snapshot by copying itself
+    template <typename Container>
+    void RegisterTakeSnapshot(const std::string& name) {
+        const Operation operations[] = {
+            { "TakeSnapshot", &BM_TakeSnapshot<Container>, benchmark::kMicrosecond }
+        };
+
+        Register(name, operations);
+    }
+
+    template <typename Container>
+    void RegisterLoad(const std::string& name) {
+        const Operation operations[] = {
+            { "Load", &BM_Load<Container>, benchmark::kMillisecond }
+        };
+
+        Register(name, operations);
+    }
+
+    template <typename Container>
+    void RegisterStrings(const std::string& name) {
+        const Operation operations[] = {
+            { "GetByView", &BM_GetByView<Container>, benchmark::kNanosecond }
+        };
+
+        Register(name, operations);
+    }
+
+    template <typename Container>
+    void RegisterSnapshot(const std::string& name) {
+        const Operation operations[] = {
+            { "Get",      &BM_Get<Container>,      benchmark::kNanosecond  },
+            { "IsExists", &BM_IsExists<Container>, benchmark::kNanosecond  },
+            { "Iterate",  &BM_Iterate<Container>,  benchmark::kMillisecond }
+        };
+
+        Register(name, operations);
+    }
+
+} // namespace Benchmarks
+
+int main(int argc, char** argv) {
+    Benchmarks::RegisterContainer<Benchmarks::BTree>("BTree");
+    Benchmarks::RegisterContainer<Benchmarks::RedBlackTree>("RedBlackTree");
+    Benchmarks::RegisterContainer<Benchmarks::SplayTree>("SplayTree");
+    Benchmarks::RegisterContainer<Benchmarks::ConcurrentSkipList>("ConcurrentSkipList");
+    Benchmarks::RegisterContainer<Benchmarks::PersistentRedBlackTree>("PersistentRedBlackTree");
+    Benchmarks::RegisterContainer<Benchmarks::PagedTree>("PagedTree");
+    Benchmarks::RegisterContainer<Benchmarks::Map>("std::map");
+    Benchmarks::RegisterContainer<Benchmarks::Set>("std::set");
+    Benchmarks::RegisterSnapshot<Benchmarks::FrozenTree>("FrozenTree");
+    Benchmarks::RegisterSnapshot<Benchmarks::TreeImage>("TreeImage");
+    Benchmarks::RegisterBatched<Benchmarks::RedBlackTree>("RedBlackTree");
+    Benchmarks::RegisterBatched<Benchmarks::SplayTree>("SplayTree");
+    Benchmarks::RegisterMerges("RedBlackTree");
+    Benchmarks::RegisterTakeSnapshot<Benchmarks::RedBlackTree>("RedBlackTree");
+    Benchmarks::RegisterTakeSnapshot<Benchmarks::PersistentRedBlackTree>("PersistentRedBlackTree");
+    Benchmarks::RegisterLoad<Benchmarks::RedBlackTree>("RedBlackTree");
+    Benchmarks::RegisterLoad<Benchmarks::SplayTree>("SplayTree");
+    Benchmarks::RegisterStrings<Benchmarks::StringTree<DataStructures::RedBlackTree>>("RedBlackTree<string>");
+    Benchmarks::RegisterStrings<Benchmarks::TransparentStringTree<DataStructures::RedBlackTree>>("RedBlackTree<string,KeyLess<>>");
+    Benchmarks::RegisterStrings<Benchmarks::StringTree<DataStructures::SplayTree>>("SplayTree<string>");
+    Benchmarks::RegisterStrings<Benchmarks::TransparentStringTree<DataStructures::SplayTree>>("SplayTree<string,KeyLess<>>");
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::error_code error;
+    std::filesystem::remove(Benchmarks::GetImagePath(), error);
+    std::filesystem::remove(Benchmarks::GetPagedTreePath(), error);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+
+    enum class Workload : int {
+        Uniform = 0,
+        Sequential,
+        Zipfian,
+        Shifting
+    };
+
+    inline const char* GetName(Workload workload) {
+        switch (workload) {
+            case Workload::Uniform:    return "Uniform";
+            case Workload::Sequential: return "Sequential";
+            case Workload::Zipfian:    return "Zipfian";
+            case Workload::Shifting:   return "Shifting";
+        }
+
+        return "Unknown";
+    }
+
+    // Zipfian ranks in [0, count) after Gray et al., "Quickly Generating
+    // Billion-Record Synthetic Databases", as used by YCSB. Computing zeta is
+    // O(count), so a generator is meant to be built once per stream.
+    class ZipfianGenerator {
+    public:
+        explicit ZipfianGenerator(std::uint64_t count, double theta = 0.99)
+            : m_Count(count)
+            , m_Theta(theta)
+            , m_Alpha(1.0 / (1.0 - theta))
+            , m_Zeta(GetZeta(count, theta))
+            , m_Eta((1.0 - std::pow(2.0 / static_cast<double>(count), 1.0 - theta)) / (1.0 - GetZeta(2, theta) / m_Zeta)) {}
+
+        template <typename Random>
+        std::uint64_t operator ()(Random& random) {
+            const double u  = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+            const double uz = u * m_Zeta;
+
+            if (uz < 1.0)
+                return 0;
+
+            if (uz < 1.0 + std::pow(0.5, m_Theta))
+                return 1;
+
+            const auto rank = static_cast<std::uint64_t>(static_cast<double>(m_Count) * std::pow(m_Eta * u - m_Eta + 1.0, m_Alpha));
+
+            return std::min(rank, m_Count - 1);
+        }
+
+    private:
+        static double GetZeta(std::uint64_t count, double theta) {
+            double zeta = 0.0;
+
+            for (std::uint64_t i = 1; i <= count; ++i)
+                zeta += 1.0 / std::pow(static_cast<double>(i), theta);
+
+            return zeta;
+        }
+
+    private:
+        std::uint64_t m_Count;
+        double        m_Theta;
+        double        m_Alpha;
+        double        m_Zeta;
+        double        m_Eta;
+
+    }; // class ZipfianGenerator
+
+    // Indices in [0, universe) in the order a workload touches them:
+    //     Uniform    - a shuffled permutation, repeated, so every index shows up once per pass
+    //     Sequential - 0, 1, 2, ... wrapping around
+    //     Zipfian    - theta 0.99 ranks scattered over the universe, so hot keys are not neighbours
+    //     Shifting   - uniform draws from a window of universe / 16 that slides by a
+    //                  quarter window after every window-sized run of draws
+    inline std::vector<std::uint64_t> MakeStream(Workload workload, std::uint64_t universe, std::size_t length, std::uint64_t seed) {
+        std::mt19937_64            random(seed);
+        std::vector<std::uint64_t> stream(length);
+
+        switch (workload) {
+            case Workload::Uniform: {
+                std::vector<std::uint64_t> permutation(static_cast<std::size_t>(std::min<std::uint64_t>(universe, length)));
+
+                std::iota(permutation.begin(), permutation.end(), 0);
+
+                // a universe larger than the stream is sampled rather than permuted
+                if (permutation.size() < universe) {
+                    std::uniform_int_distribution<std::uint64_t> distribution(0, universe - 1);
+
+                    for (std::uint64_t& index : stream)
+                        index = distribution(random);
+
+                    return stream;
+                }
+
+                std::shuffle(permutation.begin(), permutation.end(), random);
+
+                for (std::size_t i = 0; i < length; ++i)
+                    stream[i] = permutation[i % permutation.size()];
+
+                return stream;
+            }
+
+            case Workload::Sequential: {
+                for (std::size_t i = 0; i < length; ++i)
+                    stream[i] = i % universe;
+
+                return stream;
+            }
+
+            case Workload::Zipfian: {
+                ZipfianGenerator generator(universe);
+
+                // 2654435761 is prime, so the scatter is a bijection unless it divides the universe
+                for (std::uint64_t& index : stream)
+                    index = generator(random) * 2654435761ull % universe;
+
+                return stream;
+            }
+
+            case Workload::Shifting: {
+                const std::uint64_t window = std::max<std::uint64_t>(universe / 16, 1);
+                const std::uint64_t step   = std::max<std::uint64_t>(window / 4, 1);
+
+                std::uniform_int_distribution<std::uint64_t> distribution(0, window - 1);
+
+                std::uint64_t offset = 0;
+
+                for (std::size_t i = 0; i < length; ++i) {
+                    if (i > 0 && i % window == 0)
+                        offset = (offset + step) % universe;
+
+                    stream[i] = (offset + distribution(random)) % universe;
+                }
+
+                return stream;
+            }
+        }
+
+        return stream;
+    }
+
+} // namespace Benchmarks
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../Common/ITree.hpp"
+#include "../Common/KeySearch.hpp"
+#include "../Common/NodePool.hpp"
+
+namespace DataStructures {
+
+    // B-tree of minimum degree Degree: every node but the root keeps between
+    // Degree - 1 and 2 * Degree - 1 keys. Keys, values and children live in
+    // separate arrays, so a lookup only reads the key block of every node on
+    // its path. The degree is picked so that the keys of a node fill
+    // KeyBlockSize bytes: 256 bytes are four cache lines, 4096 make page-sized
+    // nodes.
+    template <typename Key,
+              typename Value,
+              std::size_t KeyBlockSize = 256,
+              template <typename> typename Allocator = NodePool>
+    class BTree : public ITree<Key, Value> {
+    public:
+        static constexpr int Degree  = static_cast<int>(std::max<std::size_t>(2, KeyBlockSize / sizeof(Key) / 2));
+        static constexpr int MaxKeys = 2 * Degree - 1;
+        static constexpr int MinKeys = Degree - 1;
+
+        static constexpr std::size_t CacheLineSize = 64;
+
+        class Node {
+        public:
+            explicit Node(bool isLeaf);
+            Node(const Node& other) = delete;
+            ~Node();
+
+            Node& operator =(const Node& other) = delete;
+
+            [[nodiscard]] inline int GetCount() const { return m_Count; }
+            [[nodiscard]] inline bool IsLeaf() const { return m_IsLeaf; }
+            [[nodiscard]] inline const Node* GetParent() const { return m_Parent; }
+            [[nodiscard]] inline const Key& GetKey(int index) const { return GetKeys()[index]; }
+            [[nodiscard]] inline const Value& GetValue(int index) const { return GetValues()[index]; }
+            [[nodiscard]] const Node* GetChild(int index) const;
+
+            friend class BTree;
+
+        private:
+            [[nodiscard]] inline Key* GetKeys() { return std::launder(reinterpret_cast<Key*>(m_Keys)); }
+            [[nodiscard]] inline const Key* GetKeys() const { return std::launder(reinterpret_cast<const Key*>(m_Keys)); }
+            [[nodiscard]] inline Value* GetValues() { return std::launder(reinterpret_cast<Value*>(m_Values)); }
+            [[nodiscard]] inline const Value* GetValues() const { return std::launder(reinterpret_cast<const Value*>(m_Values)); }
+
+            void Print(std::ostream& ostream) const;
+
+        private:
+            // The key block comes first and starts a cache line, so a block of
+            // KeyBlockSize bytes spans no more lines than it fills.
+            alignas(std::max(alignof(Key), CacheLineSize)) unsigned char m_Keys[sizeof(Key) * MaxKeys];
+            alignas(Value) unsigned char                                 m_Values[sizeof(Value) * MaxKeys];
+
+            Node* m_Parent;
+            int   m_Count;
+            int   m_Index;
+            bool  m_IsLeaf;
+
+        }; // class Node
+
+        // Keys and values are stored apart, so iterators hand out pairs of
+        // references instead of references to pairs.
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const Key&, Value&>;
+
+            struct pointer {
+                reference Pair;
+
+                inline reference* operator ->() { return &Pair; }
+            };
+
+            explicit Iterator(Node* node = nullptr, int index = 0);
+
+            [[nodiscard]] inline reference operator *() const { return { m_Node->GetKeys()[m_Index], m_Node->GetValues()[m_Index] }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            Iterator& operator ++();
+            Iterator operator ++(int);
+
+            bool operator ==(const Iterator& other) const;
+            bool operator !=(const Iterator& other) const;
+
+        private:
+            Node* m_Node;
+            int   m_Index;
+
+        }; // class Iterator
+
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const Key&, const Value&>;
+
+            struct pointer {
+                reference Pair;
+
+                inline reference* operator ->() { return &Pair; }
+            };
+
+            explicit ConstIterator(const Node* node = nullptr, int index = 0);
+
+            [[nodiscard]] inline reference operator *() const { return { m_Node->GetKeys()[m_Index], m_Node->GetValues()[m_Index] }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+        private:
+            const Node* m_Node;
+            int         m_Index;
+
+        }; // class ConstIterator
+
+        BTree();
+        BTree(const BTree& other) = delete;
+        BTree(BTree&& other) noexcept;
+        ~BTree() override;
+
+        BTree& operator =(const BTree& other) = delete;
+        BTree& operator =(BTree&& other) noexcept;
+
+        [[nodiscard]] inline bool IsEmpty() const override { return m_Size == 0; }
+        [[nodiscard]] inline int GetSize() const override { return m_Size; }
+        [[nodiscard]] inline const Node* GetRoot() const { return m_Root; }
+
+        [[nodiscard]] int GetHeight() const override;
+        [[nodiscard]] bool IsExists(const Key& key) const override;
+
+        [[nodiscard]] const Value& GetMin() const;
+        [[nodiscard]] const Value& GetMax() const;
+
+        [[nodiscard]] Value& Get(const Key& key);
+        [[nodiscard]] const Value& Get(const Key& key) const;
+
+        void Clear();
+
+        Value& Push(const Key& key, Value value) override;
+        Value& Push(Key&& key, Value value) override;
+        void Pop(const Key& key) override;
+
+        [[nodiscard]] Iterator Find(const Key& key);
+        [[nodiscard]] ConstIterator Find(const Key& key) const;
+
+        [[nodiscard]] Iterator begin() { return Iterator(GetMinNode(), 0); }
+        [[nodiscard]] Iterator end() { return Iterator(); }
+
+        [[nodiscard]] ConstIterator begin() const { return ConstIterator(GetMinNode(), 0); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(); }
+
+        [[nodiscard]] ConstIterator cbegin() const { return ConstIterator(GetMinNode(), 0); }
+        [[nodiscard]] ConstIterator cend() const { return ConstIterator(); }
+
+        Value& operator [](const Key& key);
+        Value& operator [](Key&& key);
+
+        void Print() const;
+
+        template <typename Key_, typename Value_, std::size_t KeyBlockSize_, template <typename> typename Allocator_>
+        friend std::ostream& operator <<(std::ostream& ostream, const BTree<Key_, Value_, KeyBlockSize_, Allocator_>& tree);
+
+    private:
+        class InternalNode : public Node {
+        public:
+            InternalNode();
+
+            void SetChild(int index, Node* child);
+
+            Node* m_Children[MaxKeys + 1];
+
+        }; // class InternalNode
+
+        [[nodiscard]] static InternalNode* AsInternal(Node* node);
+        [[nodiscard]] static const InternalNode* AsInternal(const Node* node);
+
+        [[nodiscard]] static int LowerBound(const Node* node, const Key& key);
+        [[nodiscard]] static bool IsEqual(const Node* node, int index, const Key& key);
+
+        [[nodiscard]] Node* GetMinNode() const;
+        [[nodiscard]] Node* FindNode(const Key& key, int& index) const;
+
+        template <typename T>
+        static void Relocate(T* source, int count, T* destination);
+
+        template <typename KeyArg>
+        Value& Insert(KeyArg&& key, Value&& value);
+
+        void SplitChild(InternalNode* parent, int index);
+
+        [[nodiscard]] Node* Fill(InternalNode* parent, int index);
+        void BorrowFromLeft(InternalNode* parent, int index);
+        void BorrowFromRight(InternalNode* parent, int index);
+        void Merge(InternalNode* parent, int index);
+
+        void TakeMax(Node* node, Key& key, Value& value);
+        void TakeMin(Node* node, Key& key, Value& value);
+        void EraseAt(Node* node, int index);
+
+        [[nodiscard]] Node* AllocateLeaf();
+        [[nodiscard]] InternalNode* AllocateInternal();
+        void Deallocate(Node* node);
+
+        void Destroy(Node* node);
+
+        void Print(const Node* node, int level, const char* caption, std::ostream& ostream) const;
+
+    private:
+        Allocator<Node>         m_LeafAllocator;
+        Allocator<InternalNode> m_InternalAllocator;
+        Node*                   m_Root;
+        int                     m_Size;
+
+    }; // class BTree
+
+} // namespace DataStructures
+
+#include "BTree.inl"
@@ -0,0 +1,743 @@
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class BTree::Node
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::Node::Node(bool isLeaf)
+        : m_Parent(nullptr)
+        , m_Count(0)
+        , m_Index(0)
+        , m_IsLeaf(isLeaf) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::Node::~Node() {
+        for (int i = 0; i < m_Count; ++i) {
+            GetKeys()[i].~Key();
+            GetValues()[i].~Value();
+        }
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    const typename BTree<Key, Value, KeyBlockSize, Allocator>::Node* BTree<Key, Value, KeyBlockSize, Allocator>::Node::GetChild(int index) const {
+        return m_IsLeaf ? nullptr : AsInternal(this)->m_Children[index];
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Node::Print(std::ostream& ostream) const {
+        ostream << "[";
+
+        for (int i = 0; i < m_Count; ++i)
+            ostream << (i ? ", " : "") << GetKeys()[i] << ": " << GetValues()[i];
+
+        ostream << "]";
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class BTree::InternalNode
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::InternalNode::InternalNode()
+        : Node(false) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::InternalNode::SetChild(int index, Node* child) {
+        m_Children[index] = child;
+
+        child->m_Parent = this;
+        child->m_Index  = index;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class BTree::Iterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::Iterator::Iterator(Node* node, int index)
+        : m_Node(node)
+        , m_Index(index) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Iterator& BTree<Key, Value, KeyBlockSize, Allocator>::Iterator::operator ++() {
+        // the successor is the leftmost key right of the current one, or the
+        // separator above the last key of a leaf
+        if (!m_Node->m_IsLeaf) {
+            m_Node = AsInternal(m_Node)->m_Children[m_Index + 1];
+
+            while (!m_Node->m_IsLeaf)
+                m_Node = AsInternal(m_Node)->m_Children[0];
+
+            m_Index = 0;
+
+            return *this;
+        }
+
+        if (++m_Index < m_Node->m_Count)
+            return *this;
+
+        while (m_Node->m_Parent && m_Node->m_Index == m_Node->m_Parent->m_Count)
+            m_Node = m_Node->m_Parent;
+
+        m_Index = m_Node->m_Index;
+        m_Node  = m_Node->m_Parent;
+
+        if (!m_Node)
+            m_Index = 0;
+
+        return *this;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Iterator BTree<Key, Value, KeyBlockSize, Allocator>::Iterator::operator ++(int) {
+        Iterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::Iterator::operator ==(const Iterator& other) const {
+        return m_Node == other.m_Node && m_Index == other.m_Index;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::Iterator::operator !=(const Iterator& other) const {
+        return !(*this == other);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class BTree::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator::ConstIterator(const Node* node, int index)
+        : m_Node(node)
+        , m_Index(index) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator& BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator::operator ++() {
+        if (!m_Node->m_IsLeaf) {
+            m_Node = AsInternal(m_Node)->m_Children[m_Index + 1];
+
+            while (!m_Node->m_IsLeaf)
+                m_Node = AsInternal(m_Node)->m_Children[0];
+
+            m_Index = 0;
+
+            return *this;
+        }
+
+        if (++m_Index < m_Node->m_Count)
+            return *this;
+
+        while (m_Node->m_Parent && m_Node->m_Index == m_Node->m_Parent->m_Count)
+            m_Node = m_Node->m_Parent;
+
+        m_Index = m_Node->m_Index;
+        m_Node  = m_Node->m_Parent;
+
+        if (!m_Node)
+            m_Index = 0;
+
+        return *this;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Node == other.m_Node && m_Index == other.m_Index;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class BTree
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::BTree()
+        : m_Root(nullptr)
+        , m_Size(0) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::BTree(BTree&& other) noexcept
+        : m_LeafAllocator(std::move(other.m_LeafAllocator))
+        , m_InternalAllocator(std::move(other.m_InternalAllocator))
+        , m_Root(std::exchange(other.m_Root, nullptr))
+        , m_Size(std::exchange(other.m_Size, 0)) {}
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>::~BTree() {
+        Clear();
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    BTree<Key, Value, KeyBlockSize, Allocator>& BTree<Key, Value, KeyBlockSize, Allocator>::operator =(BTree&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Clear();
+
+        m_LeafAllocator     = std::move(other.m_LeafAllocator);
+        m_InternalAllocator = std::move(other.m_InternalAllocator);
+        m_Root              = std::exchange(other.m_Root, nullptr);
+        m_Size              = std::exchange(other.m_Size, 0);
+
+        return *this;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    int BTree<Key, Value, KeyBlockSize, Allocator>::GetHeight() const {
+        int height = 0;
+
+        for (const Node* node = m_Root; node; node = node->GetChild(0))
+            ++height;
+
+        return height;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::IsExists(const Key& key) const {
+        int index = 0;
+
+        return FindNode(key, index);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    const Value& BTree<Key, Value, KeyBlockSize, Allocator>::GetMin() const {
+        if (!m_Root)
+            throw std::out_of_range("Ng::BTree::GetMin: m_Root is nullptr!");
+
+        return GetMinNode()->GetValues()[0];
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    const Value& BTree<Key, Value, KeyBlockSize, Allocator>::GetMax() const {
+        if (!m_Root)
+            throw std::out_of_range("Ng::BTree::GetMax: m_Root is nullptr!");
+
+        const Node* node = m_Root;
+
+        while (!node->m_IsLeaf)
+            node = AsInternal(node)->m_Children[node->m_Count];
+
+        return node->GetValues()[node->m_Count - 1];
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::Get(const Key& key) {
+        int   index = 0;
+        Node* node  = FindNode(key, index);
+
+        if (!node)
+            throw std::out_of_range("Ng::BTree::Get: key is not exists!");
+
+        return node->GetValues()[index];
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    const Value& BTree<Key, Value, KeyBlockSize, Allocator>::Get(const Key& key) const {
+        int         index = 0;
+        const Node* node  = FindNode(key, index);
+
+        if (!node)
+            throw std::out_of_range("Ng::BTree::Get: key is not exists!");
+
+        return node->GetValues()[index];
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Clear() {
+        // Nodes without destructors to run are dropped together with the pool chunks.
+        constexpr bool IsTrivial = std::is_trivially_destructible_v<Key> && std::is_trivially_destructible_v<Value>;
+
+        if constexpr (!IsTrivial || !Allocator<Node>::IsBulkReleasable || !Allocator<InternalNode>::IsBulkReleasable)
+            Destroy(m_Root);
+
+        m_LeafAllocator.Release();
+        m_InternalAllocator.Release();
+
+        m_Root = nullptr;
+        m_Size = 0;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::Push(const Key& key, Value value) {
+        return Insert(key, std::move(value));
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::Push(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value));
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Pop(const Key& key) {
+        // Single pass from the root: every child is topped up to at least Degree
+        // keys before the descent enters it, so a key can always be taken out of
+        // it without walking back up. For a missing key the borrows and merges
+        // on the way are left in place, they keep the tree valid.
+        if (!m_Root)
+            return;
+
+        Node* node = m_Root;
+
+        while (true) {
+            const int  index   = LowerBound(node, key);
+            const bool isFound = IsEqual(node, index, key);
+
+            if (node->m_IsLeaf) {
+                if (!isFound)
+                    break;
+
+                EraseAt(node, index);
+                --m_Size;
+                break;
+            }
+
+            InternalNode* internal = AsInternal(node);
+
+            if (!isFound) {
+                node = Fill(internal, index);
+                continue;
+            }
+
+            Node* left  = internal->m_Children[index];
+            Node* right = internal->m_Children[index + 1];
+
+            // the key is replaced by its predecessor or successor when a side can
+            // spare one, otherwise both sides merge around it and the descent goes on
+            if (left->m_Count > MinKeys) {
+                TakeMax(left, node->GetKeys()[index], node->GetValues()[index]);
+                --m_Size;
+                break;
+            }
+
+            if (right->m_Count > MinKeys) {
+                TakeMin(right, node->GetKeys()[index], node->GetValues()[index]);
+                --m_Size;
+                break;
+            }
+
+            Merge(internal, index);
+
+            node = left;
+        }
+
+        if (m_Root->m_Count > 0)
+            return;
+
+        Node* root = m_Root;
+
+        m_Root = root->m_IsLeaf ? nullptr : AsInternal(root)->m_Children[0];
+
+        if (m_Root)
+            m_Root->m_Parent = nullptr;
+
+        Deallocate(root);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Iterator BTree<Key, Value, KeyBlockSize, Allocator>::Find(const Key& key) {
+        int   index = 0;
+        Node* node  = FindNode(key, index);
+
+        return node ? Iterator(node, index) : end();
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::ConstIterator BTree<Key, Value, KeyBlockSize, Allocator>::Find(const Key& key) const {
+        int         index = 0;
+        const Node* node  = FindNode(key, index);
+
+        return node ? ConstIterator(node, index) : end();
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::operator [](const Key& key) {
+        return Insert(key, Value());
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::operator [](Key&& key) {
+        return Insert(std::move(key), Value());
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Print() const {
+        std::cout << *this;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::InternalNode* BTree<Key, Value, KeyBlockSize, Allocator>::AsInternal(Node* node) {
+        return static_cast<InternalNode*>(node);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    const typename BTree<Key, Value, KeyBlockSize, Allocator>::InternalNode* BTree<Key, Value, KeyBlockSize, Allocator>::AsInternal(const Node* node) {
+        return static_cast<const InternalNode*>(node);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    int BTree<Key, Value, KeyBlockSize, Allocator>::LowerBound(const Node* node, const Key& key) {
+        return KeySearch<Key>::LowerBound(node->GetKeys(), node->m_Count, key);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    bool BTree<Key, Value, KeyBlockSize, Allocator>::IsEqual(const Node* node, int index, const Key& key) {
+        // LowerBound already rules out a smaller key at index
+        return index < node->m_Count && !(node->GetKeys()[index] > key);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Node* BTree<Key, Value, KeyBlockSize, Allocator>::GetMinNode() const {
+        Node* node = m_Root;
+
+        while (node && !node->m_IsLeaf)
+            node = AsInternal(node)->m_Children[0];
+
+        return node;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Node* BTree<Key, Value, KeyBlockSize, Allocator>::FindNode(const Key& key, int& index) const {
+        for (Node* node = m_Root; node; node = AsInternal(node)->m_Children[index]) {
+            index = LowerBound(node, key);
+
+            if (IsEqual(node, index, key))
+                return node;
+
+            if (node->m_IsLeaf)
+                return nullptr;
+        }
+
+        return nullptr;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    template <typename T>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Relocate(T* source, int count, T* destination) {
+        // Moves count live objects into raw storage, which may overlap the source.
+        if (destination < source) {
+            for (int i = 0; i < count; ++i) {
+                new (destination + i) T(std::move(source[i]));
+                source[i].~T();
+            }
+        } else {
+            for (int i = count - 1; i >= 0; --i) {
+                new (destination + i) T(std::move(source[i]));
+                source[i].~T();
+            }
+        }
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    template <typename KeyArg>
+    Value& BTree<Key, Value, KeyBlockSize, Allocator>::Insert(KeyArg&& key, Value&& value) {
+        // Single pass from the root: full nodes are split before the descent
+        // enters them, so there is always room for a key pushed up from below.
+        if (!m_Root)
+            m_Root = AllocateLeaf();
+
+        if (m_Root->m_Count == MaxKeys) {
+            InternalNode* root = AllocateInternal();
+
+            root->SetChild(0, m_Root);
+            m_Root = root;
+
+            SplitChild(root, 0);
+        }
+
+        Node* node = m_Root;
+
+        while (true) {
+            int index = LowerBound(node, key);
+
+            if (IsEqual(node, index, key))
+                return node->GetValues()[index];
+
+            if (node->m_IsLeaf) {
+                Relocate(node->GetKeys() + index, node->m_Count - index, node->GetKeys() + index + 1);
+                Relocate(node->GetValues() + index, node->m_Count - index, node->GetValues() + index + 1);
+
+                new (node->GetKeys() + index) Key(std::forward<KeyArg>(key));
+                new (node->GetValues() + index) Value(std::move(value));
+
+                ++node->m_Count;
+                ++m_Size;
+
+                return node->GetValues()[index];
+            }
+
+            InternalNode* internal = AsInternal(node);
+
+            if (internal->m_Children[index]->m_Count == MaxKeys) {
+                SplitChild(internal, index);
+
+                // the median of the child moved up to index
+                if (key > node->GetKeys()[index])
+                    ++index;
+                else if (!(node->GetKeys()[index] > key))
+                    return node->GetValues()[index];
+            }
+
+            node = internal->m_Children[index];
+        }
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::SplitChild(InternalNode* parent, int index) {
+        //     [ ... p ... ]              [ ... p m ... ]
+        //          |            =>            |   |
+        // [ l ... m ... r ]           [ l ... ]   [ ... r ]
+
+        Node* child   = parent->m_Children[index];
+        Node* sibling = child->m_IsLeaf ? AllocateLeaf() : AllocateInternal();
+
+        Relocate(child->GetKeys() + Degree, Degree - 1, sibling->GetKeys());
+        Relocate(child->GetValues() + Degree, Degree - 1, sibling->GetValues());
+
+        if (!child->m_IsLeaf) {
+            for (int i = 0; i < Degree; ++i)
+                AsInternal(sibling)->SetChild(i, AsInternal(child)->m_Children[Degree + i]);
+        }
+
+        sibling->m_Count = Degree - 1;
+
+        for (int i = parent->m_Count; i > index; --i)
+            parent->SetChild(i + 1, parent->m_Children[i]);
+
+        parent->SetChild(index + 1, sibling);
+
+        Relocate(parent->GetKeys() + index, parent->m_Count - index, parent->GetKeys() + index + 1);
+        Relocate(parent->GetValues() + index, parent->m_Count - index, parent->GetValues() + index + 1);
+        Relocate(child->GetKeys() + Degree - 1, 1, parent->GetKeys() + index);
+        Relocate(child->GetValues() + Degree - 1, 1, parent->GetValues() + index);
+
+        child->m_Count = Degree - 1;
+
+        ++parent->m_Count;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Node* BTree<Key, Value, KeyBlockSize, Allocator>::Fill(InternalNode* parent, int index) {
+        // Tops the child at index up to at least Degree keys and returns the node
+        // the descent continues in, which is the left sibling after merging into it.
+        Node* child = parent->m_Children[index];
+
+        if (child->m_Count > MinKeys)
+            return child;
+
+        // a parent holds at least one key, so the last child has a left sibling
+        // and every other child a right one
+        if (index > 0) {
+            Node* left = parent->m_Children[index - 1];
+
+            if (left->m_Count > MinKeys) {
+                BorrowFromLeft(parent, index);
+                return child;
+            }
+
+            if (index == parent->m_Count) {
+                Merge(parent, index - 1);
+                return left;
+            }
+        }
+
+        if (parent->m_Children[index + 1]->m_Count > MinKeys) {
+            BorrowFromRight(parent, index);
+            return child;
+        }
+
+        Merge(parent, index);
+
+        return child;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::BorrowFromLeft(InternalNode* parent, int index) {
+        // the separator moves down to the front of the child and the last key
+        // of the left sibling takes its place
+        Node* child = parent->m_Children[index];
+        Node* left  = parent->m_Children[index - 1];
+
+        Relocate(child->GetKeys(), child->m_Count, child->GetKeys() + 1);
+        Relocate(child->GetValues(), child->m_Count, child->GetValues() + 1);
+        Relocate(parent->GetKeys() + index - 1, 1, child->GetKeys());
+        Relocate(parent->GetValues() + index - 1, 1, child->GetValues());
+        Relocate(left->GetKeys() + left->m_Count - 1, 1, parent->GetKeys() + index - 1);
+        Relocate(left->GetValues() + left->m_Count - 1, 1, parent->GetValues() + index - 1);
+
+        if (!child->m_IsLeaf) {
+            for (int i = child->m_Count; i >= 0; --i)
+                AsInternal(child)->SetChild(i + 1, AsInternal(child)->m_Children[i]);
+
+            AsInternal(child)->SetChild(0, AsInternal(left)->m_Children[left->m_Count]);
+        }
+
+        ++child->m_Count;
+        --left->m_Count;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::BorrowFromRight(InternalNode* parent, int index) {
+        // the separator moves down to the back of the child and the first key
+        // of the right sibling takes its place
+        Node* child = parent->m_Children[index];
+        Node* right = parent->m_Children[index + 1];
+
+        Relocate(parent->GetKeys() + index, 1, child->GetKeys() + child->m_Count);
+        Relocate(parent->GetValues() + index, 1, child->GetValues() + child->m_Count);
+        Relocate(right->GetKeys(), 1, parent->GetKeys() + index);
+        Relocate(right->GetValues(), 1, parent->GetValues() + index);
+        Relocate(right->GetKeys() + 1, right->m_Count - 1, right->GetKeys());
+        Relocate(right->GetValues() + 1, right->m_Count - 1, right->GetValues());
+
+        if (!child->m_IsLeaf) {
+            AsInternal(child)->SetChild(child->m_Count + 1, AsInternal(right)->m_Children[0]);
+
+            for (int i = 0; i < right->m_Count; ++i)
+                AsInternal(right)->SetChild(i, AsInternal(right)->m_Children[i + 1]);
+        }
+
+        ++child->m_Count;
+        --right->m_Count;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Merge(InternalNode* parent, int index) {
+        // the separator at index and the right child are folded into the left child
+        Node* left  = parent->m_Children[index];
+        Node* right = parent->m_Children[index + 1];
+
+        Relocate(parent->GetKeys() + index, 1, left->GetKeys() + left->m_Count);
+        Relocate(parent->GetValues() + index, 1, left->GetValues() + left->m_Count);
+        Relocate(right->GetKeys(), right->m_Count, left->GetKeys() + left->m_Count + 1);
+        Relocate(right->GetValues(), right->m_Count, left->GetValues() + left->m_Count + 1);
+
+        if (!left->m_IsLeaf) {
+            for (int i = 0; i <= right->m_Count; ++i)
+                AsInternal(left)->SetChild(left->m_Count + 1 + i, AsInternal(right)->m_Children[i]);
+        }
+
+        left->m_Count += right->m_Count + 1;
+        right->m_Count = 0;
+
+        Relocate(parent->GetKeys() + index + 1, parent->m_Count - index - 1, parent->GetKeys() + index);
+        Relocate(parent->GetValues() + index + 1, parent->m_Count - index - 1, parent->GetValues() + index);
+
+        for (int i = index + 1; i < parent->m_Count; ++i)
+            parent->SetChild(i, parent->m_Children[i + 1]);
+
+        --parent->m_Count;
+
+        Deallocate(right);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::TakeMax(Node* node, Key& key, Value& value) {
+        while (!node->m_IsLeaf)
+            node = Fill(AsInternal(node), node->m_Count);
+
+        key   = std::move(node->GetKeys()[node->m_Count - 1]);
+        value = std::move(node->GetValues()[node->m_Count - 1]);
+
+        EraseAt(node, node->m_Count - 1);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::TakeMin(Node* node, Key& key, Value& value) {
+        while (!node->m_IsLeaf)
+            node = Fill(AsInternal(node), 0);
+
+        key   = std::move(node->GetKeys()[0]);
+        value = std::move(node->GetValues()[0]);
+
+        EraseAt(node, 0);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::EraseAt(Node* node, int index) {
+        node->GetKeys()[index].~Key();
+        node->GetValues()[index].~Value();
+
+        Relocate(node->GetKeys() + index + 1, node->m_Count - index - 1, node->GetKeys() + index);
+        Relocate(node->GetValues() + index + 1, node->m_Count - index - 1, node->GetValues() + index);
+
+        --node->m_Count;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::Node* BTree<Key, Value, KeyBlockSize, Allocator>::AllocateLeaf() {
+        return m_LeafAllocator.Allocate(true);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    typename BTree<Key, Value, KeyBlockSize, Allocator>::InternalNode* BTree<Key, Value, KeyBlockSize, Allocator>::AllocateInternal() {
+        return m_InternalAllocator.Allocate();
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Deallocate(Node* node) {
+        if (node->m_IsLeaf)
+            m_LeafAllocator.Deallocate(node);
+        else
+            m_InternalAllocator.Deallocate(AsInternal(node));
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Destroy(Node* node) {
+        // The height is logarithmic in the fan-out, so plain recursion is shallow.
+        if (!node)
+            return;
+
+        if (!node->m_IsLeaf) {
+            for (int i = 0; i <= node->m_Count; ++i)
+                Destroy(AsInternal(node)->m_Children[i]);
+        }
+
+        Deallocate(node);
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    void BTree<Key, Value, KeyBlockSize, Allocator>::Print(const Node* node, int level, const char* caption, std::ostream& ostream) const {
+        if (!node) {
+            ostream << caption << ": Null" << std::endl;
+            return;
+        }
+
+        ostream << caption << ": ";
+        node->Print(ostream);
+
+        if (!node->m_IsLeaf) {
+            ostream << " (" << std::endl;
+
+            for (int i = 0; i <= node->m_Count; ++i) {
+                for (int j = 0; j < level; j++)
+                    ostream << "| ";
+                Print(AsInternal(node)->m_Children[i], level + 1, "Child", ostream);
+            }
+
+            for (int i = 0; i < level - 1; i++)
+                ostream << "| ";
+            ostream << ")";
+        }
+
+        ostream << std::endl;
+    }
+
+    template <typename Key, typename Value, std::size_t KeyBlockSize, template <typename> typename Allocator>
+    std::ostream& operator <<(std::ostream& ostream, const BTree<Key, Value, KeyBlockSize, Allocator>& tree) {
+        tree.Print(tree.m_Root, 1, "Root", ostream);
+
+        return ostream;
+    }
+
+} // namespace DataStructures
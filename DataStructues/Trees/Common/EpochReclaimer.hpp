@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace DataStructures {
+
+    // Epoch-based reclamation for the concurrent containers. Readers pin the
+    // current epoch with a Guard for the duration of an operation. Unlinked
+    // nodes are retired and freed once the global epoch has advanced twice past
+    // their retirement: every thread that could still hold a pointer to them
+    // has left its guard by then. The epoch only advances when every pinned
+    // thread has caught up with it, so a stalled reader delays reclamation but
+    // never blocks other threads.
+    //
+    // The domain is process-wide. A thread claims one of MaxThreads slots on
+    // first use and hands its pending nodes over when it exits.
+    class EpochReclaimer {
+    private:
+        struct Participant;
+
+    public:
+        static constexpr std::size_t MaxThreads = 512;
+
+        // Guards nest, only the outermost one pins and unpins.
+        class Guard {
+        public:
+            Guard() : m_Participant(EpochReclaimer::GetParticipant()) { EpochReclaimer::Enter(m_Participant); }
+            Guard(const Guard& other) = delete;
+            ~Guard() { EpochReclaimer::Exit(m_Participant); }
+
+            Guard& operator =(const Guard& other) = delete;
+
+        private:
+            Participant& m_Participant;
+
+        }; // class Guard
+
+        using Deleter = void (*)(void*);
+
+        // Frees pointer with deleter once no guard can observe it. Must be called
+        // after the pointer is unreachable for threads that pin from now on.
+        static void Retire(void* pointer, Deleter deleter) {
+            Participant& participant = GetParticipant();
+
+            participant.Retired.push_back({ pointer, deleter, s_Epoch.load(std::memory_order_seq_cst) });
+
+            // A long guard on some thread keeps nodes pending, the bound doubles so
+            // that they are not rescanned on every retirement meanwhile.
+            if (participant.Retired.size() >= participant.CollectBound) {
+                Collect(participant);
+
+                participant.CollectBound = std::max(CollectThreshold, 2 * participant.Retired.size());
+            }
+        }
+
+        template <typename T>
+        static void Retire(T* pointer) {
+            Retire(pointer, [](void* object) { delete static_cast<T*>(object); });
+        }
+
+        // Advances the epoch as far as pinned threads allow and frees what became
+        // safe, for callers that want memory back without retiring more.
+        static void Collect() {
+            Collect(GetParticipant());
+        }
+
+    private:
+        static constexpr std::uint64_t Inactive         = 0;
+        static constexpr std::size_t   CollectThreshold = 64;
+
+        struct alignas(64) Slot {
+            std::atomic<std::uint64_t> Epoch { Inactive };
+            std::atomic<bool>          IsOwned { false };
+        };
+
+        struct Retiree {
+            void*         Pointer;
+            Deleter       Delete;
+            std::uint64_t Epoch;
+        };
+
+        struct Participant {
+            Participant() {
+                for (Slot& slot : s_Slots) {
+                    bool isOwned = false;
+
+                    if (slot.IsOwned.compare_exchange_strong(isOwned, true, std::memory_order_acq_rel)) {
+                        Owned = &slot;
+                        return;
+                    }
+                }
+
+                throw std::runtime_error("Ng::EpochReclaimer::Participant: too many threads!");
+            }
+
+            ~Participant() {
+                {
+                    std::lock_guard<std::mutex> lock(s_Orphans.Mutex);
+                    s_Orphans.Retired.insert(s_Orphans.Retired.end(), Retired.begin(), Retired.end());
+                }
+
+                Owned->Epoch.store(Inactive, std::memory_order_release);
+                Owned->IsOwned.store(false, std::memory_order_release);
+            }
+
+            Slot*                Owned        = nullptr;
+            int                  Depth        = 0;
+            std::size_t          CollectBound = CollectThreshold;
+            std::vector<Retiree> Retired;
+        };
+
+        // Nodes of exited threads, freed by whoever collects next or at exit.
+        struct Orphans {
+            ~Orphans() {
+                for (const Retiree& retiree : Retired)
+                    retiree.Delete(retiree.Pointer);
+            }
+
+            std::mutex           Mutex;
+            std::vector<Retiree> Retired;
+        };
+
+        static Participant& GetParticipant() {
+            thread_local Participant participant;
+
+            return participant;
+        }
+
+        static void Enter(Participant& participant) {
+            if (participant.Depth++ > 0)
+                return;
+
+            // the exchange orders the announcement before every load of the
+            // operation, it is cheaper than a store and a full fence
+            participant.Owned->Epoch.exchange(s_Epoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        }
+
+        static void Exit(Participant& participant) {
+            if (--participant.Depth > 0)
+                return;
+
+            participant.Owned->Epoch.store(Inactive, std::memory_order_release);
+        }
+
+        static bool TryAdvance() {
+            std::uint64_t epoch = s_Epoch.load(std::memory_order_seq_cst);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            for (const Slot& slot : s_Slots) {
+                const std::uint64_t pinned = slot.Epoch.load(std::memory_order_acquire);
+
+                if (pinned != Inactive && pinned != epoch)
+                    return false;
+            }
+
+            return s_Epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+        }
+
+        static void Collect(Participant& participant) {
+            TryAdvance();
+
+            const std::uint64_t epoch = s_Epoch.load(std::memory_order_seq_cst);
+
+            Free(participant.Retired, epoch);
+
+            std::unique_lock<std::mutex> lock(s_Orphans.Mutex, std::try_to_lock);
+
+            if (lock.owns_lock())
+                Free(s_Orphans.Retired, epoch);
+        }
+
+        static void Free(std::vector<Retiree>& retired, std::uint64_t epoch) {
+            std::size_t kept = 0;
+
+            for (const Retiree& retiree : retired) {
+                if (retiree.Epoch + 2 <= epoch)
+                    retiree.Delete(retiree.Pointer);
+                else
+                    retired[kept++] = retiree;
+            }
+
+            retired.resize(kept);
+        }
+
+    private:
+        static std::atomic<std::uint64_t> s_Epoch;
+        static Slot                       s_Slots[MaxThreads];
+        static Orphans                    s_Orphans;
+
+    }; // class EpochReclaimer
+
+    // epoch 0 marks an unpinned slot, so counting starts at 1
+    inline std::atomic<std::uint64_t> EpochReclaimer::s_Epoch { 1 };
+    inline EpochReclaimer::Slot       EpochReclaimer::s_Slots[EpochReclaimer::MaxThreads];
+    inline EpochReclaimer::Orphans    EpochReclaimer::s_Orphans;
+
+} // namespace DataStructures
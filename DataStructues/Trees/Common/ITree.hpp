@@ -14,7 +14,9 @@ namespace DataStructures {
         [[nodiscard]] virtual bool IsExists(const Key& key) const = 0;
         [[nodiscard]] virtual int GetHeight() const = 0;
 
-        virtual Value& Push(const Key& key, const Value& value) = 0;
+        // The value is taken by value so that move-only values can be pushed too.
+        virtual Value& Push(const Key& key, Value value) = 0;
+        virtual Value& Push(Key&& key, Value value) = 0;
         virtual void Pop(const Key& key) = 0;
 
     }; // class ITree
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+
+namespace DataStructures {
+
+    // Runs the descents for count keys of a binary search tree side by side, so
+    // the cache misses of one descent overlap with the work of the others.
+    //
+    // Every lane takes one step per round and prefetches the child it moves to,
+    // the child is read a round later, after the other lanes have stepped. A
+    // lane that reaches its node or a leaf reports visit(index, node, depth) with
+    // node nullptr for a missing key and takes the next key right away, so the
+    // lanes stay busy until the keys run out. Results come in completion order.
+    // depth counts the steps taken from the root.
+    //
+    // descend(node, key) returns node itself when it holds key and otherwise
+    // its child towards key, so the tree's order decides both.
+    template <std::size_t LaneCount = 16, typename Node, typename Key, typename Descend, typename Visit>
+    void InterleavedSearch(Node* root, const Key* keys, std::size_t count, Descend&& descend, Visit&& visit) {
+        struct Lane {
+            Node*       Current;
+            std::size_t Index;
+            int         Depth;
+        };
+
+        Lane        lanes[LaneCount];
+        std::size_t laneCount = 0;
+        std::size_t next      = 0;
+
+        for (; laneCount < LaneCount && next < count; ++laneCount, ++next)
+            lanes[laneCount] = { root, next, 0 };
+
+        while (laneCount > 0) {
+            for (std::size_t i = 0; i < laneCount;) {
+                Lane&      lane = lanes[i];
+                Node*      node = lane.Current;
+                const Key& key  = keys[lane.Index];
+
+                Node* child = node ? descend(node, key) : nullptr;
+
+                if (child != node) {
+                    lane.Current = child;
+                    ++lane.Depth;
+
+#if defined(__GNUC__) || defined(__clang__)
+                    __builtin_prefetch(lane.Current);
+#endif
+                    ++i;
+                    continue;
+                }
+
+                visit(lane.Index, node, lane.Depth);
+
+                // a finished lane restarts from the root or makes room for the rest
+                if (next < count)
+                    lane = { root, next++, 0 };
+                else
+                    lane = lanes[--laneCount];
+            }
+        }
+    }
+
+} // namespace DataStructures
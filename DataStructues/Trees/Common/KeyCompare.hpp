@@ -0,0 +1,144 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+#include <compare>
+
+#define DATA_STRUCTURES_HAS_THREE_WAY
+#endif
+
+namespace DataStructures {
+
+    // The default order of the trees: lhs is less than rhs when rhs > lhs, so
+    // keys keep needing nothing but operator >. Like std::less<> the void
+    // specialization is transparent and compares a key with anything it has an
+    // operator > for.
+    template <typename Key = void>
+    struct KeyLess {
+        [[nodiscard]] inline bool operator ()(const Key& lhs, const Key& rhs) const { return rhs > lhs; }
+
+    }; // struct KeyLess
+
+    template <>
+    struct KeyLess<void> {
+        using is_transparent = void;
+
+        template <typename Lhs, typename Rhs>
+        [[nodiscard]] inline bool operator ()(const Lhs& lhs, const Rhs& rhs) const { return rhs > lhs; }
+
+    }; // struct KeyLess<void>
+
+    // A transparent Compare lets lookups take any KeyLike it can compare with
+    // the keys, like a std::string_view for std::string keys, instead of first
+    // building a Key from it. KeyLike only makes the test depend on the lookup,
+    // so overloads using it drop out instead of failing.
+    template <typename Compare, typename KeyLike, typename = void>
+    struct IsTransparent : std::false_type {};
+
+    template <typename Compare, typename KeyLike>
+    struct IsTransparent<Compare, KeyLike, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+    template <typename Compare, typename KeyLike>
+    using EnableIfTransparent = std::enable_if_t<IsTransparent<Compare, KeyLike>::value>;
+
+    // A Compare whose call returns an int, negative, zero or positive, or a
+    // C++20 ordering instead of a bool compares three ways by itself.
+    template <typename Compare, typename Lhs, typename Rhs>
+    inline constexpr bool IsThreeWayCompare = !std::is_same_v<std::invoke_result_t<const Compare&, const Lhs&, const Rhs&>, bool>;
+
+    // A Compare can keep its bool call for the standard algorithms and add a
+    // member compare(lhs, rhs) returning an int or a C++20 ordering, like
+    // basic_string::compare, which then orders three ways:
+    //     struct CaseInsensitiveLess {
+    //         bool operator ()(const std::string& lhs, const std::string& rhs) const;
+    //         int  compare(const std::string& lhs, const std::string& rhs) const;
+    //     };
+    template <typename Compare, typename Lhs, typename Rhs, typename = void>
+    struct HasThreeWayMember : std::false_type {};
+
+    template <typename Compare, typename Lhs, typename Rhs>
+    struct HasThreeWayMember<Compare, Lhs, Rhs, std::void_t<decltype(std::declval<const Compare&>().compare(std::declval<const Lhs&>(), std::declval<const Rhs&>()))>>
+        : std::true_type {};
+
+    template <typename Compare>
+    struct IsKeyOrder : std::false_type {};
+
+    template <typename Key>
+    struct IsKeyOrder<KeyLess<Key>> : std::true_type {};
+
+    template <typename Key>
+    struct IsKeyOrder<std::less<Key>> : std::true_type {};
+
+    // A string and whatever views as the same kind of string, which compare()
+    // orders in one pass.
+    template <typename Lhs, typename Rhs>
+    struct IsStringComparable : std::false_type {};
+
+    template <typename Char, typename Traits, typename Allocator, typename Rhs>
+    struct IsStringComparable<std::basic_string<Char, Traits, Allocator>, Rhs>
+        : std::is_convertible<const Rhs&, std::basic_string_view<Char, Traits>> {};
+
+    template <typename Char, typename Traits, typename Rhs>
+    struct IsStringComparable<std::basic_string_view<Char, Traits>, Rhs>
+        : std::is_convertible<const Rhs&, std::basic_string_view<Char, Traits>> {};
+
+#ifdef DATA_STRUCTURES_HAS_THREE_WAY
+    template <typename Lhs, typename Rhs, typename = void>
+    struct IsThreeWayComparable : std::false_type {};
+
+    template <typename Lhs, typename Rhs>
+    struct IsThreeWayComparable<Lhs, Rhs, std::void_t<decltype(std::declval<const Lhs&>() <=> std::declval<const Rhs&>())>> : std::true_type {};
+#endif
+
+    // Orders lhs and rhs under compare with a single comparison where it can:
+    // through a three-way Compare or its compare member, through <=> where
+    // C++20 has it or through compare() of strings, the last two only under the
+    // natural order of KeyLess and std::less. Anything else takes two calls of
+    // compare. The result is negative, zero or positive like strcmp.
+    template <typename Compare, typename Lhs, typename Rhs>
+    [[nodiscard]] inline int CompareKeys(const Compare& compare, const Lhs& lhs, const Rhs& rhs) {
+        if constexpr (IsThreeWayCompare<Compare, Lhs, Rhs>) {
+            const auto order = compare(lhs, rhs);
+
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        } else if constexpr (HasThreeWayMember<Compare, Lhs, Rhs>::value) {
+            const auto order = compare.compare(lhs, rhs);
+
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+#ifdef DATA_STRUCTURES_HAS_THREE_WAY
+        } else if constexpr (IsKeyOrder<Compare>::value && IsThreeWayComparable<Lhs, Rhs>::value) {
+            const auto order = lhs <=> rhs;
+
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+#endif
+        } else if constexpr (IsKeyOrder<Compare>::value && IsStringComparable<Lhs, Rhs>::value) {
+            const int order = lhs.compare(rhs);
+
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        } else {
+            return compare(lhs, rhs) ? -1 : (compare(rhs, lhs) ? 1 : 0);
+        }
+    }
+
+    template <typename Compare, typename Lhs, typename Rhs>
+    [[nodiscard]] inline bool IsLess(const Compare& compare, const Lhs& lhs, const Rhs& rhs) {
+        if constexpr (IsThreeWayCompare<Compare, Lhs, Rhs>)
+            return compare(lhs, rhs) < 0;
+        else
+            return compare(lhs, rhs);
+    }
+
+    // FrozenTree and TreeImage search with operator >, trees handed over to
+    // them have to be in that order.
+    template <typename Compare, typename Key>
+    inline constexpr bool IsNaturalOrder = std::is_same_v<Compare, KeyLess<Key>> ||
+                                           std::is_same_v<Compare, KeyLess<>> ||
+                                           std::is_same_v<Compare, std::less<Key>> ||
+                                           std::is_same_v<Compare, std::less<>>;
+
+} // namespace DataStructures
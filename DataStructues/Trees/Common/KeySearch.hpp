@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(DATA_STRUCTURES_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DATA_STRUCTURES_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace DataStructures {
+
+    // KeySearch<Key>::LowerBound(keys, count, key) is the index of the first of
+    // count sorted keys that is not less than key, using only operator >.
+    //
+    // Halving without a data-dependent branch lets the compiler emit conditional
+    // moves, a node's worth of mispredictions costs more than the comparisons
+    // saved by stopping early.
+    template <typename Key, typename = void>
+    struct KeySearch {
+        [[nodiscard]] static int LowerBound(const Key* keys, int count, const Key& key) {
+            const Key* base = keys;
+
+            if (count == 0)
+                return 0;
+
+            while (count > 1) {
+                const int half = count / 2;
+
+                base  += key > base[half - 1] ? half : 0;
+                count -= half;
+            }
+
+            return static_cast<int>(base - keys) + (key > *base ? 1 : 0);
+        }
+
+    }; // struct KeySearch
+
+#ifdef DATA_STRUCTURES_X86_SIMD
+
+    // Integral keys narrow the range by halving until it fits a few vectors and
+    // then count the keys below the searched one with packed compares: a sorted
+    // block holds exactly as many smaller keys as the lower bound skips. The
+    // instruction set is picked once at runtime, so a single binary runs on any
+    // x86 and the scalar search stays as the fallback.
+    template <typename Key>
+    struct KeySearch<Key, std::enable_if_t<std::is_integral_v<Key> && !std::is_same_v<Key, bool> && sizeof(Key) <= 8>> {
+        enum class InstructionSet : int {
+            Scalar = 0,
+            Sse42,
+            Avx2
+        };
+
+        [[nodiscard]] static int LowerBound(const Key* keys, int count, const Key& key) {
+            return LowerBound(keys, count, key, s_InstructionSet);
+        }
+
+        // Searches with the given instruction set, which the CPU has to support,
+        // so that every path can be checked against the others on one machine.
+        [[nodiscard]] static int LowerBound(const Key* keys, int count, const Key& key, InstructionSet instructionSet) {
+            // halving stops once the rest spans this many bytes
+            constexpr int ScanSize = 128;
+            constexpr int ScanKeys = ScanSize / static_cast<int>(sizeof(Key));
+
+            const Key* base = keys;
+
+            while (count > ScanKeys) {
+                const int half = count / 2;
+
+                base  += key > base[half - 1] ? half : 0;
+                count -= half;
+            }
+
+            const int offset = static_cast<int>(base - keys);
+
+            switch (instructionSet) {
+                case InstructionSet::Avx2:  return offset + CountLessAvx2(base, count, key);
+                case InstructionSet::Sse42: return offset + CountLessSse42(base, count, key);
+                default:                    return offset + CountLess(base, count, key);
+            }
+        }
+
+        // the widest instruction set the CPU supports
+        [[nodiscard]] static InstructionSet GetInstructionSet() {
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+                return InstructionSet::Avx2;
+
+            if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+                return InstructionSet::Sse42;
+
+            return InstructionSet::Scalar;
+        }
+
+    private:
+        [[nodiscard]] static int CountLess(const Key* keys, int count, Key key) {
+            int less = 0;
+
+            for (int i = 0; i < count; ++i)
+                less += key > keys[i] ? 1 : 0;
+
+            return less;
+        }
+
+        // Packed compares are signed, unsigned keys are biased by the sign bit so
+        // that the signed order of the biased values matches the unsigned one.
+        using Signed = std::make_signed_t<Key>;
+
+        [[nodiscard]] static constexpr Signed GetBias() {
+            return std::is_signed_v<Key> ? Signed(0) : static_cast<Signed>(std::uintmax_t(1) << (sizeof(Key) * 8 - 1));
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) static int CountLessAvx2(const Key* keys, int count, Key key) {
+            constexpr int Lanes = 32 / static_cast<int>(sizeof(Key));
+
+            const __m256i bias   = Broadcast256(GetBias());
+            const __m256i needle = _mm256_xor_si256(Broadcast256(static_cast<Signed>(key)), bias);
+
+            int less = 0;
+            int i    = 0;
+
+            for (; i + Lanes <= count; i += Lanes) {
+                const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+
+                less += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(CompareGreater256(needle, block))));
+            }
+
+            // movemask yields a bit per byte
+            return less / static_cast<int>(sizeof(Key)) + CountLess(keys + i, count - i, key);
+        }
+
+        [[nodiscard]] __attribute__((target("sse4.2,popcnt"))) static int CountLessSse42(const Key* keys, int count, Key key) {
+            constexpr int Lanes = 16 / static_cast<int>(sizeof(Key));
+
+            const __m128i bias   = Broadcast128(GetBias());
+            const __m128i needle = _mm_xor_si128(Broadcast128(static_cast<Signed>(key)), bias);
+
+            int less = 0;
+            int i    = 0;
+
+            for (; i + Lanes <= count; i += Lanes) {
+                const __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+
+                less += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(CompareGreater128(needle, block))));
+            }
+
+            return less / static_cast<int>(sizeof(Key)) + CountLess(keys + i, count - i, key);
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) static __m256i Broadcast256(Signed value) {
+            if constexpr (sizeof(Key) == 1)
+                return _mm256_set1_epi8(value);
+            else if constexpr (sizeof(Key) == 2)
+                return _mm256_set1_epi16(value);
+            else if constexpr (sizeof(Key) == 4)
+                return _mm256_set1_epi32(value);
+            else
+                return _mm256_set1_epi64x(value);
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) static __m256i CompareGreater256(__m256i lhs, __m256i rhs) {
+            if constexpr (sizeof(Key) == 1)
+                return _mm256_cmpgt_epi8(lhs, rhs);
+            else if constexpr (sizeof(Key) == 2)
+                return _mm256_cmpgt_epi16(lhs, rhs);
+            else if constexpr (sizeof(Key) == 4)
+                return _mm256_cmpgt_epi32(lhs, rhs);
+            else
+                return _mm256_cmpgt_epi64(lhs, rhs);
+        }
+
+        [[nodiscard]] __attribute__((target("sse4.2"))) static __m128i Broadcast128(Signed value) {
+            if constexpr (sizeof(Key) == 1)
+                return _mm_set1_epi8(value);
+            else if constexpr (sizeof(Key) == 2)
+                return _mm_set1_epi16(value);
+            else if constexpr (sizeof(Key) == 4)
+                return _mm_set1_epi32(value);
+            else
+                return _mm_set1_epi64x(value);
+        }
+
+        [[nodiscard]] __attribute__((target("sse4.2"))) static __m128i CompareGreater128(__m128i lhs, __m128i rhs) {
+            if constexpr (sizeof(Key) == 1)
+                return _mm_cmpgt_epi8(lhs, rhs);
+            else if constexpr (sizeof(Key) == 2)
+                return _mm_cmpgt_epi16(lhs, rhs);
+            else if constexpr (sizeof(Key) == 4)
+                return _mm_cmpgt_epi32(lhs, rhs);
+            else
+                return _mm_cmpgt_epi64(lhs, rhs);
+        }
+
+    private:
+        static inline const InstructionSet s_InstructionSet = GetInstructionSet();
+
+    }; // struct KeySearch
+
+#endif
+
+} // namespace DataStructures
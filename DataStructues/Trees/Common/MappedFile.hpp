@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DATA_STRUCTURES_HAS_MMAP
+#endif
+
+namespace DataStructures {
+
+    // A whole file mapped read-only into memory. Pages are loaded on first
+    // touch and shared with the page cache, so opening a file is O(1) whatever
+    // its size. Where mmap is not available the file is read into an aligned
+    // buffer instead.
+    class MappedFile {
+    public:
+        // the mapping starts on a page, the fallback buffer is aligned to this
+        static constexpr std::size_t Alignment = 64;
+
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string& path) {
+#ifdef DATA_STRUCTURES_HAS_MMAP
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+            if (descriptor < 0)
+                throw std::runtime_error("Ng::MappedFile::MappedFile: cannot open " + path + "!");
+
+            struct stat status {};
+
+            if (::fstat(descriptor, &status) != 0) {
+                ::close(descriptor);
+                throw std::runtime_error("Ng::MappedFile::MappedFile: cannot stat " + path + "!");
+            }
+
+            m_Size = static_cast<std::size_t>(status.st_size);
+
+            if (m_Size > 0) {
+                void* data = ::mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, descriptor, 0);
+
+                if (data == MAP_FAILED) {
+                    ::close(descriptor);
+                    throw std::runtime_error("Ng::MappedFile::MappedFile: cannot map " + path + "!");
+                }
+
+                m_Data = static_cast<const unsigned char*>(data);
+            }
+
+            // the mapping stays valid without the descriptor
+            ::close(descriptor);
+#else
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+            if (!file)
+                throw std::runtime_error("Ng::MappedFile::MappedFile: cannot open " + path + "!");
+
+            m_Size = static_cast<std::size_t>(file.tellg());
+
+            if (m_Size > 0) {
+                auto* data = static_cast<char*>(::operator new(m_Size, std::align_val_t(Alignment)));
+
+                m_Data = reinterpret_cast<const unsigned char*>(data);
+
+                if (!file.seekg(0).read(data, static_cast<std::streamsize>(m_Size))) {
+                    Unmap();
+                    throw std::runtime_error("Ng::MappedFile::MappedFile: cannot read " + path + "!");
+                }
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile& other) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : m_Data(std::exchange(other.m_Data, nullptr))
+            , m_Size(std::exchange(other.m_Size, 0)) {}
+
+        ~MappedFile() {
+            Unmap();
+        }
+
+        MappedFile& operator =(const MappedFile& other) = delete;
+
+        MappedFile& operator =(MappedFile&& other) noexcept {
+            if (this == &other)
+                return *this;
+
+            Unmap();
+
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+
+            return *this;
+        }
+
+        [[nodiscard]] inline const unsigned char* GetData() const { return m_Data; }
+        [[nodiscard]] inline std::size_t GetSize() const { return m_Size; }
+
+    private:
+        void Unmap() {
+            if (!m_Data)
+                return;
+
+#ifdef DATA_STRUCTURES_HAS_MMAP
+            ::munmap(const_cast<unsigned char*>(m_Data), m_Size);
+#else
+            ::operator delete(const_cast<unsigned char*>(m_Data), std::align_val_t(Alignment));
+#endif
+            m_Data = nullptr;
+        }
+
+    private:
+        const unsigned char* m_Data = nullptr;
+        std::size_t          m_Size = 0;
+
+    }; // class MappedFile
+
+} // namespace DataStructures
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+namespace DataStructures {
+
+    // A monoid policy for augmented trees provides:
+    //     Type                           - the summary kept in every node
+    //     Type Identity()                - the summary of an empty range
+    //     Type Lift(key, value)          - the summary of a single element
+    //     Type Combine(lhs, rhs)         - associative merge, lhs holding the smaller keys
+
+    template <typename T>
+    struct SumMonoid {
+        using Type = T;
+
+        [[nodiscard]] static Type Identity() { return Type(); }
+
+        template <typename Key, typename Value>
+        [[nodiscard]] static Type Lift(const Key&, const Value& value) { return static_cast<Type>(value); }
+
+        [[nodiscard]] static Type Combine(const Type& lhs, const Type& rhs) { return lhs + rhs; }
+
+    }; // struct SumMonoid
+
+    template <typename T>
+    struct MinMonoid {
+        using Type = T;
+
+        [[nodiscard]] static Type Identity() { return std::numeric_limits<Type>::max(); }
+
+        template <typename Key, typename Value>
+        [[nodiscard]] static Type Lift(const Key&, const Value& value) { return static_cast<Type>(value); }
+
+        [[nodiscard]] static Type Combine(const Type& lhs, const Type& rhs) { return std::min(lhs, rhs); }
+
+    }; // struct MinMonoid
+
+    template <typename T>
+    struct MaxMonoid {
+        using Type = T;
+
+        [[nodiscard]] static Type Identity() { return std::numeric_limits<Type>::lowest(); }
+
+        template <typename Key, typename Value>
+        [[nodiscard]] static Type Lift(const Key&, const Value& value) { return static_cast<Type>(value); }
+
+        [[nodiscard]] static Type Combine(const Type& lhs, const Type& rhs) { return std::max(lhs, rhs); }
+
+    }; // struct MaxMonoid
+
+} // namespace DataStructures
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DataStructures {
+
+    // Slab allocator for tree nodes. Nodes are carved from contiguous chunks of
+    // ChunkSize slots, recycled through an intrusive free list on Deallocate and
+    // returned to the system all at once on Release.
+    //
+    // Any allocator plugged into a tree has to provide the same members:
+    //     T*   Allocate(Args&&... args) - construct a node
+    //     void Deallocate(T* object)    - destroy a node and take its memory back
+    //     void Release()                - free everything once all nodes are destroyed
+    //     void Reserve(size_t count)    - make room for count more nodes up front
+    //     IsBulkReleasable              - whether Release alone frees nodes that were
+    //                                     never passed to Deallocate
+    // and, for trees that are split or joined:
+    //     Allocator Share()             - a pool that co-owns the memory of this one
+    //     void Adopt(Allocator&& other) - take over the memory of other
+    //     bool IsShared()               - whether other pools may still use the
+    //                                     memory, so that Release would strand the
+    //                                     nodes that were not passed to Deallocate
+    template <typename T, std::size_t ChunkSize = 1024>
+    class NodePool {
+    public:
+        static constexpr bool IsBulkReleasable = true;
+
+        NodePool();
+        NodePool(const NodePool& other) = delete;
+        NodePool(NodePool&& other) noexcept;
+        ~NodePool();
+
+        NodePool& operator =(const NodePool& other) = delete;
+        NodePool& operator =(NodePool&& other) noexcept;
+
+        template <typename... Args>
+        [[nodiscard]] T* Allocate(Args&&... args);
+        void Deallocate(T* object);
+
+        void Release();
+        void Reserve(std::size_t count);
+
+        // Split trees keep nodes carved from the same chunks, so Share turns the
+        // chunks of a pool into a group that every pool sharing it adds its new
+        // chunks to. A pool that lets go of the group hands its free slots back
+        // to it, the other pools take them from there before carving a new
+        // chunk, and the last one frees the chunks. Adopting a pool of another
+        // group merges the two groups.
+        [[nodiscard]] NodePool Share();
+        void Adopt(NodePool&& other);
+
+        [[nodiscard]] inline bool IsShared() const { return static_cast<bool>(m_Shared); }
+
+    private:
+        union Slot {
+            Slot* Next;
+            alignas(T) unsigned char Storage[sizeof(T)];
+        };
+
+        // Guarded by Mutex. A group merged into another one keeps pointing to
+        // it through Target and holds nothing else.
+        struct SharedChunks {
+            std::mutex                    Mutex;
+            std::vector<Slot*>            Chunks;
+            Slot*                         FreeList     = nullptr;
+            Slot*                         FreeListTail = nullptr;
+            std::shared_ptr<SharedChunks> Target;
+
+            ~SharedChunks();
+        };
+
+        [[nodiscard]] Slot* AcquireSlot();
+        void PushFree(Slot* slot);
+        void RetireTail();
+        void AddChunk(std::size_t capacity);
+        static void FreeChunk(Slot* chunk);
+
+        [[nodiscard]] SharedChunks& LockShared(std::unique_lock<std::mutex>& lock);
+        void JoinShared(NodePool& other);
+        void ResetFields();
+
+    private:
+        std::vector<Slot*>            m_Chunks;
+        std::shared_ptr<SharedChunks> m_Shared;
+        Slot*                         m_Chunk;
+        Slot*                         m_FreeList;
+        Slot*                         m_FreeListTail;
+        std::size_t                   m_ChunkUsed;
+        std::size_t                   m_ChunkCapacity;
+
+    }; // class NodePool
+
+} // namespace DataStructures
+
+#include "NodePool.inl"
@@ -0,0 +1,312 @@
+#include <new>
+#include <utility>
+
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class NodePool
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize>::NodePool()
+        : m_Chunk(nullptr)
+        , m_FreeList(nullptr)
+        , m_FreeListTail(nullptr)
+        , m_ChunkUsed(0)
+        , m_ChunkCapacity(0) {}
+
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize>::NodePool(NodePool&& other) noexcept
+        : m_Chunks(std::move(other.m_Chunks))
+        , m_Shared(std::move(other.m_Shared))
+        , m_Chunk(other.m_Chunk)
+        , m_FreeList(other.m_FreeList)
+        , m_FreeListTail(other.m_FreeListTail)
+        , m_ChunkUsed(other.m_ChunkUsed)
+        , m_ChunkCapacity(other.m_ChunkCapacity) {
+        other.ResetFields();
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize>::~NodePool() {
+        Release();
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize>& NodePool<T, ChunkSize>::operator =(NodePool&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Release();
+
+        m_Chunks        = std::move(other.m_Chunks);
+        m_Shared        = std::move(other.m_Shared);
+        m_Chunk         = other.m_Chunk;
+        m_FreeList      = other.m_FreeList;
+        m_FreeListTail  = other.m_FreeListTail;
+        m_ChunkUsed     = other.m_ChunkUsed;
+        m_ChunkCapacity = other.m_ChunkCapacity;
+
+        other.ResetFields();
+
+        return *this;
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    template <typename... Args>
+    T* NodePool<T, ChunkSize>::Allocate(Args&&... args) {
+        Slot* slot = AcquireSlot();
+
+        try {
+            return new (slot->Storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            PushFree(slot);
+            throw;
+        }
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::Deallocate(T* object) {
+        if (!object)
+            return;
+
+        object->~T();
+
+        PushFree(reinterpret_cast<Slot*>(object));
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::Release() {
+        if (m_Shared) {
+            // the chunks stay with the group, only the free slots go back to it
+            RetireTail();
+
+            if (m_FreeList) {
+                std::unique_lock<std::mutex> lock;
+                SharedChunks&                shared = LockShared(lock);
+
+                m_FreeListTail->Next = shared.FreeList;
+
+                if (!shared.FreeList)
+                    shared.FreeListTail = m_FreeListTail;
+
+                shared.FreeList = m_FreeList;
+            }
+        }
+
+        for (Slot* chunk : m_Chunks)
+            FreeChunk(chunk);
+
+        ResetFields();
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::Reserve(std::size_t count) {
+        const std::size_t available = m_ChunkCapacity - m_ChunkUsed;
+
+        if (count <= available)
+            return;
+
+        // the tail of the current chunk moves to the free list, so one chunk of
+        // exactly the missing size covers the rest
+        RetireTail();
+        AddChunk(count - available);
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize> NodePool<T, ChunkSize>::Share() {
+        if (!m_Shared) {
+            m_Shared         = std::make_shared<SharedChunks>();
+            m_Shared->Chunks = std::move(m_Chunks);
+
+            m_Chunks.clear();
+        }
+
+        NodePool pool;
+
+        pool.m_Shared = m_Shared;
+
+        return pool;
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::Adopt(NodePool&& other) {
+        if (this == &other)
+            return;
+
+        other.RetireTail();
+
+        if (m_Shared || other.m_Shared)
+            JoinShared(other);
+        else
+            m_Chunks.insert(m_Chunks.end(), other.m_Chunks.begin(), other.m_Chunks.end());
+
+        if (other.m_FreeList) {
+            other.m_FreeListTail->Next = m_FreeList;
+
+            if (!m_FreeList)
+                m_FreeListTail = other.m_FreeListTail;
+
+            m_FreeList = other.m_FreeList;
+        }
+
+        other.ResetFields();
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    typename NodePool<T, ChunkSize>::Slot* NodePool<T, ChunkSize>::AcquireSlot() {
+        if (m_FreeList)
+            return std::exchange(m_FreeList, m_FreeList->Next);
+
+        if (m_ChunkUsed == m_ChunkCapacity) {
+            if (m_Shared) {
+                // slots given back by the pools that let go of the group
+                std::unique_lock<std::mutex> lock;
+                SharedChunks&                shared = LockShared(lock);
+
+                m_FreeList     = std::exchange(shared.FreeList, nullptr);
+                m_FreeListTail = std::exchange(shared.FreeListTail, nullptr);
+
+                if (m_FreeList)
+                    return std::exchange(m_FreeList, m_FreeList->Next);
+            }
+
+            AddChunk(ChunkSize);
+        }
+
+        return m_Chunk + m_ChunkUsed++;
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::PushFree(Slot* slot) {
+        // the tail is only meaningful while the list is not empty
+        if (!m_FreeList)
+            m_FreeListTail = slot;
+
+        slot->Next = m_FreeList;
+        m_FreeList = slot;
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::RetireTail() {
+        while (m_ChunkUsed < m_ChunkCapacity)
+            PushFree(m_Chunk + m_ChunkUsed++);
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::AddChunk(std::size_t capacity) {
+        std::vector<Slot*>*          chunks = &m_Chunks;
+        std::unique_lock<std::mutex> lock;
+
+        if (m_Shared)
+            chunks = &LockShared(lock).Chunks;
+
+        chunks->reserve(chunks->size() + 1);
+        chunks->push_back(static_cast<Slot*>(::operator new(sizeof(Slot) * capacity, std::align_val_t(alignof(Slot)))));
+
+        m_Chunk         = chunks->back();
+        m_ChunkUsed     = 0;
+        m_ChunkCapacity = capacity;
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    typename NodePool<T, ChunkSize>::SharedChunks& NodePool<T, ChunkSize>::LockShared(std::unique_lock<std::mutex>& lock) {
+        // follows the groups this one was merged into and keeps the last
+        while (true) {
+            lock = std::unique_lock<std::mutex>(m_Shared->Mutex);
+
+            if (!m_Shared->Target)
+                return *m_Shared;
+
+            std::shared_ptr<SharedChunks> target = m_Shared->Target;
+
+            lock.unlock();
+
+            m_Shared = std::move(target);
+        }
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::JoinShared(NodePool& other) {
+        if (!m_Shared)
+            std::swap(m_Shared, other.m_Shared);
+
+        std::unique_lock<std::mutex> lock;
+        SharedChunks&                shared = LockShared(lock);
+
+        shared.Chunks.insert(shared.Chunks.end(), m_Chunks.begin(), m_Chunks.end());
+        shared.Chunks.insert(shared.Chunks.end(), other.m_Chunks.begin(), other.m_Chunks.end());
+
+        m_Chunks.clear();
+        other.m_Chunks.clear();
+
+        if (!other.m_Shared)
+            return;
+
+        lock.unlock();
+
+        // both pools had a group, the one of other moves into this one
+        while (true) {
+            std::unique_lock<std::mutex> otherLock;
+            SharedChunks&                otherShared = other.LockShared(otherLock);
+
+            otherLock.unlock();
+
+            if (&otherShared == &LockShared(lock))
+                return;
+
+            lock.unlock();
+
+            std::scoped_lock both(m_Shared->Mutex, other.m_Shared->Mutex);
+
+            // either group may have been merged elsewhere in between
+            if (m_Shared->Target || other.m_Shared->Target)
+                continue;
+
+            m_Shared->Chunks.insert(m_Shared->Chunks.end(), other.m_Shared->Chunks.begin(), other.m_Shared->Chunks.end());
+            other.m_Shared->Chunks.clear();
+
+            if (other.m_Shared->FreeList) {
+                other.m_Shared->FreeListTail->Next = m_Shared->FreeList;
+
+                if (!m_Shared->FreeList)
+                    m_Shared->FreeListTail = other.m_Shared->FreeListTail;
+
+                m_Shared->FreeList = other.m_Shared->FreeList;
+
+                other.m_Shared->FreeList     = nullptr;
+                other.m_Shared->FreeListTail = nullptr;
+            }
+
+            other.m_Shared->Target = m_Shared;
+
+            return;
+        }
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::FreeChunk(Slot* chunk) {
+        ::operator delete(chunk, std::align_val_t(alignof(Slot)));
+    }
+
+    template <typename T, std::size_t ChunkSize>
+    void NodePool<T, ChunkSize>::ResetFields() {
+        m_Chunks.clear();
+        m_Shared.reset();
+
+        m_Chunk         = nullptr;
+        m_FreeList      = nullptr;
+        m_FreeListTail  = nullptr;
+        m_ChunkUsed     = 0;
+        m_ChunkCapacity = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// struct NodePool::SharedChunks
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename T, std::size_t ChunkSize>
+    NodePool<T, ChunkSize>::SharedChunks::~SharedChunks() {
+        for (Slot* chunk : Chunks)
+            FreeChunk(chunk);
+    }
+
+} // namespace DataStructures
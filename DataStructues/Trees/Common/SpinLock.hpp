@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace DataStructures {
+
+    // A one-byte lock for per-node locking, where a std::mutex per node would
+    // cost more than the node. Spins on a plain load and yields, so holders are
+    // expected to be short. Named like the standard locks so std::lock_guard
+    // and std::unique_lock take it.
+    class SpinLock {
+    public:
+        SpinLock() = default;
+        SpinLock(const SpinLock& other) = delete;
+
+        SpinLock& operator =(const SpinLock& other) = delete;
+
+        void lock() {
+            while (m_IsLocked.exchange(true, std::memory_order_acquire))
+                while (m_IsLocked.load(std::memory_order_relaxed))
+                    std::this_thread::yield();
+        }
+
+        [[nodiscard]] bool try_lock() {
+            return !m_IsLocked.load(std::memory_order_relaxed) && !m_IsLocked.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() {
+            m_IsLocked.store(false, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<bool> m_IsLocked { false };
+
+    }; // class SpinLock
+
+} // namespace DataStructures
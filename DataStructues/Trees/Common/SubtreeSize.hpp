@@ -0,0 +1,21 @@
+#pragma once
+
+namespace DataStructures {
+
+    // Node base that counts the nodes of its subtree for order statistics.
+    // The disabled specialization is empty, so nodes of trees without order
+    // statistics do not grow.
+    template <bool IsEnabled>
+    class SubtreeSize {
+    public:
+        [[nodiscard]] inline int GetSubtreeSize() const { return m_SubtreeSize; }
+
+    protected:
+        int m_SubtreeSize = 1;
+
+    }; // class SubtreeSize
+
+    template <>
+    class SubtreeSize<false> {};
+
+} // namespace DataStructures
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace DataStructures {
+
+    // Node base that keeps the Monoid aggregate of its subtree for range
+    // queries. Trees without a monoid use the empty void specialization.
+    template <typename Monoid>
+    class SubtreeSummary {
+    public:
+        using Type = typename Monoid::Type;
+
+        [[nodiscard]] inline const typename Monoid::Type& GetSubtreeSummary() const { return m_Summary; }
+
+    protected:
+        typename Monoid::Type m_Summary = Monoid::Identity();
+
+    }; // class SubtreeSummary
+
+    template <>
+    class SubtreeSummary<void> {
+    public:
+        using Type = void;
+
+    }; // class SubtreeSummary<void>
+
+} // namespace DataStructures
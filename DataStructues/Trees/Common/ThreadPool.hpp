@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DataStructures {
+
+    // Fork-join pool for the divide and conquer algorithms of the trees.
+    // Invoke runs one half on the calling thread and queues the other for the
+    // workers. A caller that finishes first runs queued tasks while it waits,
+    // so nested Invokes keep every thread busy and cannot deadlock, however
+    // deep the recursion goes.
+    //
+    // The caller counts as a thread, a pool of n threads starts n - 1 workers.
+    // A pool of one thread runs everything inline.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int threadCount = GetHardwareThreadCount()) {
+            if (threadCount < 1)
+                throw std::invalid_argument("Ng::ThreadPool::ThreadPool: thread count is less than 1!");
+
+            m_Workers.reserve(static_cast<std::size_t>(threadCount - 1));
+
+            for (int i = 1; i < threadCount; ++i)
+                m_Workers.emplace_back([this] { Work(); });
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_IsStopped = true;
+            }
+
+            m_Condition.notify_all();
+
+            for (std::thread& worker : m_Workers)
+                worker.join();
+        }
+
+        ThreadPool& operator =(const ThreadPool& other) = delete;
+
+        [[nodiscard]] inline int GetThreadCount() const { return static_cast<int>(m_Workers.size()) + 1; }
+
+        [[nodiscard]] static int GetHardwareThreadCount() {
+            return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        // Runs left and right, possibly in parallel, and returns once both are
+        // done. An exception of either is rethrown here after both finished.
+        template <typename Left, typename Right>
+        void Invoke(Left&& left, Right&& right) {
+            if (m_Workers.empty()) {
+                left();
+                right();
+
+                return;
+            }
+
+            Task task(right);
+
+            Push(task);
+
+            std::exception_ptr exception;
+
+            try {
+                left();
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            // right still points into this frame, so it is waited for even after a throw
+            Wait(task);
+
+            if (exception)
+                std::rethrow_exception(exception);
+
+            if (task.Exception)
+                std::rethrow_exception(task.Exception);
+        }
+
+    private:
+        struct Task {
+            using Runner = void (*)(void*);
+
+            template <typename Function>
+            explicit Task(Function& function)
+                : Context(const_cast<std::remove_const_t<Function>*>(&function))
+                , Run([](void* context) { (*static_cast<Function*>(context))(); }) {}
+
+            void* const        Context;
+            const Runner       Run;
+            std::exception_ptr Exception;
+            std::atomic<bool>  IsDone { false };
+        };
+
+        void Push(Task& task) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Tasks.push_back(&task);
+            }
+
+            m_Condition.notify_one();
+        }
+
+        // The owner takes the newest task, most likely its own and the smallest,
+        // idle workers take the oldest, the largest piece of work left.
+        Task* TryPopNewest() {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (m_Tasks.empty())
+                return nullptr;
+
+            Task* task = m_Tasks.back();
+            m_Tasks.pop_back();
+
+            return task;
+        }
+
+        static void Execute(Task& task) {
+            try {
+                task.Run(task.Context);
+            } catch (...) {
+                task.Exception = std::current_exception();
+            }
+
+            task.IsDone.store(true, std::memory_order_release);
+        }
+
+        void Wait(Task& task) {
+            while (!task.IsDone.load(std::memory_order_acquire)) {
+                if (Task* other = TryPopNewest())
+                    Execute(*other);
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+        void Work() {
+            for (;;) {
+                Task* task = nullptr;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+
+                    m_Condition.wait(lock, [this] { return m_IsStopped || !m_Tasks.empty(); });
+
+                    if (m_Tasks.empty())
+                        return;
+
+                    task = m_Tasks.front();
+                    m_Tasks.pop_front();
+                }
+
+                Execute(*task);
+            }
+        }
+
+    private:
+        std::vector<std::thread> m_Workers;
+        std::deque<Task*>        m_Tasks;
+        std::mutex               m_Mutex;
+        std::condition_variable  m_Condition;
+        bool                     m_IsStopped = false;
+
+    }; // class ThreadPool
+
+} // namespace DataStructures
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "../Common/EpochReclaimer.hpp"
+#include "../Common/SpinLock.hpp"
+
+namespace DataStructures {
+
+    // Red-black map for many threads. Lookups take no lock: they descend
+    // optimistically and validate against a sequence counter that is bumped
+    // around rotations and unlinks only, so updates that move nothing never
+    // make a reader retry. After a few failed attempts a reader falls back to
+    // the restructuring lock.
+    //
+    // Writers are relaxed-balance and only lock the node they change: a new key
+    // is hung as a red leaf under its parent, a value is swapped in its node and
+    // Pop leaves a tombstone, a node without a value. The rotations and the
+    // unlinking of tombstones this calls for are queued and done in batches by
+    // whichever writer gets the restructuring lock with try_lock, the others go
+    // on without waiting. The tree is out of balance by at most the queued
+    // work; a writer that finds more than MaxPendingCount entries queued waits
+    // for the lock to keep it bounded.
+    //
+    // Values live behind their own pointer. Unlinked nodes and replaced values
+    // are retired to the EpochReclaimer, so lookups return values by copy.
+    template <typename Key, typename Value>
+    class ConcurrentRedBlackTree {
+    public:
+        ConcurrentRedBlackTree();
+        ConcurrentRedBlackTree(const ConcurrentRedBlackTree& other) = delete;
+        ~ConcurrentRedBlackTree();
+
+        ConcurrentRedBlackTree& operator =(const ConcurrentRedBlackTree& other) = delete;
+
+        [[nodiscard]] inline bool IsEmpty() const { return GetSize() == 0; }
+        [[nodiscard]] inline int GetSize() const { return m_Size.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] bool IsExists(const Key& key) const;
+        [[nodiscard]] std::optional<Value> Find(const Key& key) const;
+        [[nodiscard]] Value Get(const Key& key) const;
+
+        // Push inserts or replaces and returns whether the key was new, Pop
+        // returns whether the key was there.
+        bool Push(const Key& key, Value value);
+        bool Push(Key&& key, Value value);
+        bool Pop(const Key& key);
+
+        void Clear();
+
+        // Visits the pairs in order under the restructuring lock. Pairs pushed
+        // or popped meanwhile may or may not be visited.
+        template <typename Function>
+        void ForEach(Function&& function) const;
+
+    private:
+        class Node {
+        public:
+            enum class Color : int {
+                Red = 0,
+                Black
+            };
+
+            template <typename KeyArg>
+            Node(KeyArg&& key, Value* value, Node* parent);
+            Node(const Node& other) = delete;
+            ~Node();
+
+            Node& operator =(const Node& other) = delete;
+
+            // a writer may hang a leaf into an empty link at any time
+            [[nodiscard]] inline Node* GetLeft() const { return m_Left.load(std::memory_order_acquire); }
+            [[nodiscard]] inline Node* GetRight() const { return m_Right.load(std::memory_order_acquire); }
+            inline void SetLeft(Node* node) { m_Left.store(node, std::memory_order_release); }
+            inline void SetRight(Node* node) { m_Right.store(node, std::memory_order_release); }
+
+            // the parent link and the color are set before a node is published
+            // and only restructuring changes them later, the color lives in the
+            // low bit of the link like in RedBlackTree
+            [[nodiscard]] inline Node* GetParent() const { return reinterpret_cast<Node*>(m_ParentAndColor & ~ColorMask); }
+            [[nodiscard]] inline Color GetColor() const { return static_cast<Color>(m_ParentAndColor & ColorMask); }
+
+            inline void SetParent(Node* parent) {
+                m_ParentAndColor = reinterpret_cast<std::uintptr_t>(parent) | (m_ParentAndColor & ColorMask);
+            }
+
+            inline void SetColor(Color color) {
+                m_ParentAndColor = (m_ParentAndColor & ~ColorMask) | static_cast<std::uintptr_t>(color);
+            }
+
+            static constexpr std::uintptr_t ColorMask = 1;
+
+            // a descent reads the key and the links, the rest goes last
+            const Key           m_Key;
+            std::atomic<Node*>  m_Left;
+            std::atomic<Node*>  m_Right;
+            std::uintptr_t      m_ParentAndColor;
+            std::atomic<Value*> m_Value;
+
+            // guards the empty links, the value and the flags against writers
+            SpinLock            m_Lock;
+            bool                m_IsUnlinked;
+            bool                m_IsPopQueued;
+
+            // links of the queues of inserted and popped nodes
+            Node*               m_NextInserted;
+            Node*               m_NextPopped;
+
+        }; // class Node
+
+        // Where a descent for a key ended: at its node, whose value is read
+        // before the descent is validated, or at the empty link of Parent it
+        // belongs under. Version is the sequence counter it was validated at.
+        struct Location {
+            Node*         Found      = nullptr;
+            Value*        FoundValue = nullptr;
+            Node*         Parent     = nullptr;
+            bool          IsLeft     = false;
+            std::uint64_t Version    = 0;
+        };
+
+        static constexpr int MaxAttemptCount = 8;
+        static constexpr int MaxPendingCount = 256;
+
+        // deeper than any red-black tree of 2^31 nodes with the queued work on top
+        static constexpr int MaxDepth = 128 + MaxPendingCount;
+
+        template <typename Function>
+        auto Read(const Key& key, Function&& function) const;
+
+        // Descends optimistically and after a few failed attempts takes lock,
+        // the restructuring lock, to descend once more.
+        [[nodiscard]] Location Locate(const Key& key, std::unique_lock<std::mutex>& lock) const;
+
+        // With isStill, under the restructuring lock, the descent always holds,
+        // otherwise it fails if a restructuring may have misled it.
+        bool TryLocate(const Key& key, Location& location, bool isStill) const;
+
+        template <typename KeyArg>
+        bool Insert(KeyArg&& key, Value&& value);
+
+        void Enqueue(std::atomic<Node*>& queue, Node* node, Node* Node::* next);
+
+        // Restructures until both queues are empty if the lock is free, or
+        // waits for it once they hold more than MaxPendingCount entries.
+        void Maintain();
+        void Restructure();
+
+        void Rebalance(Node* node);
+        void Unlink(Node* node);
+        [[nodiscard]] bool Detach(Node* node);
+
+        void BeginRestructure();
+        void EndRestructure();
+
+        void Transplant(Node* node, Node* child);
+
+        void RotateLeft(Node* node);
+        void RotateRight(Node* node);
+
+        void PushFix(Node* node);
+        void PopFix(Node* node, Node* parent, bool isLeft);
+
+        [[nodiscard]] static bool IsBlack(const Node* node);
+        [[nodiscard]] static Node* GetMinNode(Node* node);
+
+        template <typename Function>
+        static void ForEach(const Node* node, Function& function);
+
+        // marks the nodes of a detached tree and returns how many values it held
+        [[nodiscard]] static int MarkUnlinked(Node* node);
+        static void Destroy(void* node);
+
+    private:
+        std::atomic<Node*>         m_Root;
+        std::atomic<std::uint64_t> m_Version;
+        std::atomic<int>           m_Size;
+        std::atomic<Node*>         m_Inserted;
+        std::atomic<Node*>         m_Popped;
+        std::atomic<int>           m_PendingCount;
+        SpinLock                   m_RootLock;
+        mutable std::mutex         m_Mutex;
+        int                        m_RestructureDepth;
+
+    }; // class ConcurrentRedBlackTree
+
+} // namespace DataStructures
+
+#include "ConcurrentRedBlackTree.inl"
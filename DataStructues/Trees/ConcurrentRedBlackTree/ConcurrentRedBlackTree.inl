@@ -0,0 +1,762 @@
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class ConcurrentRedBlackTree::Node
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    ConcurrentRedBlackTree<Key, Value>::Node::Node(KeyArg&& key, Value* value, Node* parent)
+        : m_Key(std::forward<KeyArg>(key))
+        , m_Left(nullptr)
+        , m_Right(nullptr)
+        , m_ParentAndColor(reinterpret_cast<std::uintptr_t>(parent))
+        , m_Value(value)
+        , m_IsUnlinked(false)
+        , m_IsPopQueued(false)
+        , m_NextInserted(nullptr)
+        , m_NextPopped(nullptr) {}
+
+    template <typename Key, typename Value>
+    ConcurrentRedBlackTree<Key, Value>::Node::~Node() {
+        delete m_Value.load(std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class ConcurrentRedBlackTree
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    ConcurrentRedBlackTree<Key, Value>::ConcurrentRedBlackTree()
+        : m_Root(nullptr)
+        , m_Version(0)
+        , m_Size(0)
+        , m_Inserted(nullptr)
+        , m_Popped(nullptr)
+        , m_PendingCount(0)
+        , m_RestructureDepth(0) {}
+
+    template <typename Key, typename Value>
+    ConcurrentRedBlackTree<Key, Value>::~ConcurrentRedBlackTree() {
+        // nobody may use the tree any more, so nothing has to wait for an epoch
+        // and the queues only hold nodes of the tree
+        Destroy(m_Root.load(std::memory_order_relaxed));
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::IsExists(const Key& key) const {
+        return Read(key, [](const Value* value) { return value != nullptr; });
+    }
+
+    template <typename Key, typename Value>
+    std::optional<Value> ConcurrentRedBlackTree<Key, Value>::Find(const Key& key) const {
+        return Read(key, [](const Value* value) { return value ? std::optional<Value>(*value) : std::nullopt; });
+    }
+
+    template <typename Key, typename Value>
+    Value ConcurrentRedBlackTree<Key, Value>::Get(const Key& key) const {
+        std::optional<Value> value = Find(key);
+
+        if (!value)
+            throw std::out_of_range("Ng::ConcurrentRedBlackTree::Get: key is not exists!");
+
+        return std::move(*value);
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::Push(const Key& key, Value value) {
+        return Insert(key, std::move(value));
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::Push(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value));
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::Pop(const Key& key) {
+        EpochReclaimer::Guard guard;
+
+        bool isFound = false;
+
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_Mutex, std::defer_lock);
+
+            const Location location = Locate(key, lock);
+            Node*          node     = location.Found;
+
+            // a tombstone met by a valid descent means the key was not there
+            if (!node || !location.FoundValue)
+                break;
+
+            std::lock_guard<SpinLock> nodeLock(node->m_Lock);
+
+            // only tombstones are unlinked, the key may be back in another node
+            if (node->m_IsUnlinked)
+                continue;
+
+            Value* value = node->m_Value.exchange(nullptr, std::memory_order_acq_rel);
+
+            if (!value)
+                break;
+
+            EpochReclaimer::Retire(value);
+
+            m_Size.fetch_sub(1, std::memory_order_relaxed);
+
+            // a node popped, pushed and popped again before it is unlinked is queued once
+            if (!node->m_IsPopQueued) {
+                node->m_IsPopQueued = true;
+
+                Enqueue(m_Popped, node, &Node::m_NextPopped);
+            }
+
+            isFound = true;
+            break;
+        }
+
+        Maintain();
+
+        return isFound;
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Clear() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Node* root = nullptr;
+
+        {
+            // a writer hangs a node into an empty tree under this lock
+            std::lock_guard<SpinLock> rootLock(m_RootLock);
+
+            BeginRestructure();
+            root = m_Root.exchange(nullptr, std::memory_order_release);
+            EndRestructure();
+        }
+
+        // Writers still headed for the old nodes find them unlinked and start
+        // over. Nodes of them that are queued are skipped, so the queues are
+        // drained before the nodes are retired.
+        m_Size.fetch_sub(MarkUnlinked(root), std::memory_order_relaxed);
+
+        Restructure();
+
+        if (root)
+            EpochReclaimer::Retire(root, &Destroy);
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    void ConcurrentRedBlackTree<Key, Value>::ForEach(Function&& function) const {
+        EpochReclaimer::Guard       guard;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        ForEach(m_Root.load(std::memory_order_acquire), function);
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    auto ConcurrentRedBlackTree<Key, Value>::Read(const Key& key, Function&& function) const {
+        EpochReclaimer::Guard        guard;
+        std::unique_lock<std::mutex> lock(m_Mutex, std::defer_lock);
+
+        return function(Locate(key, lock).FoundValue);
+    }
+
+    template <typename Key, typename Value>
+    typename ConcurrentRedBlackTree<Key, Value>::Location ConcurrentRedBlackTree<Key, Value>::Locate(const Key& key, std::unique_lock<std::mutex>& lock) const {
+        Location location;
+
+        for (int attempt = 0; attempt < MaxAttemptCount; ++attempt) {
+            if (TryLocate(key, location, false))
+                return location;
+
+            std::this_thread::yield();
+        }
+
+        lock.lock();
+
+        TryLocate(key, location, true);
+
+        return location;
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::TryLocate(const Key& key, Location& location, bool isStill) const {
+        const std::uint64_t version = m_Version.load(std::memory_order_acquire);
+
+        // an odd version means a restructuring is under way
+        if (!isStill && (version & 1))
+            return false;
+
+        location         = Location();
+        location.Version = version;
+
+        // A descent racing with rotations can wander, the depth bound makes sure
+        // it ends, validation throws its answer away.
+        Node* node = m_Root.load(std::memory_order_acquire);
+
+        for (int depth = 0; node; ++depth) {
+            if (!(key > node->m_Key || node->m_Key > key)) {
+                location.Found      = node;
+                location.FoundValue = node->m_Value.load(std::memory_order_acquire);
+                break;
+            }
+
+            if (depth == MaxDepth && !isStill)
+                return false;
+
+            location.Parent = node;
+            location.IsLeft = node->m_Key > key;
+
+            node = (location.IsLeft ? node->m_Left : node->m_Right).load(std::memory_order_acquire);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return isStill || m_Version.load(std::memory_order_relaxed) == version;
+    }
+
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    bool ConcurrentRedBlackTree<Key, Value>::Insert(KeyArg&& key, Value&& value) {
+        EpochReclaimer::Guard guard;
+
+        Value* pointer = new Value(std::move(value));
+        bool   isNew   = true;
+
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_Mutex, std::defer_lock);
+
+            const Location location = Locate(key, lock);
+
+            if (Node* node = location.Found) {
+                std::lock_guard<SpinLock> nodeLock(node->m_Lock);
+
+                // only tombstones are unlinked, the key may be back in another node
+                if (node->m_IsUnlinked)
+                    continue;
+
+                // a value on a tombstone brings the key back
+                if (Value* old = node->m_Value.exchange(pointer, std::memory_order_acq_rel)) {
+                    EpochReclaimer::Retire(old);
+                    isNew = false;
+                } else {
+                    m_Size.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                break;
+            }
+
+            Node*                     parent = location.Parent;
+            std::lock_guard<SpinLock> parentLock(parent ? parent->m_Lock : m_RootLock);
+            std::atomic<Node*>&       link   = !parent ? m_Root : (location.IsLeft ? parent->m_Left : parent->m_Right);
+
+            // The descent ended at an empty link of parent, so key lay between
+            // parent and its neighbour on that side. A node hung there narrows
+            // the gap and fills the link, but a rotation may empty the link again
+            // and leave the gap narrowed, so the link only holds while nothing
+            // was restructured. Restructuring bumps the counter before it empties
+            // a link, and under the lock the link is filled by nobody else.
+            if ((parent && parent->m_IsUnlinked) || link.load(std::memory_order_acquire))
+                continue;
+
+            if (m_Version.load(std::memory_order_relaxed) != location.Version)
+                continue;
+
+            Node* node = new Node(std::forward<KeyArg>(key), pointer, parent);
+
+            // a Pop has to wait until node is queued for rebalancing, so that it
+            // is never unlinked while a rebalance of it is still to come
+            std::lock_guard<SpinLock> nodeLock(node->m_Lock);
+
+            // hanging a new leaf moves nothing, readers see it or not
+            link.store(node, std::memory_order_release);
+
+            Enqueue(m_Inserted, node, &Node::m_NextInserted);
+
+            m_Size.fetch_add(1, std::memory_order_relaxed);
+
+            break;
+        }
+
+        Maintain();
+
+        return isNew;
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Enqueue(std::atomic<Node*>& queue, Node* node, Node* Node::* next) {
+        Node* head = queue.load(std::memory_order_relaxed);
+
+        do {
+            node->*next = head;
+        } while (!queue.compare_exchange_weak(head, node, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+        m_PendingCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Maintain() {
+        // past the bound a writer waits its turn rather than let the tree drift
+        // further out of balance
+        if (m_PendingCount.load(std::memory_order_relaxed) > MaxPendingCount) {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Restructure();
+        }
+
+        // The holder looks at the queues again after unlocking, so work queued
+        // while it restructured is picked up by it or by the writer that queued
+        // it, whichever gets the lock.
+        while (true) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (!m_Inserted.load(std::memory_order_relaxed) && !m_Popped.load(std::memory_order_relaxed))
+                return;
+
+            if (!m_Mutex.try_lock())
+                return;
+
+            Restructure();
+
+            m_Mutex.unlock();
+        }
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Restructure() {
+        while (true) {
+            // A node is queued as inserted before it can be popped, so taking the
+            // popped queue first leaves none of its nodes waiting for a rebalance
+            // once the inserted queue taken next is done.
+            Node* popped   = m_Popped.exchange(nullptr, std::memory_order_acquire);
+            Node* inserted = m_Inserted.exchange(nullptr, std::memory_order_acquire);
+
+            if (!popped && !inserted)
+                break;
+
+            while (inserted) {
+                Node* next = inserted->m_NextInserted;
+
+                // nodes of a tree Clear detached are skipped
+                if (!inserted->m_IsUnlinked)
+                    Rebalance(inserted);
+
+                m_PendingCount.fetch_sub(1, std::memory_order_relaxed);
+
+                inserted = next;
+            }
+
+            while (popped) {
+                Node* next = popped->m_NextPopped;
+
+                Unlink(popped);
+
+                m_PendingCount.fetch_sub(1, std::memory_order_relaxed);
+
+                popped = next;
+            }
+        }
+
+        // a node hung into an empty tree starts red
+        if (Node* root = m_Root.load(std::memory_order_relaxed))
+            root->SetColor(Node::Color::Black);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Rebalance(Node* node) {
+        // Leaves hung meanwhile may stack more than one pair of red nodes on the
+        // path, the lower node of each pair is queued. Fixing the topmost pair
+        // first keeps the grandparent black, as PushFix needs.
+        while (true) {
+            Node* top = nullptr;
+
+            for (Node* current = node; current->GetParent(); current = current->GetParent())
+                if (current->GetColor() == Node::Color::Red && current->GetParent()->GetColor() == Node::Color::Red)
+                    top = current;
+
+            if (!top)
+                return;
+
+            PushFix(top);
+        }
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Unlink(Node* node) {
+        if (node->m_IsUnlinked)
+            return;
+
+        BeginRestructure();
+        const bool isDetached = Detach(node);
+        EndRestructure();
+
+        if (isDetached)
+            EpochReclaimer::Retire(node);
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::Detach(Node* node) {
+        // Keys are immutable, so a node with two children is replaced by relinking
+        // its successor rather than by copying the successor's pair into it.
+        //
+        // Writers only fill empty links, so of the links restructuring rewrites
+        // only those that may be empty need the lock of their node.
+        Node*                child        = nullptr;
+        Node*                parent       = nullptr;
+        bool                 isLeft       = false;
+        typename Node::Color removedColor = node->GetColor();
+
+        {
+            std::lock_guard<SpinLock> nodeLock(node->m_Lock);
+
+            // pushed again since it was popped, the next Pop queues it again
+            if (node->m_Value.load(std::memory_order_relaxed)) {
+                node->m_IsPopQueued = false;
+
+                return false;
+            }
+
+            node->m_IsUnlinked = true;
+
+            Node* left  = node->GetLeft();
+            Node* right = node->GetRight();
+
+            if (!left || !right) {
+                child  = left ? left : right;
+                parent = node->GetParent();
+                isLeft = parent && parent->GetLeft() == node;
+
+                Transplant(node, child);
+            } else {
+                Node*                      successor = nullptr;
+                std::unique_lock<SpinLock> successorLock;
+
+                // the lock keeps a writer from hanging a smaller key under the successor
+                while (true) {
+                    successor     = GetMinNode(right);
+                    successorLock = std::unique_lock<SpinLock>(successor->m_Lock);
+
+                    if (!successor->GetLeft())
+                        break;
+
+                    successorLock.unlock();
+                }
+
+                removedColor = successor->GetColor();
+                child        = successor->GetRight();
+
+                if (successor == right) {
+                    parent = successor;
+                } else {
+                    parent = successor->GetParent();
+                    isLeft = true;
+
+                    Transplant(successor, child);
+
+                    successor->SetRight(right);
+                    right->SetParent(successor);
+                }
+
+                Transplant(node, successor);
+
+                successor->SetLeft(left);
+                left->SetParent(successor);
+                successor->SetColor(node->GetColor());
+            }
+        }
+
+        if (removedColor == Node::Color::Black)
+            PopFix(child, parent, isLeft);
+
+        return true;
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::BeginRestructure() {
+        if (m_RestructureDepth++ > 0)
+            return;
+
+        m_Version.store(m_Version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::EndRestructure() {
+        if (--m_RestructureDepth > 0)
+            return;
+
+        m_Version.store(m_Version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Transplant(Node* node, Node* child) {
+        Node* parent = node->GetParent();
+
+        if (!parent)
+            m_Root.store(child, std::memory_order_release);
+        else if (parent->GetLeft() == node)
+            parent->SetLeft(child);
+        else
+            parent->SetRight(child);
+
+        if (child)
+            child->SetParent(parent);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::RotateLeft(Node* node) {
+        /*   c      =>      s
+            / \            / \
+           u   s    =>    c   r
+              / \        / \
+             l   r  =>  u   l */
+        Node* right = node->GetRight();
+
+        // l may be an empty link a writer is about to fill
+        std::lock_guard<SpinLock> lock(right->m_Lock);
+
+        BeginRestructure();
+
+        Node* rightLeft = right->GetLeft();
+
+        Transplant(node, right);
+
+        node->SetParent(right);
+        right->SetLeft(node);
+        node->SetRight(rightLeft);
+
+        if (rightLeft)
+            rightLeft->SetParent(node);
+
+        EndRestructure();
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::RotateRight(Node* node) {
+        /*     c    =>    u
+              / \        / \
+             u   s  =>  l   c
+            / \            / \
+           l   r    =>    r   s */
+        Node* left = node->GetLeft();
+
+        // r may be an empty link a writer is about to fill
+        std::lock_guard<SpinLock> lock(left->m_Lock);
+
+        BeginRestructure();
+
+        Node* leftRight = left->GetRight();
+
+        Transplant(node, left);
+
+        node->SetParent(left);
+        left->SetRight(node);
+        node->SetLeft(leftRight);
+
+        if (leftRight)
+            leftRight->SetParent(node);
+
+        EndRestructure();
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::PushFix(Node* node) {
+        while (node->GetParent() && node->GetParent()->GetColor() == Node::Color::Red) {
+            Node* parent      = node->GetParent();
+            Node* grandParent = parent->GetParent();
+
+            // a node hung into an empty tree is a red root until restructured
+            if (!grandParent) {
+                parent->SetColor(Node::Color::Black);
+                break;
+            }
+
+            Node* uncle = grandParent->GetLeft() == parent ? grandParent->GetRight() : grandParent->GetLeft();
+
+            if (!IsBlack(uncle)) {
+                parent->SetColor(Node::Color::Black);
+                uncle->SetColor(Node::Color::Black);
+                grandParent->SetColor(Node::Color::Red);
+
+                node = grandParent;
+                continue;
+            }
+
+            if (grandParent->GetLeft() == parent) {
+                // from shape triangle to line
+                if (parent->GetRight() == node) {
+                    RotateLeft(parent);
+                    std::swap(node, parent);
+                }
+
+                parent->SetColor(Node::Color::Black);
+                grandParent->SetColor(Node::Color::Red);
+
+                RotateRight(grandParent);
+            } else {
+                if (parent->GetLeft() == node) {
+                    RotateRight(parent);
+                    std::swap(node, parent);
+                }
+
+                parent->SetColor(Node::Color::Black);
+                grandParent->SetColor(Node::Color::Red);
+
+                RotateLeft(grandParent);
+            }
+        }
+
+        m_Root.load(std::memory_order_relaxed)->SetColor(Node::Color::Black);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::PopFix(Node* node, Node* parent, bool isLeft) {
+        // node may be an empty link a writer fills meanwhile, so its side is kept
+        // apart rather than found by comparing it with the links of parent
+        while (parent && IsBlack(node)) {
+            if (isLeft) {
+                Node* sibling = parent->GetRight();
+
+                if (!IsBlack(sibling)) {
+                    sibling->SetColor(Node::Color::Black);
+                    parent->SetColor(Node::Color::Red);
+
+                    RotateLeft(parent);
+                    sibling = parent->GetRight();
+                }
+
+                if (IsBlack(sibling->GetLeft()) && IsBlack(sibling->GetRight())) {
+                    sibling->SetColor(Node::Color::Red);
+
+                    node   = parent;
+                    parent = node->GetParent();
+                    isLeft = parent && parent->GetLeft() == node;
+                } else {
+                    if (IsBlack(sibling->GetRight())) {
+                        sibling->SetColor(Node::Color::Red);
+                        sibling->GetLeft()->SetColor(Node::Color::Black);
+
+                        RotateRight(sibling);
+                        sibling = parent->GetRight();
+                    }
+
+                    sibling->SetColor(parent->GetColor());
+                    parent->SetColor(Node::Color::Black);
+
+                    if (Node* right = sibling->GetRight())
+                        right->SetColor(Node::Color::Black);
+
+                    RotateLeft(parent);
+
+                    node   = m_Root.load(std::memory_order_relaxed);
+                    parent = nullptr;
+                }
+            } else {
+                Node* sibling = parent->GetLeft();
+
+                if (!IsBlack(sibling)) {
+                    sibling->SetColor(Node::Color::Black);
+                    parent->SetColor(Node::Color::Red);
+
+                    RotateRight(parent);
+                    sibling = parent->GetLeft();
+                }
+
+                if (IsBlack(sibling->GetLeft()) && IsBlack(sibling->GetRight())) {
+                    sibling->SetColor(Node::Color::Red);
+
+                    node   = parent;
+                    parent = node->GetParent();
+                    isLeft = parent && parent->GetLeft() == node;
+                } else {
+                    if (IsBlack(sibling->GetLeft())) {
+                        sibling->SetColor(Node::Color::Red);
+                        sibling->GetRight()->SetColor(Node::Color::Black);
+
+                        RotateLeft(sibling);
+                        sibling = parent->GetLeft();
+                    }
+
+                    sibling->SetColor(parent->GetColor());
+                    parent->SetColor(Node::Color::Black);
+
+                    if (Node* left = sibling->GetLeft())
+                        left->SetColor(Node::Color::Black);
+
+                    RotateRight(parent);
+
+                    node   = m_Root.load(std::memory_order_relaxed);
+                    parent = nullptr;
+                }
+            }
+        }
+
+        if (node)
+            node->SetColor(Node::Color::Black);
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentRedBlackTree<Key, Value>::IsBlack(const Node* node) {
+        return !node || node->GetColor() == Node::Color::Black;
+    }
+
+    template <typename Key, typename Value>
+    typename ConcurrentRedBlackTree<Key, Value>::Node* ConcurrentRedBlackTree<Key, Value>::GetMinNode(Node* node) {
+        while (node->GetLeft())
+            node = node->GetLeft();
+
+        return node;
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    void ConcurrentRedBlackTree<Key, Value>::ForEach(const Node* node, Function& function) {
+        if (!node)
+            return;
+
+        ForEach(node->GetLeft(), function);
+
+        if (const Value* value = node->m_Value.load(std::memory_order_acquire))
+            function(node->m_Key, *value);
+
+        ForEach(node->GetRight(), function);
+    }
+
+    template <typename Key, typename Value>
+    int ConcurrentRedBlackTree<Key, Value>::MarkUnlinked(Node* node) {
+        if (!node)
+            return 0;
+
+        Node* left  = nullptr;
+        Node* right = nullptr;
+        int   count = 0;
+
+        {
+            // once marked nothing is hung under the node or changes its value
+            std::lock_guard<SpinLock> lock(node->m_Lock);
+
+            node->m_IsUnlinked = true;
+
+            left  = node->GetLeft();
+            right = node->GetRight();
+            count = node->m_Value.load(std::memory_order_relaxed) ? 1 : 0;
+        }
+
+        return count + MarkUnlinked(left) + MarkUnlinked(right);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentRedBlackTree<Key, Value>::Destroy(void* node) {
+        if (!node)
+            return;
+
+        Node* root = static_cast<Node*>(node);
+
+        Destroy(root->GetLeft());
+        Destroy(root->GetRight());
+
+        delete root;
+    }
+
+} // namespace DataStructures
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "../Common/EpochReclaimer.hpp"
+#include "../Common/ITree.hpp"
+
+namespace DataStructures {
+
+    // Lock-free skip list. Every operation is a sequence of compare-and-swaps on
+    // the links, so a stalled thread never blocks the others.
+    //
+    // Pop marks the links of a node from the top level down. The thread that
+    // marks level 0 owns the removal, and any search that meets a marked link
+    // helps unlinking the node. Both the inserting and the removing thread hold
+    // a node until they are done with its tower, and the last of them retires
+    // it to the EpochReclaimer. A late insert therefore never relinks a node
+    // that is already being freed.
+    //
+    // Values live behind their own pointer, so Assign to an existing key swaps
+    // the pointer and retires the old value. References returned by Push and
+    // Assign and reached through iterators stay valid until the key is assigned
+    // again or popped by another thread. Readers that need more use Find, which
+    // copies.
+    template <typename Key, typename Value>
+    class ConcurrentSkipList : public ITree<Key, Value> {
+    private:
+        class Node;
+
+    public:
+        // Walks level 0 and skips removed nodes. The walk is weakly consistent:
+        // it sees every key present for its whole duration and may or may not
+        // see keys pushed or popped meanwhile. Iterating next to a concurrent Pop
+        // needs an EpochReclaimer::Guard on the iterating thread.
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const Key&, const Value&>;
+
+            struct pointer {
+                reference Pair;
+
+                inline reference* operator ->() { return &Pair; }
+            };
+
+            explicit ConstIterator(const Node* node = nullptr);
+
+            [[nodiscard]] inline reference operator *() const { return { m_Node->m_Key, *m_Node->m_Value.load(std::memory_order_acquire) }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+        private:
+            const Node* m_Node;
+
+        }; // class ConstIterator
+
+        // With a quarter of the nodes promoted per level this covers 2^32 keys.
+        static constexpr int MaxHeight = 16;
+
+        ConcurrentSkipList();
+        ConcurrentSkipList(const ConcurrentSkipList& other) = delete;
+        // Moving is not safe while other threads use either list.
+        ConcurrentSkipList(ConcurrentSkipList&& other) noexcept;
+        ~ConcurrentSkipList() override;
+
+        ConcurrentSkipList& operator =(const ConcurrentSkipList& other) = delete;
+        ConcurrentSkipList& operator =(ConcurrentSkipList&& other) = delete;
+
+        [[nodiscard]] inline bool IsEmpty() const override { return GetSize() == 0; }
+        [[nodiscard]] inline int GetSize() const override { return m_Size.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] bool IsExists(const Key& key) const override;
+        [[nodiscard]] int GetHeight() const override;
+
+        [[nodiscard]] std::optional<Value> Find(const Key& key) const;
+        [[nodiscard]] Value Get(const Key& key) const;
+
+        // Like the other trees Push keeps the value of a key that is already
+        // there, Assign replaces it.
+        Value& Push(const Key& key, Value value) override;
+        Value& Push(Key&& key, Value value) override;
+        Value& Assign(const Key& key, Value value);
+        Value& Assign(Key&& key, Value value);
+        void Pop(const Key& key) override;
+
+        // Pops the keys one by one, so it may run next to other operations but
+        // is not atomic as a whole.
+        void Clear();
+
+        // Visits the pairs in order under a guard of its own.
+        template <typename Function>
+        void ForEach(Function&& function) const;
+
+        [[nodiscard]] ConstIterator begin() const { return ConstIterator(GetFirst()); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(); }
+
+        [[nodiscard]] ConstIterator cbegin() const { return ConstIterator(GetFirst()); }
+        [[nodiscard]] ConstIterator cend() const { return ConstIterator(); }
+
+    private:
+        // A link is a node pointer whose low bit marks the node owning the link
+        // as removed at that level.
+        using Link = std::atomic<std::uintptr_t>;
+
+        static constexpr std::uintptr_t MarkMask = 1;
+
+        class Node {
+        public:
+            template <typename KeyArg>
+            [[nodiscard]] static Node* Create(KeyArg&& key, Value* value, int height);
+            static void Destroy(void* node);
+
+            // the tower of height links follows the node in the same allocation
+            [[nodiscard]] inline Link& GetLink(int level) { return reinterpret_cast<Link*>(this + 1)[level]; }
+            [[nodiscard]] inline const Link& GetLink(int level) const { return reinterpret_cast<const Link*>(this + 1)[level]; }
+
+            // the inserting and the removing thread, the last to let go retires the node
+            void Release();
+
+            const Key           m_Key;
+            std::atomic<Value*> m_Value;
+            std::atomic<int>    m_OwnerCount;
+            const int           m_Height;
+
+        private:
+            template <typename KeyArg>
+            Node(KeyArg&& key, Value* value, int height);
+            ~Node();
+
+        }; // class Node
+
+        template <typename KeyArg>
+        Value& Insert(KeyArg&& key, Value&& value, bool isAssign);
+
+        // Fills the neighbours of key on every level and unlinks the marked nodes
+        // on the way. Returns whether succs[0] holds key.
+        bool Search(const Key& key, Node** preds, Node** succs);
+        bool TrySearch(const Key& key, Node** preds, Node** succs, bool& isFound);
+
+        // read-only descent for lookups, it never writes a link
+        [[nodiscard]] const Node* FindNode(const Key& key) const;
+        [[nodiscard]] const Node* GetFirst() const;
+        [[nodiscard]] static const Node* SkipRemoved(const Node* node);
+
+        [[nodiscard]] inline Link& GetLink(Node* node, int level) { return node ? node->GetLink(level) : m_Head[level]; }
+        [[nodiscard]] inline const Link& GetLink(const Node* node, int level) const { return node ? node->GetLink(level) : m_Head[level]; }
+
+        [[nodiscard]] static inline Node* ToNode(std::uintptr_t link) { return reinterpret_cast<Node*>(link & ~MarkMask); }
+        [[nodiscard]] static inline std::uintptr_t ToLink(const Node* node) { return reinterpret_cast<std::uintptr_t>(node); }
+        [[nodiscard]] static inline bool IsMarked(std::uintptr_t link) { return link & MarkMask; }
+
+        [[nodiscard]] static int GetRandomHeight();
+
+    private:
+        Link             m_Head[MaxHeight];
+        std::atomic<int> m_Size;
+
+    }; // class ConcurrentSkipList
+
+} // namespace DataStructures
+
+#include "ConcurrentSkipList.inl"
@@ -0,0 +1,424 @@
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class ConcurrentSkipList::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    ConcurrentSkipList<Key, Value>::ConstIterator::ConstIterator(const Node* node)
+        : m_Node(node) {}
+
+    template <typename Key, typename Value>
+    typename ConcurrentSkipList<Key, Value>::ConstIterator& ConcurrentSkipList<Key, Value>::ConstIterator::operator ++() {
+        m_Node = SkipRemoved(ToNode(m_Node->GetLink(0).load(std::memory_order_acquire)));
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename ConcurrentSkipList<Key, Value>::ConstIterator ConcurrentSkipList<Key, Value>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentSkipList<Key, Value>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Node == other.m_Node;
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentSkipList<Key, Value>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class ConcurrentSkipList::Node
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    ConcurrentSkipList<Key, Value>::Node::Node(KeyArg&& key, Value* value, int height)
+        : m_Key(std::forward<KeyArg>(key))
+        , m_Value(value)
+        , m_OwnerCount(2)
+        , m_Height(height) {}
+
+    template <typename Key, typename Value>
+    ConcurrentSkipList<Key, Value>::Node::~Node() {
+        delete m_Value.load(std::memory_order_relaxed);
+    }
+
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    typename ConcurrentSkipList<Key, Value>::Node* ConcurrentSkipList<Key, Value>::Node::Create(KeyArg&& key, Value* value, int height) {
+        void* memory = ::operator new(sizeof(Node) + static_cast<std::size_t>(height) * sizeof(Link));
+        Node* node   = nullptr;
+
+        try {
+            node = new (memory) Node(std::forward<KeyArg>(key), value, height);
+        } catch (...) {
+            ::operator delete(memory);
+            throw;
+        }
+
+        for (int level = 0; level < height; ++level)
+            new (&node->GetLink(level)) Link(0);
+
+        return node;
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentSkipList<Key, Value>::Node::Destroy(void* node) {
+        static_cast<Node*>(node)->~Node();
+        ::operator delete(node);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentSkipList<Key, Value>::Node::Release() {
+        if (m_OwnerCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            EpochReclaimer::Retire(this, &Destroy);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class ConcurrentSkipList
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    ConcurrentSkipList<Key, Value>::ConcurrentSkipList()
+        : m_Size(0) {
+        for (Link& link : m_Head)
+            link.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename Key, typename Value>
+    ConcurrentSkipList<Key, Value>::ConcurrentSkipList(ConcurrentSkipList&& other) noexcept
+        : m_Size(other.m_Size.exchange(0, std::memory_order_relaxed)) {
+        for (int level = 0; level < MaxHeight; ++level)
+            m_Head[level].store(other.m_Head[level].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    template <typename Key, typename Value>
+    ConcurrentSkipList<Key, Value>::~ConcurrentSkipList() {
+        // Finished Pops have unlinked their nodes from every level, so level 0
+        // holds exactly the nodes nobody retired.
+        Node* node = ToNode(m_Head[0].load(std::memory_order_relaxed));
+
+        while (node) {
+            Node* next = ToNode(node->GetLink(0).load(std::memory_order_relaxed));
+
+            Node::Destroy(node);
+            node = next;
+        }
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentSkipList<Key, Value>::IsExists(const Key& key) const {
+        EpochReclaimer::Guard guard;
+
+        return FindNode(key);
+    }
+
+    template <typename Key, typename Value>
+    int ConcurrentSkipList<Key, Value>::GetHeight() const {
+        for (int level = MaxHeight - 1; level >= 0; --level) {
+            if (ToNode(m_Head[level].load(std::memory_order_relaxed)))
+                return level + 1;
+        }
+
+        return 0;
+    }
+
+    template <typename Key, typename Value>
+    std::optional<Value> ConcurrentSkipList<Key, Value>::Find(const Key& key) const {
+        EpochReclaimer::Guard guard;
+
+        const Node* node = FindNode(key);
+
+        return node ? std::optional<Value>(*node->m_Value.load(std::memory_order_acquire)) : std::nullopt;
+    }
+
+    template <typename Key, typename Value>
+    Value ConcurrentSkipList<Key, Value>::Get(const Key& key) const {
+        std::optional<Value> value = Find(key);
+
+        if (!value)
+            throw std::out_of_range("Ng::ConcurrentSkipList::Get: key is not exists!");
+
+        return std::move(*value);
+    }
+
+    template <typename Key, typename Value>
+    Value& ConcurrentSkipList<Key, Value>::Push(const Key& key, Value value) {
+        return Insert(key, std::move(value), false);
+    }
+
+    template <typename Key, typename Value>
+    Value& ConcurrentSkipList<Key, Value>::Push(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value), false);
+    }
+
+    template <typename Key, typename Value>
+    Value& ConcurrentSkipList<Key, Value>::Assign(const Key& key, Value value) {
+        return Insert(key, std::move(value), true);
+    }
+
+    template <typename Key, typename Value>
+    Value& ConcurrentSkipList<Key, Value>::Assign(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value), true);
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentSkipList<Key, Value>::Pop(const Key& key) {
+        EpochReclaimer::Guard guard;
+
+        Node* preds[MaxHeight];
+        Node* succs[MaxHeight];
+
+        if (!Search(key, preds, succs))
+            return;
+
+        Node* node = succs[0];
+
+        for (int level = node->m_Height - 1; level > 0; --level) {
+            std::uintptr_t link = node->GetLink(level).load(std::memory_order_acquire);
+
+            while (!IsMarked(link) && !node->GetLink(level).compare_exchange_weak(link, link | MarkMask)) {}
+        }
+
+        // marking level 0 removes the key, a Pop that loses the race did nothing
+        std::uintptr_t link = node->GetLink(0).load(std::memory_order_acquire);
+
+        do {
+            if (IsMarked(link))
+                return;
+        } while (!node->GetLink(0).compare_exchange_weak(link, link | MarkMask));
+
+        m_Size.fetch_sub(1, std::memory_order_relaxed);
+
+        Search(key, preds, succs);
+        node->Release();
+    }
+
+    template <typename Key, typename Value>
+    void ConcurrentSkipList<Key, Value>::Clear() {
+        while (true) {
+            EpochReclaimer::Guard guard;
+
+            const Node* node = GetFirst();
+
+            if (!node)
+                return;
+
+            Pop(node->m_Key);
+        }
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    void ConcurrentSkipList<Key, Value>::ForEach(Function&& function) const {
+        EpochReclaimer::Guard guard;
+
+        for (const auto& [key, value] : *this)
+            function(key, value);
+    }
+
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    Value& ConcurrentSkipList<Key, Value>::Insert(KeyArg&& key, Value&& value, bool isAssign) {
+        EpochReclaimer::Guard guard;
+
+        Node* preds[MaxHeight];
+        Node* succs[MaxHeight];
+
+        Value* pointer = nullptr;
+        Node*  node    = nullptr;
+
+        while (true) {
+            // once the node exists the key has been moved into it
+            if (Search(node ? node->m_Key : key, preds, succs)) {
+                if (node) {
+                    node->m_Value.store(nullptr, std::memory_order_relaxed);
+                    Node::Destroy(node);
+                }
+
+                if (!isAssign) {
+                    delete pointer;
+
+                    return *succs[0]->m_Value.load(std::memory_order_acquire);
+                }
+
+                if (!pointer)
+                    pointer = new Value(std::move(value));
+
+                EpochReclaimer::Retire(succs[0]->m_Value.exchange(pointer, std::memory_order_acq_rel));
+
+                return *pointer;
+            }
+
+            if (!node) {
+                pointer = new Value(std::move(value));
+                node    = Node::Create(std::forward<KeyArg>(key), pointer, GetRandomHeight());
+            }
+
+            for (int level = 0; level < node->m_Height; ++level)
+                node->GetLink(level).store(ToLink(succs[level]), std::memory_order_relaxed);
+
+            std::uintptr_t expected = ToLink(succs[0]);
+
+            // linking level 0 publishes the key
+            if (GetLink(preds[0], 0).compare_exchange_strong(expected, ToLink(node)))
+                break;
+        }
+
+        m_Size.fetch_add(1, std::memory_order_relaxed);
+
+        // The upper levels are shortcuts, a concurrent Pop stops the tower by
+        // marking the link this thread is about to set.
+        bool isRemoved = false;
+
+        for (int level = 1; level < node->m_Height && !isRemoved; ++level) {
+            while (true) {
+                std::uintptr_t link = node->GetLink(level).load(std::memory_order_acquire);
+
+                if (IsMarked(link) || (ToNode(link) != succs[level] && !node->GetLink(level).compare_exchange_strong(link, ToLink(succs[level])))) {
+                    isRemoved = true;
+                    break;
+                }
+
+                std::uintptr_t expected = ToLink(succs[level]);
+
+                if (GetLink(preds[level], level).compare_exchange_strong(expected, ToLink(node)))
+                    break;
+
+                Search(node->m_Key, preds, succs);
+
+                if (IsMarked(node->GetLink(0).load(std::memory_order_acquire))) {
+                    isRemoved = true;
+                    break;
+                }
+            }
+        }
+
+        // a Pop that finished its cleanup before the last level went in left
+        // the node reachable there
+        if (IsMarked(node->GetLink(0).load(std::memory_order_seq_cst)))
+            Search(node->m_Key, preds, succs);
+
+        node->Release();
+
+        return *pointer;
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentSkipList<Key, Value>::Search(const Key& key, Node** preds, Node** succs) {
+        bool isFound = false;
+
+        while (!TrySearch(key, preds, succs, isFound)) {}
+
+        return isFound;
+    }
+
+    template <typename Key, typename Value>
+    bool ConcurrentSkipList<Key, Value>::TrySearch(const Key& key, Node** preds, Node** succs, bool& isFound) {
+        Node* pred = nullptr;
+
+        for (int level = MaxHeight - 1; level >= 0; --level) {
+            Node* node = ToNode(GetLink(pred, level).load(std::memory_order_acquire));
+
+            while (node) {
+                const std::uintptr_t next = node->GetLink(level).load(std::memory_order_acquire);
+
+                // a removed node is unlinked before it is passed, a failed
+                // unlink means pred changed under the search
+                if (IsMarked(next)) {
+                    std::uintptr_t expected = ToLink(node);
+
+                    if (!GetLink(pred, level).compare_exchange_strong(expected, next & ~MarkMask))
+                        return false;
+
+                    node = ToNode(next);
+                    continue;
+                }
+
+                if (!(key > node->m_Key))
+                    break;
+
+                pred = node;
+                node = ToNode(next);
+            }
+
+            preds[level] = pred;
+            succs[level] = node;
+        }
+
+        isFound = succs[0] && !(succs[0]->m_Key > key);
+
+        return true;
+    }
+
+    template <typename Key, typename Value>
+    const typename ConcurrentSkipList<Key, Value>::Node* ConcurrentSkipList<Key, Value>::FindNode(const Key& key) const {
+        // removed nodes are stepped over but never used to drop a level
+        const Node* pred = nullptr;
+        const Node* node = nullptr;
+
+        for (int level = MaxHeight - 1; level >= 0; --level) {
+            node = ToNode(GetLink(pred, level).load(std::memory_order_acquire));
+
+            while (node) {
+                const std::uintptr_t next = node->GetLink(level).load(std::memory_order_acquire);
+
+                if (!IsMarked(next)) {
+                    if (!(key > node->m_Key))
+                        break;
+
+                    pred = node;
+                }
+
+                node = ToNode(next);
+            }
+        }
+
+        return node && !(node->m_Key > key) ? node : nullptr;
+    }
+
+    template <typename Key, typename Value>
+    const typename ConcurrentSkipList<Key, Value>::Node* ConcurrentSkipList<Key, Value>::GetFirst() const {
+        return SkipRemoved(ToNode(m_Head[0].load(std::memory_order_acquire)));
+    }
+
+    template <typename Key, typename Value>
+    const typename ConcurrentSkipList<Key, Value>::Node* ConcurrentSkipList<Key, Value>::SkipRemoved(const Node* node) {
+        while (node) {
+            const std::uintptr_t next = node->GetLink(0).load(std::memory_order_acquire);
+
+            if (!IsMarked(next))
+                break;
+
+            node = ToNode(next);
+        }
+
+        return node;
+    }
+
+    template <typename Key, typename Value>
+    int ConcurrentSkipList<Key, Value>::GetRandomHeight() {
+        // xorshift64*, seeded per thread from the address of its state
+        thread_local std::uint64_t state = reinterpret_cast<std::uintptr_t>(&state) * 0x9E3779B97F4A7C15ull | 1;
+
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+
+        // the high half is the better one, each pair of bits promotes a quarter
+        std::uint64_t random = (state * 0x2545F4914F6CDD1Dull) >> 32;
+        int           height = 1;
+
+        while (height < MaxHeight && (random & 3) == 0) {
+            ++height;
+            random >>= 2;
+        }
+
+        return height;
+    }
+
+} // namespace DataStructures
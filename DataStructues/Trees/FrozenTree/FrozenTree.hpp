@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DataStructures {
+
+    // Immutable snapshot of a tree in Eytzinger order: the keys sit in one array
+    // laid out like a binary heap, the children of k at 2k + 1 and 2k + 2, with
+    // the values in a parallel array. A search is a branch-free descent over
+    // that array without pointers. The 16 descendants four levels down are
+    // contiguous, so they are prefetched while the current level is compared.
+    template <typename Key, typename Value>
+    class FrozenTree {
+    public:
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const Key&, const Value&>;
+
+            struct pointer {
+                reference Pair;
+
+                inline reference* operator ->() { return &Pair; }
+            };
+
+            explicit ConstIterator(const FrozenTree* tree = nullptr, std::size_t index = 0);
+
+            [[nodiscard]] inline reference operator *() const { return { m_Tree->m_Keys[m_Index], m_Tree->m_Values[m_Index] }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+        private:
+            const FrozenTree* m_Tree;
+            std::size_t       m_Index;
+
+        }; // class ConstIterator
+
+        FrozenTree() = default;
+
+        // Copies pairs sorted by strictly increasing key in O(n).
+        template <typename ForwardIterator>
+        [[nodiscard]] static FrozenTree FromSorted(ForwardIterator first, ForwardIterator last);
+
+        [[nodiscard]] inline bool IsEmpty() const { return m_Keys.empty(); }
+        [[nodiscard]] inline int GetSize() const { return static_cast<int>(m_Keys.size()); }
+
+        [[nodiscard]] int GetHeight() const;
+        [[nodiscard]] bool IsExists(const Key& key) const;
+
+        [[nodiscard]] const Value& GetMin() const;
+        [[nodiscard]] const Value& GetMax() const;
+        [[nodiscard]] const Value& Get(const Key& key) const;
+
+        [[nodiscard]] ConstIterator Find(const Key& key) const;
+        [[nodiscard]] ConstIterator LowerBound(const Key& key) const;
+
+        [[nodiscard]] ConstIterator begin() const { return ConstIterator(this, GetFirst()); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(this, m_Keys.size()); }
+
+        [[nodiscard]] ConstIterator cbegin() const { return ConstIterator(this, GetFirst()); }
+        [[nodiscard]] ConstIterator cend() const { return ConstIterator(this, m_Keys.size()); }
+
+    private:
+        [[nodiscard]] std::size_t GetFirst() const;
+        [[nodiscard]] std::size_t GetLast() const;
+        [[nodiscard]] std::size_t GetLowerBound(const Key& key) const;
+        [[nodiscard]] std::size_t GetIndex(const Key& key) const;
+
+        static std::size_t Layout(std::vector<std::size_t>& ranks, std::size_t index, std::size_t rank);
+
+    private:
+        std::vector<Key>   m_Keys;
+        std::vector<Value> m_Values;
+
+    }; // class FrozenTree
+
+} // namespace DataStructures
+
+#include "FrozenTree.inl"
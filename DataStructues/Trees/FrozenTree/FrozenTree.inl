@@ -0,0 +1,207 @@
+#include <algorithm>
+
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class FrozenTree::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    FrozenTree<Key, Value>::ConstIterator::ConstIterator(const FrozenTree* tree, std::size_t index)
+        : m_Tree(tree)
+        , m_Index(index) {}
+
+    template <typename Key, typename Value>
+    typename FrozenTree<Key, Value>::ConstIterator& FrozenTree<Key, Value>::ConstIterator::operator ++() {
+        const std::size_t count = m_Tree->m_Keys.size();
+
+        // the successor is the leftmost slot of the right subtree, or the first
+        // ancestor reached from a left child
+        if (2 * m_Index + 2 < count) {
+            m_Index = 2 * m_Index + 2;
+
+            while (2 * m_Index + 1 < count)
+                m_Index = 2 * m_Index + 1;
+
+            return *this;
+        }
+
+        while (m_Index > 0 && m_Index % 2 == 0)
+            m_Index = (m_Index - 1) / 2;
+
+        m_Index = m_Index == 0 ? count : (m_Index - 1) / 2;
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename FrozenTree<Key, Value>::ConstIterator FrozenTree<Key, Value>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value>
+    bool FrozenTree<Key, Value>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Tree == other.m_Tree && m_Index == other.m_Index;
+    }
+
+    template <typename Key, typename Value>
+    bool FrozenTree<Key, Value>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class FrozenTree
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    template <typename ForwardIterator>
+    FrozenTree<Key, Value> FrozenTree<Key, Value>::FromSorted(ForwardIterator first, ForwardIterator last) {
+        const auto isNotIncreasing = [](const auto& lhs, const auto& rhs) { return !(rhs.first > lhs.first); };
+
+        if (std::adjacent_find(first, last, isNotIncreasing) != last)
+            throw std::invalid_argument("Ng::FrozenTree::FromSorted: keys are not strictly increasing!");
+
+        std::vector<ForwardIterator> positions;
+
+        for (ForwardIterator it = first; it != last; ++it)
+            positions.push_back(it);
+
+        std::vector<std::size_t> ranks(positions.size());
+
+        Layout(ranks, 0, 0);
+
+        FrozenTree tree;
+
+        tree.m_Keys.reserve(positions.size());
+        tree.m_Values.reserve(positions.size());
+
+        for (std::size_t rank : ranks) {
+            const auto& pair = *positions[rank];
+
+            tree.m_Keys.push_back(pair.first);
+            tree.m_Values.push_back(pair.second);
+        }
+
+        return tree;
+    }
+
+    template <typename Key, typename Value>
+    int FrozenTree<Key, Value>::GetHeight() const {
+        int height = 0;
+
+        for (std::size_t count = m_Keys.size(); count > 0; count /= 2)
+            ++height;
+
+        return height;
+    }
+
+    template <typename Key, typename Value>
+    bool FrozenTree<Key, Value>::IsExists(const Key& key) const {
+        return GetIndex(key) != m_Keys.size();
+    }
+
+    template <typename Key, typename Value>
+    const Value& FrozenTree<Key, Value>::GetMin() const {
+        if (m_Keys.empty())
+            throw std::out_of_range("Ng::FrozenTree::GetMin: tree is empty!");
+
+        return m_Values[GetFirst()];
+    }
+
+    template <typename Key, typename Value>
+    const Value& FrozenTree<Key, Value>::GetMax() const {
+        if (m_Keys.empty())
+            throw std::out_of_range("Ng::FrozenTree::GetMax: tree is empty!");
+
+        return m_Values[GetLast()];
+    }
+
+    template <typename Key, typename Value>
+    const Value& FrozenTree<Key, Value>::Get(const Key& key) const {
+        const std::size_t index = GetIndex(key);
+
+        if (index == m_Keys.size())
+            throw std::out_of_range("Ng::FrozenTree::Get: key is not exists!");
+
+        return m_Values[index];
+    }
+
+    template <typename Key, typename Value>
+    typename FrozenTree<Key, Value>::ConstIterator FrozenTree<Key, Value>::Find(const Key& key) const {
+        return ConstIterator(this, GetIndex(key));
+    }
+
+    template <typename Key, typename Value>
+    typename FrozenTree<Key, Value>::ConstIterator FrozenTree<Key, Value>::LowerBound(const Key& key) const {
+        return ConstIterator(this, GetLowerBound(key));
+    }
+
+    template <typename Key, typename Value>
+    std::size_t FrozenTree<Key, Value>::GetFirst() const {
+        std::size_t index = 0;
+
+        while (2 * index + 1 < m_Keys.size())
+            index = 2 * index + 1;
+
+        return m_Keys.empty() ? 0 : index;
+    }
+
+    template <typename Key, typename Value>
+    std::size_t FrozenTree<Key, Value>::GetLast() const {
+        std::size_t index = 0;
+
+        while (2 * index + 2 < m_Keys.size())
+            index = 2 * index + 2;
+
+        return index;
+    }
+
+    template <typename Key, typename Value>
+    std::size_t FrozenTree<Key, Value>::GetLowerBound(const Key& key) const {
+        const Key*        keys  = m_Keys.data();
+        const std::size_t count = m_Keys.size();
+
+        std::size_t index = 0;
+
+        while (index < count) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(keys + std::min(16 * index + 15, count - 1));
+#endif
+            index = 2 * index + 1 + (key > keys[index] ? 1 : 0);
+        }
+
+        // In one-based numbering every step appended a bit, 1 for a right turn.
+        // Dropping the trailing right turns and the last left turn leaves the
+        // slot where the search went left for the last time, the lower bound.
+        std::size_t path = index + 1;
+
+        while (path & 1)
+            path >>= 1;
+
+        path >>= 1;
+
+        return path == 0 ? count : path - 1;
+    }
+
+    template <typename Key, typename Value>
+    std::size_t FrozenTree<Key, Value>::GetIndex(const Key& key) const {
+        const std::size_t index = GetLowerBound(key);
+
+        return index != m_Keys.size() && !(m_Keys[index] > key) ? index : m_Keys.size();
+    }
+
+    template <typename Key, typename Value>
+    std::size_t FrozenTree<Key, Value>::Layout(std::vector<std::size_t>& ranks, std::size_t index, std::size_t rank) {
+        // an in-order walk of the implicit tree hands out ranks in sorted order
+        if (index >= ranks.size())
+            return rank;
+
+        rank = Layout(ranks, 2 * index + 1, rank);
+
+        ranks[index] = rank++;
+
+        return Layout(ranks, 2 * index + 2, rank);
+    }
+
+} // namespace DataStructures
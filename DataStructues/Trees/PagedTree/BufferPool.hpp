@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "PageFile.hpp"
+
+namespace DataStructures {
+
+    // Caches the pages of a PageFile in a fixed number of frames, as many as fit
+    // the memory budget. A page stays in its frame while a Handle pins it;
+    // unpinned frames are reused in CLOCK order: the hand passes over frames
+    // used since its last visit once, clearing their reference bit, and takes
+    // the first frame it finds unused. A dirty page is written back when its
+    // frame is taken and on WriteBack, never synced; the owner decides when.
+    //
+    // Not thread-safe, like the trees it serves.
+    class BufferPool {
+    public:
+        using PageId = PageFile::PageId;
+
+        // page 0 never goes through the pool, it marks a free frame
+        static constexpr PageId InvalidPage = 0;
+
+        // enough frames for the pages a tree operation pins at once
+        static constexpr std::size_t MinFrameCount = 8;
+
+        struct Statistics {
+            std::size_t   FrameCount = 0;
+            std::uint64_t HitCount   = 0;
+            std::uint64_t MissCount  = 0;
+            std::uint64_t WriteCount = 0;
+        };
+
+        // Pins a page for as long as it lives, copies pin it once more. A
+        // handle that outlives a Discard is stale: it no longer pins anything
+        // and must not be read through.
+        class Handle {
+        public:
+            Handle() = default;
+
+            Handle(const Handle& other)
+                : m_Pool(other.m_Pool)
+                , m_Frame(other.m_Frame)
+                , m_Generation(other.m_Generation) {
+                if (IsPinning())
+                    ++m_Pool->m_Frames[m_Frame].PinCount;
+            }
+
+            Handle(Handle&& other) noexcept
+                : m_Pool(std::exchange(other.m_Pool, nullptr))
+                , m_Frame(other.m_Frame)
+                , m_Generation(other.m_Generation) {}
+
+            ~Handle() {
+                Reset();
+            }
+
+            Handle& operator =(const Handle& other) {
+                Handle copy(other);
+
+                return *this = std::move(copy);
+            }
+
+            Handle& operator =(Handle&& other) noexcept {
+                if (this == &other)
+                    return *this;
+
+                Reset();
+
+                m_Pool       = std::exchange(other.m_Pool, nullptr);
+                m_Frame      = other.m_Frame;
+                m_Generation = other.m_Generation;
+
+                return *this;
+            }
+
+            [[nodiscard]] inline bool IsValid() const { return m_Pool != nullptr; }
+            [[nodiscard]] inline BufferPool* GetPool() const { return m_Pool; }
+            [[nodiscard]] inline PageId GetId() const { return m_Pool ? m_Pool->m_Frames[m_Frame].Id : InvalidPage; }
+            [[nodiscard]] inline unsigned char* GetData() const { return m_Pool->GetFrameData(m_Frame); }
+
+            // the page is written back before its frame is reused
+            inline void MarkDirty() const { m_Pool->m_Frames[m_Frame].IsDirty = true; }
+
+            void Reset() {
+                if (IsPinning())
+                    --m_Pool->m_Frames[m_Frame].PinCount;
+
+                m_Pool = nullptr;
+            }
+
+            friend class BufferPool;
+
+        private:
+            Handle(BufferPool* pool, std::size_t frame)
+                : m_Pool(pool)
+                , m_Frame(frame)
+                , m_Generation(pool->m_Generation) {
+                ++m_Pool->m_Frames[m_Frame].PinCount;
+            }
+
+            [[nodiscard]] inline bool IsPinning() const { return m_Pool && m_Generation == m_Pool->m_Generation; }
+
+        private:
+            BufferPool*   m_Pool       = nullptr;
+            std::size_t   m_Frame      = 0;
+            std::uint64_t m_Generation = 0;
+
+        }; // class Handle
+
+        BufferPool(PageFile& file, std::size_t memoryBudget)
+            : m_File(file)
+            , m_PageSize(file.GetPageSize())
+            , m_Frames(std::max(MinFrameCount, memoryBudget / m_PageSize))
+            , m_Memory(static_cast<unsigned char*>(::operator new(m_Frames.size() * m_PageSize, std::align_val_t(FrameAlignment)))) {
+            m_Table.reserve(m_Frames.size());
+        }
+
+        BufferPool(const BufferPool& other) = delete;
+
+        BufferPool& operator =(const BufferPool& other) = delete;
+
+        [[nodiscard]] inline std::size_t GetPageSize() const { return m_PageSize; }
+
+        [[nodiscard]] Statistics GetStatistics() const {
+            Statistics statistics;
+
+            statistics.FrameCount = m_Frames.size();
+            statistics.HitCount   = m_HitCount;
+            statistics.MissCount  = m_MissCount;
+            statistics.WriteCount = m_WriteCount;
+
+            return statistics;
+        }
+
+        // Pins page id, reading it from the file unless it is cached.
+        [[nodiscard]] Handle Fetch(PageId id) {
+            if (const auto it = m_Table.find(id); it != m_Table.end()) {
+                m_Frames[it->second].IsReferenced = true;
+                ++m_HitCount;
+
+                return Handle(this, it->second);
+            }
+
+            const std::size_t frame = Evict();
+
+            m_File.Read(id, GetFrameData(frame));
+
+            ++m_MissCount;
+
+            return Install(id, frame);
+        }
+
+        // Pins a page that is not in the file yet. It starts zeroed and dirty.
+        [[nodiscard]] Handle Create(PageId id) {
+            const std::size_t frame = Evict();
+
+            std::memset(GetFrameData(frame), 0, m_PageSize);
+
+            Handle handle = Install(id, frame);
+
+            m_Frames[frame].IsDirty = true;
+
+            return handle;
+        }
+
+        // Writes every dirty page to the file, in page order.
+        void WriteBack() {
+            std::vector<std::size_t> frames;
+
+            for (std::size_t frame = 0; frame < m_Frames.size(); ++frame)
+                if (m_Frames[frame].IsDirty)
+                    frames.push_back(frame);
+
+            std::sort(frames.begin(), frames.end(), [this](std::size_t lhs, std::size_t rhs) { return m_Frames[rhs].Id > m_Frames[lhs].Id; });
+
+            for (std::size_t frame : frames)
+                Write(frame);
+        }
+
+        // Forgets every page without writing it back. Handles still pinning a
+        // frame, like those of iterators left over from before, turn stale and
+        // let go of it without touching its new pin count.
+        void Discard() {
+            for (Frame& frame : m_Frames)
+                frame = Frame();
+
+            m_Table.clear();
+
+            ++m_Generation;
+        }
+
+    private:
+        struct Frame {
+            PageId Id           = InvalidPage;
+            int    PinCount     = 0;
+            bool   IsDirty      = false;
+            bool   IsReferenced = false;
+        };
+
+        struct AlignedDelete {
+            void operator ()(unsigned char* memory) const { ::operator delete(memory, std::align_val_t(FrameAlignment)); }
+        };
+
+        static constexpr std::size_t FrameAlignment = 4096;
+
+        [[nodiscard]] inline unsigned char* GetFrameData(std::size_t frame) const { return m_Memory.get() + frame * m_PageSize; }
+
+        // One turn of the hand clears every reference bit, so two turns that
+        // find nothing mean every frame is pinned.
+        [[nodiscard]] std::size_t Evict() {
+            for (std::size_t step = 0; step < 2 * m_Frames.size(); ++step) {
+                const std::size_t frame = m_Hand;
+
+                m_Hand = (m_Hand + 1) % m_Frames.size();
+
+                Frame& current = m_Frames[frame];
+
+                if (current.PinCount > 0)
+                    continue;
+
+                if (current.IsReferenced) {
+                    current.IsReferenced = false;
+                    continue;
+                }
+
+                if (current.IsDirty)
+                    Write(frame);
+
+                // the entry of the page is kept for the next one, a miss allocates nothing
+                if (current.Id != InvalidPage)
+                    m_SpareEntry = m_Table.extract(current.Id);
+
+                current = Frame();
+
+                return frame;
+            }
+
+            throw std::runtime_error("Ng::BufferPool::Evict: every frame is pinned!");
+        }
+
+        Handle Install(PageId id, std::size_t frame) {
+            m_Frames[frame].Id           = id;
+            m_Frames[frame].IsReferenced = true;
+
+            if (m_SpareEntry) {
+                m_SpareEntry.key()    = id;
+                m_SpareEntry.mapped() = frame;
+
+                m_Table.insert(std::move(m_SpareEntry));
+            } else {
+                m_Table.emplace(id, frame);
+            }
+
+            return Handle(this, frame);
+        }
+
+        void Write(std::size_t frame) {
+            m_File.Write(m_Frames[frame].Id, GetFrameData(frame));
+
+            m_Frames[frame].IsDirty = false;
+
+            ++m_WriteCount;
+        }
+
+    private:
+        PageFile&                                          m_File;
+        std::size_t                                        m_PageSize;
+        std::vector<Frame>                                 m_Frames;
+        std::unique_ptr<unsigned char, AlignedDelete>      m_Memory;
+        std::unordered_map<PageId, std::size_t>            m_Table;
+        std::unordered_map<PageId, std::size_t>::node_type m_SpareEntry;
+        std::size_t                                        m_Hand       = 0;
+        std::uint64_t                                      m_Generation = 0;
+        std::uint64_t                                      m_HitCount   = 0;
+        std::uint64_t                                      m_MissCount  = 0;
+        std::uint64_t                                      m_WriteCount = 0;
+
+    }; // class BufferPool
+
+} // namespace DataStructures
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DATA_STRUCTURES_HAS_POSIX_IO
+#endif
+
+namespace DataStructures {
+
+    // A file of fixed-size pages, read and written a whole page at a time at
+    // offset id * page size. The file is created if it does not exist. Sync
+    // returns once everything written so far is on stable storage; where POSIX
+    // I/O is not available the file goes through a std::fstream and Sync only
+    // flushes it.
+    //
+    // The last ChecksumSize bytes of a page belong to the file: Write puts the
+    // CRC-32 of the rest of the page there and Read checks it, so a page torn
+    // by a crash in the middle of a write, or damaged otherwise, throws instead
+    // of being read as it is.
+    class PageFile {
+    public:
+        using PageId = std::uint64_t;
+
+        static constexpr std::size_t ChecksumSize = sizeof(std::uint32_t);
+
+        PageFile(const std::string& path, std::size_t pageSize)
+            : m_Path(path)
+            , m_PageSize(pageSize)
+            , m_Buffer(pageSize) {
+            if (pageSize <= ChecksumSize)
+                throw std::invalid_argument("Ng::PageFile::PageFile: page size leaves no room for the checksum!");
+
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            m_Descriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+            if (m_Descriptor < 0)
+                throw std::runtime_error("Ng::PageFile::PageFile: cannot open " + path + "!");
+#else
+            // in | out does not create a missing file, out alone does
+            if (!std::filesystem::exists(path))
+                std::ofstream(path, std::ios::binary);
+
+            m_Stream.open(path, std::ios::binary | std::ios::in | std::ios::out);
+
+            if (!m_Stream)
+                throw std::runtime_error("Ng::PageFile::PageFile: cannot open " + path + "!");
+#endif
+        }
+
+        PageFile(const PageFile& other) = delete;
+
+        ~PageFile() {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            ::close(m_Descriptor);
+#endif
+        }
+
+        PageFile& operator =(const PageFile& other) = delete;
+
+        [[nodiscard]] inline const std::string& GetPath() const { return m_Path; }
+        [[nodiscard]] inline std::size_t GetPageSize() const { return m_PageSize; }
+        // the bytes of a page left to its owner
+        [[nodiscard]] inline std::size_t GetDataSize() const { return m_PageSize - ChecksumSize; }
+
+        [[nodiscard]] PageId GetPageCount() {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            struct stat status {};
+
+            if (::fstat(m_Descriptor, &status) != 0)
+                throw std::runtime_error("Ng::PageFile::GetPageCount: cannot stat " + m_Path + "!");
+
+            return static_cast<PageId>(status.st_size) / m_PageSize;
+#else
+            m_Stream.seekg(0, std::ios::end);
+
+            return static_cast<PageId>(m_Stream.tellg()) / m_PageSize;
+#endif
+        }
+
+        void Read(PageId id, void* data) {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            auto*       bytes  = static_cast<char*>(data);
+            std::size_t offset = 0;
+
+            // pread may stop short of a page, only 0 means the page is not there
+            while (offset < m_PageSize) {
+                const ssize_t count = ::pread(m_Descriptor, bytes + offset, m_PageSize - offset, GetOffset(id) + static_cast<off_t>(offset));
+
+                if (count <= 0)
+                    throw std::runtime_error("Ng::PageFile::Read: cannot read page " + std::to_string(id) + " of " + m_Path + "!");
+
+                offset += static_cast<std::size_t>(count);
+            }
+#else
+            m_Stream.seekg(static_cast<std::streamoff>(id * m_PageSize));
+
+            if (!m_Stream.read(static_cast<char*>(data), static_cast<std::streamsize>(m_PageSize)))
+                throw std::runtime_error("Ng::PageFile::Read: cannot read page " + std::to_string(id) + " of " + m_Path + "!");
+#endif
+
+            std::uint32_t checksum = 0;
+
+            std::memcpy(&checksum, static_cast<const unsigned char*>(data) + GetDataSize(), ChecksumSize);
+
+            if (checksum != GetChecksum(data, GetDataSize()))
+                throw std::runtime_error("Ng::PageFile::Read: page " + std::to_string(id) + " of " + m_Path + " is torn or damaged!");
+        }
+
+        // The last ChecksumSize bytes of data are not written, the checksum
+        // takes their place.
+        void Write(PageId id, const void* data) {
+            const std::uint32_t checksum = GetChecksum(data, GetDataSize());
+
+            // the page goes out with its checksum in one write, not two
+            std::memcpy(m_Buffer.data(), data, GetDataSize());
+            std::memcpy(m_Buffer.data() + GetDataSize(), &checksum, ChecksumSize);
+
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            const auto* bytes  = reinterpret_cast<const char*>(m_Buffer.data());
+            std::size_t offset = 0;
+
+            while (offset < m_PageSize) {
+                const ssize_t count = ::pwrite(m_Descriptor, bytes + offset, m_PageSize - offset, GetOffset(id) + static_cast<off_t>(offset));
+
+                if (count <= 0)
+                    throw std::runtime_error("Ng::PageFile::Write: cannot write page " + std::to_string(id) + " of " + m_Path + "!");
+
+                offset += static_cast<std::size_t>(count);
+            }
+#else
+            m_Stream.seekp(static_cast<std::streamoff>(id * m_PageSize));
+
+            if (!m_Stream.write(reinterpret_cast<const char*>(m_Buffer.data()), static_cast<std::streamsize>(m_PageSize)))
+                throw std::runtime_error("Ng::PageFile::Write: cannot write page " + std::to_string(id) + " of " + m_Path + "!");
+#endif
+        }
+
+        void Sync() {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            if (::fsync(m_Descriptor) != 0)
+                throw std::runtime_error("Ng::PageFile::Sync: cannot sync " + m_Path + "!");
+#else
+            if (!m_Stream.flush())
+                throw std::runtime_error("Ng::PageFile::Sync: cannot flush " + m_Path + "!");
+#endif
+        }
+
+        // Cuts the file down to its first count pages.
+        void Truncate(PageId count) {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+            if (::ftruncate(m_Descriptor, GetOffset(count)) != 0)
+                throw std::runtime_error("Ng::PageFile::Truncate: cannot truncate " + m_Path + "!");
+#else
+            m_Stream.flush();
+            std::filesystem::resize_file(m_Path, count * m_PageSize);
+#endif
+        }
+
+        // CRC-32 as in zlib and PNG
+        [[nodiscard]] static std::uint32_t GetChecksum(const void* data, std::size_t size) {
+            static constexpr std::array<std::uint32_t, 256> Table = [] {
+                std::array<std::uint32_t, 256> table {};
+
+                for (std::uint32_t i = 0; i < 256; ++i) {
+                    std::uint32_t value = i;
+
+                    for (int bit = 0; bit < 8; ++bit)
+                        value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+
+                    table[i] = value;
+                }
+
+                return table;
+            }();
+
+            const auto*   bytes    = static_cast<const unsigned char*>(data);
+            std::uint32_t checksum = 0xFFFFFFFFu;
+
+            for (std::size_t i = 0; i < size; ++i)
+                checksum = Table[(checksum ^ bytes[i]) & 0xFF] ^ (checksum >> 8);
+
+            return ~checksum;
+        }
+
+    private:
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+        [[nodiscard]] inline off_t GetOffset(PageId id) const { return static_cast<off_t>(id * m_PageSize); }
+#endif
+
+    private:
+        std::string                m_Path;
+        std::size_t                m_PageSize;
+        std::vector<unsigned char> m_Buffer;
+
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+        int m_Descriptor = -1;
+#else
+        std::fstream m_Stream;
+#endif
+
+    }; // class PageFile
+
+} // namespace DataStructures
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../Common/ITree.hpp"
+#include "../Common/KeySearch.hpp"
+
+#include "BufferPool.hpp"
+#include "PageFile.hpp"
+
+namespace DataStructures {
+
+    // B+ tree kept in a file of PageSize pages, of which only a BufferPool of
+    // memoryBudget bytes is in memory at a time, so the tree can be far larger
+    // than RAM. Pairs sit in the leaves, which are chained in key order; the
+    // internal pages hold separator keys and child page ids. A lookup touches
+    // one page per level and the height grows with log base ~PageSize / (key
+    // size + 8) of the size: 8-byte keys and values in 4 KiB pages take 4 levels
+    // for about a billion keys.
+    //
+    // Splits on the way down keep every page on the path below capacity and
+    // merges or borrowing keep it above half, so an update never walks back up
+    // and pins at most four pages at once. Freed pages are reused before the
+    // file grows.
+    //
+    // Changed pages are written back when the pool evicts them and on Flush,
+    // which then writes the header page and syncs the file; the destructor
+    // flushes too. Pages are updated in place without a log, so only a tree
+    // flushed since its last change survives a crash intact; what a crash does
+    // leave behind is caught by the page checksums of PageFile, which throw
+    // std::runtime_error on reading a torn page rather than handing it out.
+    //
+    // Keys and values are stored byte for byte and have to be trivially
+    // copyable. Lookups copy values out of the pool. The reference Push returns
+    // stays valid until the next Push, Pop, Clear or Flush.
+    template <typename Key, typename Value, std::size_t PageSize = 4096>
+    class PagedTree : public ITree<Key, Value> {
+    public:
+        static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+                      "Ng::PagedTree: keys and values are stored byte for byte and have to be trivially copyable!");
+
+        using PageId = BufferPool::PageId;
+
+    private:
+        // the checksum at the end of a page is left to PageFile
+        static constexpr std::size_t DataSize = PageSize - PageFile::ChecksumSize;
+
+        struct PageHeader {
+            std::uint32_t IsLeaf;
+            std::uint32_t Count;
+            PageId        Next;
+        };
+
+        static constexpr std::size_t KeysOffset = (sizeof(PageHeader) + alignof(Key) - 1) / alignof(Key) * alignof(Key);
+
+    public:
+        // version 2 ends every page with a checksum
+        static constexpr std::uint32_t FormatVersion       = 2;
+        static constexpr std::size_t   DefaultMemoryBudget = std::size_t(64) << 20;
+
+        // the capacities leave room for the padding in front of the second array
+        static constexpr int LeafCapacity     = static_cast<int>((DataSize - KeysOffset - alignof(Value) + 1) / (sizeof(Key) + sizeof(Value)));
+        static constexpr int InternalCapacity = static_cast<int>((DataSize - KeysOffset - alignof(PageId) + 1 - sizeof(PageId)) / (sizeof(Key) + sizeof(PageId)));
+
+        // a merge puts two pages at the minimum and, in an internal page, their
+        // separator together, which has to fit
+        static constexpr int MinLeafCount     = LeafCapacity / 2;
+        static constexpr int MinInternalCount = (InternalCapacity - 1) / 2;
+
+        static_assert(LeafCapacity >= 4 && InternalCapacity >= 4, "Ng::PagedTree: PageSize is too small for Key and Value!");
+
+    private:
+        static constexpr std::size_t ValuesOffset   = (KeysOffset + LeafCapacity * sizeof(Key) + alignof(Value) - 1) / alignof(Value) * alignof(Value);
+        static constexpr std::size_t ChildrenOffset = (KeysOffset + InternalCapacity * sizeof(Key) + alignof(PageId) - 1) / alignof(PageId) * alignof(PageId);
+
+        // A pinned page seen as a node: the header, then the keys and either the
+        // values or the child ids.
+        class Page {
+        public:
+            Page() = default;
+            explicit Page(BufferPool::Handle handle);
+
+            [[nodiscard]] inline bool IsValid() const { return m_Handle.IsValid(); }
+            [[nodiscard]] inline PageId GetId() const { return m_Handle.GetId(); }
+            [[nodiscard]] inline BufferPool* GetPool() const { return m_Handle.GetPool(); }
+
+            [[nodiscard]] inline bool IsLeaf() const { return GetHeader().IsLeaf != 0; }
+            [[nodiscard]] inline int GetCount() const { return static_cast<int>(GetHeader().Count); }
+            [[nodiscard]] inline PageId GetNext() const { return GetHeader().Next; }
+            [[nodiscard]] inline int GetCapacity() const { return IsLeaf() ? LeafCapacity : InternalCapacity; }
+            [[nodiscard]] inline int GetMinCount() const { return IsLeaf() ? MinLeafCount : MinInternalCount; }
+
+            [[nodiscard]] Key* GetKeys() const;
+            [[nodiscard]] Value* GetValues() const;
+            [[nodiscard]] PageId* GetChildren() const;
+
+            // the setters mark the page dirty, writes through the arrays do not
+            void Initialize(bool isLeaf);
+            void SetCount(int count);
+            void SetNext(PageId next);
+            inline void MarkDirty() const { m_Handle.MarkDirty(); }
+
+        private:
+            [[nodiscard]] PageHeader& GetHeader() const;
+
+        private:
+            BufferPool::Handle m_Handle;
+
+        }; // class Page
+
+    public:
+        // Walks the leaf chain with the current leaf pinned, handing out pairs by
+        // value. Any change to the tree invalidates iterators, which may then
+        // only be assigned to or destroyed.
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            struct pointer {
+                value_type Pair;
+
+                inline value_type* operator ->() { return &Pair; }
+            };
+
+            ConstIterator() = default;
+
+            [[nodiscard]] inline reference operator *() const { return { m_Page.GetKeys()[m_Index], m_Page.GetValues()[m_Index] }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+            friend class PagedTree;
+
+        private:
+            ConstIterator(Page page, int index);
+
+            void SkipEmpty();
+
+        private:
+            Page m_Page;
+            int  m_Index = 0;
+
+        }; // class ConstIterator
+
+        // Opens the tree in the file at path or starts an empty one there. Throws
+        // std::runtime_error for a file of another format, version, page size or
+        // key and value type.
+        explicit PagedTree(const std::string& path, std::size_t memoryBudget = DefaultMemoryBudget);
+        PagedTree(const PagedTree& other) = delete;
+        ~PagedTree() override;
+
+        PagedTree& operator =(const PagedTree& other) = delete;
+
+        [[nodiscard]] inline bool IsEmpty() const override { return m_Meta.Size == 0; }
+        [[nodiscard]] inline int GetSize() const override { return static_cast<int>(m_Meta.Size); }
+        // GetSize is an int for ITree, this one counts past 2^31 pairs
+        [[nodiscard]] inline std::uint64_t GetPairCount() const { return m_Meta.Size; }
+        [[nodiscard]] inline int GetHeight() const override { return static_cast<int>(m_Meta.Height); }
+        [[nodiscard]] inline BufferPool::Statistics GetStatistics() const { return m_Pool.GetStatistics(); }
+
+        [[nodiscard]] bool IsExists(const Key& key) const override;
+        [[nodiscard]] std::optional<Value> Find(const Key& key) const;
+        [[nodiscard]] Value Get(const Key& key) const;
+
+        // Like the other trees Push keeps the value of a key that is already there.
+        Value& Push(const Key& key, Value value) override;
+        Value& Push(Key&& key, Value value) override;
+        void Pop(const Key& key) override;
+
+        void Clear();
+
+        // Writes the changed pages back, then the header page, syncing the file
+        // after each, so the header never points at pages not on disk yet.
+        void Flush();
+
+        [[nodiscard]] ConstIterator begin() const;
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(); }
+
+    private:
+        struct Meta {
+            char          Magic[8];
+            std::uint32_t Version;
+            std::uint32_t ByteOrder;
+            std::uint32_t PageBytes;
+            std::uint32_t KeySize;
+            std::uint32_t ValueSize;
+            std::uint32_t Height;
+            PageId        Root;
+            PageId        PageCount;
+            PageId        FreePage;
+            std::uint64_t Size;
+        };
+
+        static_assert(sizeof(Meta) <= DataSize);
+
+        static constexpr char          Magic[8]      = { 'N', 'g', 'P', 'a', 'g', 'e', 'd', '\0' };
+        static constexpr std::uint32_t ByteOrderMark = 0x01020304;
+        static constexpr PageId        MetaPage      = 0;
+
+        [[nodiscard]] static int LowerBound(const Page& page, const Key& key);
+        [[nodiscard]] static int GetChildIndex(const Page& page, const Key& key);
+
+        [[nodiscard]] Page Fetch(PageId id) const;
+        [[nodiscard]] Page Allocate(bool isLeaf);
+        void Free(Page& page);
+
+        void Initialize();
+        void Load();
+
+        [[nodiscard]] Page FindLeaf(const Key& key) const;
+
+        void SplitChild(Page& parent, int index, Page& child);
+
+        // Brings the child at index of parent above its minimum before a removal
+        // descends into it and returns the page to descend into instead.
+        [[nodiscard]] Page Refill(Page& parent, int index, Page child);
+        void BorrowFromLeft(Page& parent, int index, Page& left, Page& child);
+        void BorrowFromRight(Page& parent, int index, Page& child, Page& right);
+        void Merge(Page& parent, int index, Page& left, Page& right);
+
+        template <typename T>
+        static void InsertAt(T* items, int count, int index, const T& item);
+        template <typename T>
+        static void EraseAt(T* items, int count, int index);
+
+    private:
+        PageFile           m_File;
+        mutable BufferPool m_Pool;
+        Meta               m_Meta;
+        Page               m_Pinned;
+
+    }; // class PagedTree
+
+} // namespace DataStructures
+
+#include "PagedTree.inl"
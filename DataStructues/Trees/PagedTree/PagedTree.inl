@@ -0,0 +1,548 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PagedTree::Page
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t PageSize>
+    PagedTree<Key, Value, PageSize>::Page::Page(BufferPool::Handle handle)
+        : m_Handle(std::move(handle)) {}
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    Key* PagedTree<Key, Value, PageSize>::Page::GetKeys() const {
+        return std::launder(reinterpret_cast<Key*>(m_Handle.GetData() + KeysOffset));
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    Value* PagedTree<Key, Value, PageSize>::Page::GetValues() const {
+        return std::launder(reinterpret_cast<Value*>(m_Handle.GetData() + ValuesOffset));
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::PageId* PagedTree<Key, Value, PageSize>::Page::GetChildren() const {
+        return std::launder(reinterpret_cast<PageId*>(m_Handle.GetData() + ChildrenOffset));
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Page::Initialize(bool isLeaf) {
+        GetHeader() = { isLeaf ? 1u : 0u, 0, 0 };
+
+        m_Handle.MarkDirty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Page::SetCount(int count) {
+        GetHeader().Count = static_cast<std::uint32_t>(count);
+
+        m_Handle.MarkDirty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Page::SetNext(PageId next) {
+        GetHeader().Next = next;
+
+        m_Handle.MarkDirty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::PageHeader& PagedTree<Key, Value, PageSize>::Page::GetHeader() const {
+        return *std::launder(reinterpret_cast<PageHeader*>(m_Handle.GetData()));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PagedTree::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t PageSize>
+    PagedTree<Key, Value, PageSize>::ConstIterator::ConstIterator(Page page, int index)
+        : m_Page(std::move(page))
+        , m_Index(index) {
+        SkipEmpty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::ConstIterator& PagedTree<Key, Value, PageSize>::ConstIterator::operator ++() {
+        ++m_Index;
+
+        SkipEmpty();
+
+        return *this;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::ConstIterator PagedTree<Key, Value, PageSize>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    bool PagedTree<Key, Value, PageSize>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Page.GetId() == other.m_Page.GetId() && m_Index == other.m_Index;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    bool PagedTree<Key, Value, PageSize>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::ConstIterator::SkipEmpty() {
+        // only an empty root leaf has no pairs, the end has no page
+        while (m_Page.IsValid() && m_Index == m_Page.GetCount()) {
+            const PageId next = m_Page.GetNext();
+
+            m_Page  = next != 0 ? Page(m_Page.GetPool()->Fetch(next)) : Page();
+            m_Index = 0;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PagedTree
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value, std::size_t PageSize>
+    PagedTree<Key, Value, PageSize>::PagedTree(const std::string& path, std::size_t memoryBudget)
+        : m_File(path, PageSize)
+        , m_Pool(m_File, memoryBudget)
+        , m_Meta() {
+        if (m_File.GetPageCount() == 0)
+            Initialize();
+        else
+            Load();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    PagedTree<Key, Value, PageSize>::~PagedTree() {
+        // a destructor cannot report a failed write, call Flush first to see it
+        try {
+            Flush();
+        } catch (...) {}
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    bool PagedTree<Key, Value, PageSize>::IsExists(const Key& key) const {
+        const Page leaf  = FindLeaf(key);
+        const int  index = LowerBound(leaf, key);
+
+        return index != leaf.GetCount() && !(leaf.GetKeys()[index] > key);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    std::optional<Value> PagedTree<Key, Value, PageSize>::Find(const Key& key) const {
+        const Page leaf  = FindLeaf(key);
+        const int  index = LowerBound(leaf, key);
+
+        if (index == leaf.GetCount() || leaf.GetKeys()[index] > key)
+            return std::nullopt;
+
+        return leaf.GetValues()[index];
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    Value PagedTree<Key, Value, PageSize>::Get(const Key& key) const {
+        std::optional<Value> value = Find(key);
+
+        if (!value)
+            throw std::out_of_range("Ng::PagedTree::Get: key is not exists!");
+
+        return *value;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    Value& PagedTree<Key, Value, PageSize>::Push(const Key& key, Value value) {
+        m_Pinned = Page();
+
+        Page page = Fetch(m_Meta.Root);
+
+        // a full root splits under a new one, the only way the tree grows taller
+        if (page.GetCount() == page.GetCapacity()) {
+            Page root = Allocate(false);
+
+            root.GetChildren()[0] = page.GetId();
+
+            SplitChild(root, 0, page);
+
+            m_Meta.Root = root.GetId();
+            ++m_Meta.Height;
+
+            page = std::move(root);
+        }
+
+        while (!page.IsLeaf()) {
+            const int index = GetChildIndex(page, key);
+
+            Page child = Fetch(page.GetChildren()[index]);
+
+            if (child.GetCount() == child.GetCapacity()) {
+                SplitChild(page, index, child);
+
+                if (!(page.GetKeys()[index] > key))
+                    child = Fetch(page.GetChildren()[index + 1]);
+            }
+
+            page = std::move(child);
+        }
+
+        const int count = page.GetCount();
+        const int index = LowerBound(page, key);
+
+        if (index == count || page.GetKeys()[index] > key) {
+            InsertAt(page.GetKeys(), count, index, key);
+            InsertAt(page.GetValues(), count, index, value);
+
+            page.SetCount(count + 1);
+
+            ++m_Meta.Size;
+        }
+
+        // the value may be changed through the reference
+        page.MarkDirty();
+
+        m_Pinned = std::move(page);
+
+        return m_Pinned.GetValues()[index];
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    Value& PagedTree<Key, Value, PageSize>::Push(Key&& key, Value value) {
+        return Push(static_cast<const Key&>(key), std::move(value));
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Pop(const Key& key) {
+        // A missing key would restructure the path for nothing. On the way down
+        // every child is topped up above its minimum before the descent enters
+        // it, so the leaf can give up a pair without walking back up.
+        if (!IsExists(key))
+            return;
+
+        m_Pinned = Page();
+
+        Page page = Fetch(m_Meta.Root);
+
+        while (!page.IsLeaf()) {
+            const int index = GetChildIndex(page, key);
+
+            Page child = Fetch(page.GetChildren()[index]);
+
+            if (child.GetCount() <= child.GetMinCount())
+                child = Refill(page, index, std::move(child));
+
+            // a merge took the last key of the root, its only child takes over
+            if (page.GetCount() == 0) {
+                m_Meta.Root = child.GetId();
+                --m_Meta.Height;
+
+                Free(page);
+            }
+
+            page = std::move(child);
+        }
+
+        const int count = page.GetCount();
+        const int index = LowerBound(page, key);
+
+        EraseAt(page.GetKeys(), count, index);
+        EraseAt(page.GetValues(), count, index);
+
+        page.SetCount(count - 1);
+
+        --m_Meta.Size;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Clear() {
+        m_Pinned = Page();
+
+        m_Pool.Discard();
+        m_File.Truncate(0);
+
+        Initialize();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Flush() {
+        m_Pinned = Page();
+
+        m_Pool.WriteBack();
+        m_File.Sync();
+
+        std::vector<unsigned char> page(PageSize);
+
+        std::memcpy(page.data(), &m_Meta, sizeof(Meta));
+
+        m_File.Write(MetaPage, page.data());
+        m_File.Sync();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::ConstIterator PagedTree<Key, Value, PageSize>::begin() const {
+        Page page = Fetch(m_Meta.Root);
+
+        while (!page.IsLeaf())
+            page = Fetch(page.GetChildren()[0]);
+
+        return ConstIterator(std::move(page), 0);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    int PagedTree<Key, Value, PageSize>::LowerBound(const Page& page, const Key& key) {
+        return KeySearch<Key>::LowerBound(page.GetKeys(), page.GetCount(), key);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    int PagedTree<Key, Value, PageSize>::GetChildIndex(const Page& page, const Key& key) {
+        // a separator is the least key of the subtree on its right
+        const int index = LowerBound(page, key);
+
+        return index != page.GetCount() && !(page.GetKeys()[index] > key) ? index + 1 : index;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::Page PagedTree<Key, Value, PageSize>::Fetch(PageId id) const {
+        return Page(m_Pool.Fetch(id));
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::Page PagedTree<Key, Value, PageSize>::Allocate(bool isLeaf) {
+        Page page;
+
+        // free pages are chained through their next links
+        if (m_Meta.FreePage != 0) {
+            page = Fetch(m_Meta.FreePage);
+
+            m_Meta.FreePage = page.GetNext();
+        } else {
+            page = Page(m_Pool.Create(m_Meta.PageCount++));
+        }
+
+        page.Initialize(isLeaf);
+
+        return page;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Free(Page& page) {
+        page.SetCount(0);
+        page.SetNext(m_Meta.FreePage);
+
+        m_Meta.FreePage = page.GetId();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Initialize() {
+        m_Meta = Meta();
+
+        std::memcpy(m_Meta.Magic, Magic, sizeof(Magic));
+
+        m_Meta.Version   = FormatVersion;
+        m_Meta.ByteOrder = ByteOrderMark;
+        m_Meta.PageBytes = static_cast<std::uint32_t>(PageSize);
+        m_Meta.KeySize   = static_cast<std::uint32_t>(sizeof(Key));
+        m_Meta.ValueSize = static_cast<std::uint32_t>(sizeof(Value));
+        m_Meta.Height    = 1;
+        m_Meta.PageCount = MetaPage + 1;
+        m_Meta.Root      = Allocate(true).GetId();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Load() {
+        const std::string& path = m_File.GetPath();
+
+        std::vector<unsigned char> page(PageSize);
+
+        m_File.Read(MetaPage, page.data());
+
+        std::memcpy(&m_Meta, page.data(), sizeof(Meta));
+
+        if (std::memcmp(m_Meta.Magic, Magic, sizeof(Magic)) != 0)
+            throw std::runtime_error("Ng::PagedTree::PagedTree: " + path + " is not a paged tree!");
+
+        if (m_Meta.Version != FormatVersion)
+            throw std::runtime_error("Ng::PagedTree::PagedTree: " + path + " has format version " + std::to_string(m_Meta.Version) + "!");
+
+        if (m_Meta.ByteOrder != ByteOrderMark)
+            throw std::runtime_error("Ng::PagedTree::PagedTree: " + path + " was written with another byte order!");
+
+        if (m_Meta.PageBytes != PageSize)
+            throw std::runtime_error("Ng::PagedTree::PagedTree: " + path + " has pages of another size!");
+
+        if (m_Meta.KeySize != sizeof(Key) || m_Meta.ValueSize != sizeof(Value))
+            throw std::runtime_error("Ng::PagedTree::PagedTree: " + path + " holds keys or values of another size!");
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::Page PagedTree<Key, Value, PageSize>::FindLeaf(const Key& key) const {
+        Page page = Fetch(m_Meta.Root);
+
+        while (!page.IsLeaf())
+            page = Fetch(page.GetChildren()[GetChildIndex(page, key)]);
+
+        return page;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::SplitChild(Page& parent, int index, Page& child) {
+        // A leaf hands its upper half to the sibling and a copy of the first key
+        // moved up to the parent, an internal page moves its middle key up.
+        Page sibling = Allocate(child.IsLeaf());
+
+        const int count = child.GetCount();
+        const int half  = count / 2;
+
+        if (child.IsLeaf()) {
+            std::copy(child.GetKeys() + half, child.GetKeys() + count, sibling.GetKeys());
+            std::copy(child.GetValues() + half, child.GetValues() + count, sibling.GetValues());
+
+            sibling.SetCount(count - half);
+            sibling.SetNext(child.GetNext());
+
+            child.SetCount(half);
+            child.SetNext(sibling.GetId());
+        } else {
+            std::copy(child.GetKeys() + half + 1, child.GetKeys() + count, sibling.GetKeys());
+            std::copy(child.GetChildren() + half + 1, child.GetChildren() + count + 1, sibling.GetChildren());
+
+            sibling.SetCount(count - half - 1);
+
+            child.SetCount(half);
+        }
+
+        const Key& separator = child.IsLeaf() ? sibling.GetKeys()[0] : child.GetKeys()[half];
+
+        InsertAt(parent.GetKeys(), parent.GetCount(), index, separator);
+        InsertAt(parent.GetChildren(), parent.GetCount() + 1, index + 1, sibling.GetId());
+
+        parent.SetCount(parent.GetCount() + 1);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    typename PagedTree<Key, Value, PageSize>::Page PagedTree<Key, Value, PageSize>::Refill(Page& parent, int index, Page child) {
+        // borrow from a sibling above its minimum, otherwise merge with one
+        if (index > 0) {
+            Page left = Fetch(parent.GetChildren()[index - 1]);
+
+            if (left.GetCount() > left.GetMinCount()) {
+                BorrowFromLeft(parent, index, left, child);
+                return child;
+            }
+
+            if (index == parent.GetCount()) {
+                Merge(parent, index - 1, left, child);
+                return left;
+            }
+        }
+
+        Page right = Fetch(parent.GetChildren()[index + 1]);
+
+        if (right.GetCount() > right.GetMinCount())
+            BorrowFromRight(parent, index, child, right);
+        else
+            Merge(parent, index, child, right);
+
+        return child;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::BorrowFromLeft(Page& parent, int index, Page& left, Page& child) {
+        const int leftCount  = left.GetCount();
+        const int childCount = child.GetCount();
+
+        Key& separator = parent.GetKeys()[index - 1];
+
+        if (child.IsLeaf()) {
+            InsertAt(child.GetKeys(), childCount, 0, left.GetKeys()[leftCount - 1]);
+            InsertAt(child.GetValues(), childCount, 0, left.GetValues()[leftCount - 1]);
+
+            separator = child.GetKeys()[0];
+        } else {
+            InsertAt(child.GetKeys(), childCount, 0, separator);
+            InsertAt(child.GetChildren(), childCount + 1, 0, left.GetChildren()[leftCount]);
+
+            separator = left.GetKeys()[leftCount - 1];
+        }
+
+        child.SetCount(childCount + 1);
+        left.SetCount(leftCount - 1);
+        parent.MarkDirty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::BorrowFromRight(Page& parent, int index, Page& child, Page& right) {
+        const int childCount = child.GetCount();
+        const int rightCount = right.GetCount();
+
+        Key& separator = parent.GetKeys()[index];
+
+        if (child.IsLeaf()) {
+            child.GetKeys()[childCount]   = right.GetKeys()[0];
+            child.GetValues()[childCount] = right.GetValues()[0];
+
+            EraseAt(right.GetKeys(), rightCount, 0);
+            EraseAt(right.GetValues(), rightCount, 0);
+
+            separator = right.GetKeys()[0];
+        } else {
+            child.GetKeys()[childCount]         = separator;
+            child.GetChildren()[childCount + 1] = right.GetChildren()[0];
+
+            separator = right.GetKeys()[0];
+
+            EraseAt(right.GetKeys(), rightCount, 0);
+            EraseAt(right.GetChildren(), rightCount + 1, 0);
+        }
+
+        child.SetCount(childCount + 1);
+        right.SetCount(rightCount - 1);
+        parent.MarkDirty();
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    void PagedTree<Key, Value, PageSize>::Merge(Page& parent, int index, Page& left, Page& right) {
+        // right, the child after index, moves into left and its page is freed
+        const int leftCount   = left.GetCount();
+        const int rightCount  = right.GetCount();
+        const int parentCount = parent.GetCount();
+
+        if (left.IsLeaf()) {
+            std::copy(right.GetKeys(), right.GetKeys() + rightCount, left.GetKeys() + leftCount);
+            std::copy(right.GetValues(), right.GetValues() + rightCount, left.GetValues() + leftCount);
+
+            left.SetCount(leftCount + rightCount);
+            left.SetNext(right.GetNext());
+        } else {
+            left.GetKeys()[leftCount] = parent.GetKeys()[index];
+
+            std::copy(right.GetKeys(), right.GetKeys() + rightCount, left.GetKeys() + leftCount + 1);
+            std::copy(right.GetChildren(), right.GetChildren() + rightCount + 1, left.GetChildren() + leftCount + 1);
+
+            left.SetCount(leftCount + rightCount + 1);
+        }
+
+        EraseAt(parent.GetKeys(), parentCount, index);
+        EraseAt(parent.GetChildren(), parentCount + 1, index + 1);
+
+        parent.SetCount(parentCount - 1);
+
+        Free(right);
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    template <typename T>
+    void PagedTree<Key, Value, PageSize>::InsertAt(T* items, int count, int index, const T& item) {
+        std::copy_backward(items + index, items + count, items + count + 1);
+
+        items[index] = item;
+    }
+
+    template <typename Key, typename Value, std::size_t PageSize>
+    template <typename T>
+    void PagedTree<Key, Value, PageSize>::EraseAt(T* items, int count, int index) {
+        std::copy(items + index + 1, items + count, items + index);
+    }
+
+} // namespace DataStructures
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "../Common/EpochReclaimer.hpp"
+
+namespace DataStructures {
+
+    // Red-black tree whose versions share structure. Nodes never change once
+    // they are reachable from a published root: Push and Pop copy the O(log n)
+    // nodes on the search path and link the copies to the untouched subtrees,
+    // so Snapshot is O(1) and a View stays the same however the tree changes.
+    //
+    // Nodes are reference counted and freed with the last version that reaches
+    // them. A root replaced while a Snapshot on another thread may be about to
+    // share it is released through the EpochReclaimer, so Snapshot runs next
+    // to the writer without a lock.
+    // Push, Pop, Clear and the lookups on the tree itself need one writer at a
+    // time, like RedBlackTree. Other threads read through Views, which are
+    // read-only and may be shared.
+    //
+    // The rebalancing follows the insertion and deletion of Kahrs, as verified
+    // in the MSets library of Coq. Nodes created by the same update are not
+    // reachable yet and are restructured in place instead of copied again.
+    template <typename Key, typename Value>
+    class PersistentRedBlackTree {
+    private:
+        class Node;
+
+    public:
+        using Pair = std::pair<const Key, Value>;
+
+        // In-order walk with an explicit stack, nodes have no parent links.
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Pair;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Pair*;
+            using reference         = const Pair&;
+
+            // 2 * log2(n + 1) bounds the height, so this covers any int size
+            static constexpr int MaxHeight = 64;
+
+            ConstIterator() = default;
+
+            [[nodiscard]] inline const Pair& operator *() const { return m_Stack[m_Depth - 1]->m_Pair; }
+            [[nodiscard]] inline const Pair* operator ->() const { return &m_Stack[m_Depth - 1]->m_Pair; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+            friend class PersistentRedBlackTree;
+
+        private:
+            void PushLeftSpine(const Node* node);
+
+        private:
+            const Node* m_Stack[MaxHeight] {};
+            int         m_Depth = 0;
+
+        }; // class ConstIterator
+
+        // A point-in-time version of the tree. It holds a reference to its root
+        // and keeps every node of that version alive until it is destroyed.
+        class View {
+        public:
+            View();
+            View(const View& other);
+            View(View&& other) noexcept;
+            ~View();
+
+            View& operator =(const View& other);
+            View& operator =(View&& other) noexcept;
+
+            [[nodiscard]] inline bool IsEmpty() const { return !m_Root; }
+            [[nodiscard]] int GetSize() const;
+            [[nodiscard]] int GetHeight() const;
+
+            [[nodiscard]] bool IsExists(const Key& key) const;
+            [[nodiscard]] const Value& Get(const Key& key) const;
+            [[nodiscard]] ConstIterator Find(const Key& key) const;
+
+            template <typename Function>
+            void ForEach(Function&& function) const;
+
+            [[nodiscard]] ConstIterator begin() const { return PersistentRedBlackTree::GetBegin(m_Root); }
+            [[nodiscard]] ConstIterator end() const { return ConstIterator(); }
+
+            friend class PersistentRedBlackTree;
+
+        private:
+            explicit View(const Node* root);
+
+        private:
+            const Node* m_Root;
+
+        }; // class View
+
+        PersistentRedBlackTree();
+        // Copies share every node with other and take O(1).
+        PersistentRedBlackTree(const PersistentRedBlackTree& other);
+        PersistentRedBlackTree(PersistentRedBlackTree&& other) noexcept;
+        ~PersistentRedBlackTree();
+
+        PersistentRedBlackTree& operator =(const PersistentRedBlackTree& other);
+        PersistentRedBlackTree& operator =(PersistentRedBlackTree&& other) noexcept;
+
+        [[nodiscard]] View Snapshot() const;
+
+        [[nodiscard]] inline bool IsEmpty() const { return !GetRoot(); }
+        [[nodiscard]] int GetSize() const;
+        [[nodiscard]] int GetHeight() const;
+
+        [[nodiscard]] bool IsExists(const Key& key) const;
+        [[nodiscard]] const Value& Get(const Key& key) const;
+        [[nodiscard]] ConstIterator Find(const Key& key) const;
+
+        // Values are shared with the views, so there is no mutable access. Like
+        // RedBlackTree Push keeps the value of a key that is already there.
+        // Push returns whether the key was new, Pop whether the key was there.
+        bool Push(const Key& key, Value value);
+        bool Push(Key&& key, Value value);
+        bool Pop(const Key& key);
+
+        void Clear();
+
+        [[nodiscard]] ConstIterator begin() const { return GetBegin(GetRoot()); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(); }
+
+    private:
+        enum class Color : int {
+            Red = 0,
+            Black
+        };
+
+        class Node {
+        public:
+            template <typename... Args>
+            explicit Node(Args&&... args);
+
+            const Pair               m_Pair;
+            Node*                    m_Left;
+            Node*                    m_Right;
+            int                      m_Size;
+            Color                    m_Color;
+            mutable std::atomic<int> m_ReferenceCount;
+
+        }; // class Node
+
+        // The children of a node taken apart by Open. Middle is a node without
+        // children of its own, reused or copied, for Make to put together again.
+        struct Parts {
+            Node* Left;
+            Node* Middle;
+            Node* Right;
+        };
+
+        [[nodiscard]] inline const Node* GetRoot() const { return m_Root.load(std::memory_order_relaxed); }
+
+        template <typename KeyArg>
+        bool Insert(KeyArg&& key, Value&& value);
+        void Publish(Node* root);
+
+        // The functions below consume the references to the nodes they are
+        // passed and return a reference of their own; the const Node* ones
+        // only borrow from the published version. InsertNode returns nullptr
+        // when key is there already, RemoveNode reports a missing key.
+        template <typename KeyArg>
+        [[nodiscard]] static Node* InsertNode(const Node* node, KeyArg&& key, Value&& value);
+        [[nodiscard]] static Node* RemoveNode(const Node* node, const Key& key, bool& isRemoved);
+        [[nodiscard]] static Node* Append(Node* left, Node* right);
+
+        [[nodiscard]] static Node* BalanceLeft(Node* left, Node* middle, Node* right);
+        [[nodiscard]] static Node* BalanceRight(Node* left, Node* middle, Node* right);
+        [[nodiscard]] static Node* BalanceLeftShrunk(Node* left, Node* middle, Node* right);
+        [[nodiscard]] static Node* BalanceRightShrunk(Node* left, Node* middle, Node* right);
+
+        [[nodiscard]] static Parts Open(Node* node);
+        [[nodiscard]] static Node* Make(Color color, Node* left, Node* middle, Node* right);
+        [[nodiscard]] static Node* Paint(Node* node, Color color);
+        [[nodiscard]] static Node* Copy(const Node* node);
+
+        [[nodiscard]] static inline bool IsRed(const Node* node) { return node && node->m_Color == Color::Red; }
+        [[nodiscard]] static inline bool IsBlack(const Node* node) { return node && node->m_Color == Color::Black; }
+        [[nodiscard]] static inline int GetSubtreeSize(const Node* node) { return node ? node->m_Size : 0; }
+
+        [[nodiscard]] static Node* Share(const Node* node);
+        static void Release(const Node* node);
+
+        [[nodiscard]] static const Node* FindNode(const Node* root, const Key& key);
+        [[nodiscard]] static int GetHeight(const Node* node);
+        [[nodiscard]] static ConstIterator GetBegin(const Node* root);
+        [[nodiscard]] static ConstIterator GetIterator(const Node* root, const Key& key);
+
+        template <typename Function>
+        static void ForEach(const Node* node, Function& function);
+
+    private:
+        std::atomic<Node*>       m_Root;
+        mutable std::atomic<int> m_SharingCount;
+
+    }; // class PersistentRedBlackTree
+
+} // namespace DataStructures
+
+#include "PersistentRedBlackTree.inl"
@@ -0,0 +1,597 @@
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PersistentRedBlackTree::Node
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    template <typename... Args>
+    PersistentRedBlackTree<Key, Value>::Node::Node(Args&&... args)
+        : m_Pair(std::forward<Args>(args)...)
+        , m_Left(nullptr)
+        , m_Right(nullptr)
+        , m_Size(1)
+        , m_Color(Color::Red)
+        , m_ReferenceCount(1) {}
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PersistentRedBlackTree::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator& PersistentRedBlackTree<Key, Value>::ConstIterator::operator ++() {
+        const Node* node = m_Stack[--m_Depth];
+
+        PushLeftSpine(node->m_Right);
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator PersistentRedBlackTree<Key, Value>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::ConstIterator::operator ==(const ConstIterator& other) const {
+        if (m_Depth == 0 || other.m_Depth == 0)
+            return m_Depth == other.m_Depth;
+
+        return m_Stack[m_Depth - 1] == other.m_Stack[other.m_Depth - 1];
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    template <typename Key, typename Value>
+    void PersistentRedBlackTree<Key, Value>::ConstIterator::PushLeftSpine(const Node* node) {
+        for (; node; node = node->m_Left)
+            m_Stack[m_Depth++] = node;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PersistentRedBlackTree::View
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::View::View()
+        : m_Root(nullptr) {}
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::View::View(const View& other)
+        : m_Root(Share(other.m_Root)) {}
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::View::View(View&& other) noexcept
+        : m_Root(std::exchange(other.m_Root, nullptr)) {}
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::View::~View() {
+        Release(m_Root);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::View& PersistentRedBlackTree<Key, Value>::View::operator =(const View& other) {
+        const Node* root = Share(other.m_Root);
+
+        Release(m_Root);
+        m_Root = root;
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::View& PersistentRedBlackTree<Key, Value>::View::operator =(View&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Release(m_Root);
+        m_Root = std::exchange(other.m_Root, nullptr);
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    int PersistentRedBlackTree<Key, Value>::View::GetSize() const {
+        return GetSubtreeSize(m_Root);
+    }
+
+    template <typename Key, typename Value>
+    int PersistentRedBlackTree<Key, Value>::View::GetHeight() const {
+        return PersistentRedBlackTree::GetHeight(m_Root);
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::View::IsExists(const Key& key) const {
+        return FindNode(m_Root, key) != nullptr;
+    }
+
+    template <typename Key, typename Value>
+    const Value& PersistentRedBlackTree<Key, Value>::View::Get(const Key& key) const {
+        const Node* node = FindNode(m_Root, key);
+
+        if (!node)
+            throw std::out_of_range("Ng::PersistentRedBlackTree::View::Get: key is not exists!");
+
+        return node->m_Pair.second;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator PersistentRedBlackTree<Key, Value>::View::Find(const Key& key) const {
+        return GetIterator(m_Root, key);
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    void PersistentRedBlackTree<Key, Value>::View::ForEach(Function&& function) const {
+        PersistentRedBlackTree::ForEach(m_Root, function);
+    }
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::View::View(const Node* root)
+        : m_Root(root) {}
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class PersistentRedBlackTree
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::PersistentRedBlackTree()
+        : m_Root(nullptr)
+        , m_SharingCount(0) {}
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::PersistentRedBlackTree(const PersistentRedBlackTree& other)
+        : m_Root(nullptr)
+        , m_SharingCount(0) {
+        View view = other.Snapshot();
+
+        m_Root.store(const_cast<Node*>(std::exchange(view.m_Root, nullptr)), std::memory_order_relaxed);
+    }
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::PersistentRedBlackTree(PersistentRedBlackTree&& other) noexcept
+        : m_Root(other.m_Root.exchange(nullptr, std::memory_order_relaxed))
+        , m_SharingCount(0) {}
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>::~PersistentRedBlackTree() {
+        Release(GetRoot());
+    }
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>& PersistentRedBlackTree<Key, Value>::operator =(const PersistentRedBlackTree& other) {
+        View view = other.Snapshot();
+
+        Publish(const_cast<Node*>(std::exchange(view.m_Root, nullptr)));
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    PersistentRedBlackTree<Key, Value>& PersistentRedBlackTree<Key, Value>::operator =(PersistentRedBlackTree&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Publish(other.m_Root.exchange(nullptr, std::memory_order_relaxed));
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::View PersistentRedBlackTree<Key, Value>::Snapshot() const {
+        // the guard keeps a root the writer replaces meanwhile from being released
+        EpochReclaimer::Guard guard;
+
+        m_SharingCount.fetch_add(1, std::memory_order_seq_cst);
+
+        View view(Share(m_Root.load(std::memory_order_seq_cst)));
+
+        m_SharingCount.fetch_sub(1, std::memory_order_release);
+
+        return view;
+    }
+
+    template <typename Key, typename Value>
+    int PersistentRedBlackTree<Key, Value>::GetSize() const {
+        return GetSubtreeSize(GetRoot());
+    }
+
+    template <typename Key, typename Value>
+    int PersistentRedBlackTree<Key, Value>::GetHeight() const {
+        return GetHeight(GetRoot());
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::IsExists(const Key& key) const {
+        return FindNode(GetRoot(), key) != nullptr;
+    }
+
+    template <typename Key, typename Value>
+    const Value& PersistentRedBlackTree<Key, Value>::Get(const Key& key) const {
+        const Node* node = FindNode(GetRoot(), key);
+
+        if (!node)
+            throw std::out_of_range("Ng::PersistentRedBlackTree::Get: key is not exists!");
+
+        return node->m_Pair.second;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator PersistentRedBlackTree<Key, Value>::Find(const Key& key) const {
+        return GetIterator(GetRoot(), key);
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::Push(const Key& key, Value value) {
+        return Insert(key, std::move(value));
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::Push(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value));
+    }
+
+    template <typename Key, typename Value>
+    bool PersistentRedBlackTree<Key, Value>::Pop(const Key& key) {
+        bool isRemoved = false;
+        Node* root     = RemoveNode(GetRoot(), key, isRemoved);
+
+        if (!isRemoved)
+            return false;
+
+        Publish(Paint(root, Color::Black));
+
+        return true;
+    }
+
+    template <typename Key, typename Value>
+    void PersistentRedBlackTree<Key, Value>::Clear() {
+        Publish(nullptr);
+    }
+
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    bool PersistentRedBlackTree<Key, Value>::Insert(KeyArg&& key, Value&& value) {
+        Node* root = InsertNode(GetRoot(), std::forward<KeyArg>(key), std::move(value));
+
+        if (!root)
+            return false;
+
+        Publish(Paint(root, Color::Black));
+
+        return true;
+    }
+
+    template <typename Key, typename Value>
+    void PersistentRedBlackTree<Key, Value>::Publish(Node* root) {
+        Node* previous = m_Root.exchange(root, std::memory_order_seq_cst);
+
+        if (!previous)
+            return;
+
+        // A Snapshot that is not counted yet loads the new root, so without one
+        // in flight the old version goes right away, while its path is still in
+        // the cache. Otherwise it may have loaded previous and not shared it yet.
+        if (m_SharingCount.load(std::memory_order_seq_cst) == 0)
+            Release(previous);
+        else
+            EpochReclaimer::Retire(previous, [](void* node) { Release(static_cast<Node*>(node)); });
+    }
+
+    template <typename Key, typename Value>
+    template <typename KeyArg>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::InsertNode(const Node* node, KeyArg&& key, Value&& value) {
+        // The path is copied on the way back, so finding the key copies nothing.
+        if (!node)
+            return new Node(std::piecewise_construct, std::forward_as_tuple(std::forward<KeyArg>(key)), std::forward_as_tuple(std::move(value)));
+
+        if (node->m_Pair.first > key) {
+            Node* left = InsertNode(node->m_Left, std::forward<KeyArg>(key), std::move(value));
+
+            if (!left)
+                return nullptr;
+
+            if (node->m_Color == Color::Red)
+                return Make(Color::Red, left, Copy(node), Share(node->m_Right));
+
+            return BalanceLeft(left, Copy(node), Share(node->m_Right));
+        }
+
+        if (key > node->m_Pair.first) {
+            Node* right = InsertNode(node->m_Right, std::forward<KeyArg>(key), std::move(value));
+
+            if (!right)
+                return nullptr;
+
+            if (node->m_Color == Color::Red)
+                return Make(Color::Red, Share(node->m_Left), Copy(node), right);
+
+            return BalanceRight(Share(node->m_Left), Copy(node), right);
+        }
+
+        return nullptr;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::RemoveNode(const Node* node, const Key& key, bool& isRemoved) {
+        // Below a black child the removal may have taken a black node off the
+        // path, the shrunk balances make up for it on the way back.
+        if (!node) {
+            isRemoved = false;
+            return nullptr;
+        }
+
+        if (node->m_Pair.first > key) {
+            Node* left = RemoveNode(node->m_Left, key, isRemoved);
+
+            if (!isRemoved)
+                return nullptr;
+
+            if (IsBlack(node->m_Left))
+                return BalanceLeftShrunk(left, Copy(node), Share(node->m_Right));
+
+            return Make(Color::Red, left, Copy(node), Share(node->m_Right));
+        }
+
+        if (key > node->m_Pair.first) {
+            Node* right = RemoveNode(node->m_Right, key, isRemoved);
+
+            if (!isRemoved)
+                return nullptr;
+
+            if (IsBlack(node->m_Right))
+                return BalanceRightShrunk(Share(node->m_Left), Copy(node), right);
+
+            return Make(Color::Red, Share(node->m_Left), Copy(node), right);
+        }
+
+        isRemoved = true;
+
+        return Append(Share(node->m_Left), Share(node->m_Right));
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::Append(Node* left, Node* right) {
+        // Merges the two subtrees of a removed node, every key of left is less
+        // than every key of right and both have the same black height.
+        if (!left)
+            return right;
+
+        if (!right)
+            return left;
+
+        if (IsBlack(left) && IsRed(right)) {
+            auto [rightLeft, rightMiddle, rightRight] = Open(right);
+
+            return Make(Color::Red, Append(left, rightLeft), rightMiddle, rightRight);
+        }
+
+        if (IsRed(left) && IsBlack(right)) {
+            auto [leftLeft, leftMiddle, leftRight] = Open(left);
+
+            return Make(Color::Red, leftLeft, leftMiddle, Append(leftRight, right));
+        }
+
+        const Color color = left->m_Color;
+
+        auto [leftLeft, leftMiddle, leftRight]    = Open(left);
+        auto [rightLeft, rightMiddle, rightRight] = Open(right);
+
+        Node* inner = Append(leftRight, rightLeft);
+
+        if (IsRed(inner)) {
+            auto [innerLeft, innerMiddle, innerRight] = Open(inner);
+
+            return Make(Color::Red, Make(color, leftLeft, leftMiddle, innerLeft), innerMiddle, Make(color, innerRight, rightMiddle, rightRight));
+        }
+
+        if (color == Color::Red)
+            return Make(Color::Red, leftLeft, leftMiddle, Make(Color::Red, inner, rightMiddle, rightRight));
+
+        return BalanceLeftShrunk(leftLeft, leftMiddle, Make(Color::Black, inner, rightMiddle, rightRight));
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::BalanceLeft(Node* left, Node* middle, Node* right) {
+        // a red child with a red child of its own on the left becomes the root
+        // of a red node over two black ones
+        if (IsRed(left) && IsRed(left->m_Left)) {
+            auto [leftLeft, leftMiddle, leftRight] = Open(left);
+            auto [a, x, b]                         = Open(leftLeft);
+
+            return Make(Color::Red, Make(Color::Black, a, x, b), leftMiddle, Make(Color::Black, leftRight, middle, right));
+        }
+
+        if (IsRed(left) && IsRed(left->m_Right)) {
+            auto [a, leftMiddle, leftRight] = Open(left);
+            auto [b, y, c]                  = Open(leftRight);
+
+            return Make(Color::Red, Make(Color::Black, a, leftMiddle, b), y, Make(Color::Black, c, middle, right));
+        }
+
+        return Make(Color::Black, left, middle, right);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::BalanceRight(Node* left, Node* middle, Node* right) {
+        if (IsRed(right) && IsRed(right->m_Left)) {
+            auto [rightLeft, rightMiddle, d] = Open(right);
+            auto [b, y, c]                   = Open(rightLeft);
+
+            return Make(Color::Red, Make(Color::Black, left, middle, b), y, Make(Color::Black, c, rightMiddle, d));
+        }
+
+        if (IsRed(right) && IsRed(right->m_Right)) {
+            auto [b, rightMiddle, rightRight] = Open(right);
+            auto [c, z, d]                    = Open(rightRight);
+
+            return Make(Color::Red, Make(Color::Black, left, middle, b), rightMiddle, Make(Color::Black, c, z, d));
+        }
+
+        return Make(Color::Black, left, middle, right);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::BalanceLeftShrunk(Node* left, Node* middle, Node* right) {
+        // left is one black node shorter than right
+        if (IsRed(left))
+            return Make(Color::Red, Paint(left, Color::Black), middle, right);
+
+        if (IsBlack(right))
+            return BalanceRight(left, middle, Paint(right, Color::Red));
+
+        if (IsRed(right) && IsBlack(right->m_Left)) {
+            auto [rightLeft, z, c] = Open(right);
+            auto [a, y, b]         = Open(rightLeft);
+
+            return Make(Color::Red, Make(Color::Black, left, middle, a), y, BalanceRight(b, z, Paint(c, Color::Red)));
+        }
+
+        return Make(Color::Red, left, middle, right);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::BalanceRightShrunk(Node* left, Node* middle, Node* right) {
+        // right is one black node shorter than left
+        if (IsRed(right))
+            return Make(Color::Red, left, middle, Paint(right, Color::Black));
+
+        if (IsBlack(left))
+            return BalanceLeft(Paint(left, Color::Red), middle, right);
+
+        if (IsRed(left) && IsBlack(left->m_Right)) {
+            auto [a, x, leftRight] = Open(left);
+            auto [b, y, c]         = Open(leftRight);
+
+            return Make(Color::Red, BalanceLeft(Paint(a, Color::Red), x, b), y, Make(Color::Black, c, middle, right));
+        }
+
+        return Make(Color::Red, left, middle, right);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Parts PersistentRedBlackTree<Key, Value>::Open(Node* node) {
+        // Nobody else holds a node with a single reference: it was created by
+        // this update and is taken apart in place. Shared nodes are copied.
+        if (node->m_ReferenceCount.load(std::memory_order_acquire) == 1)
+            return { std::exchange(node->m_Left, nullptr), node, std::exchange(node->m_Right, nullptr) };
+
+        Node* middle = Copy(node);
+        Parts parts  = { Share(node->m_Left), middle, Share(node->m_Right) };
+
+        Release(node);
+
+        return parts;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::Make(Color color, Node* left, Node* middle, Node* right) {
+        middle->m_Left  = left;
+        middle->m_Right = right;
+        middle->m_Color = color;
+        middle->m_Size  = GetSubtreeSize(left) + GetSubtreeSize(right) + 1;
+
+        return middle;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::Paint(Node* node, Color color) {
+        if (!node || node->m_Color == color)
+            return node;
+
+        auto [left, middle, right] = Open(node);
+
+        return Make(color, left, middle, right);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::Copy(const Node* node) {
+        return new Node(node->m_Pair);
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::Share(const Node* node) {
+        if (node)
+            node->m_ReferenceCount.fetch_add(1, std::memory_order_relaxed);
+
+        return const_cast<Node*>(node);
+    }
+
+    template <typename Key, typename Value>
+    void PersistentRedBlackTree<Key, Value>::Release(const Node* node) {
+        // recurses on the left and loops on the right, so the depth stays
+        // within the height of the tree
+        while (node && node->m_ReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            const Node* left  = node->m_Left;
+            const Node* right = node->m_Right;
+
+            delete node;
+
+            Release(left);
+
+            node = right;
+        }
+    }
+
+    template <typename Key, typename Value>
+    const typename PersistentRedBlackTree<Key, Value>::Node* PersistentRedBlackTree<Key, Value>::FindNode(const Node* root, const Key& key) {
+        const Node* node = root;
+
+        while (node && (key > node->m_Pair.first || node->m_Pair.first > key))
+            node = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+
+        return node;
+    }
+
+    template <typename Key, typename Value>
+    int PersistentRedBlackTree<Key, Value>::GetHeight(const Node* node) {
+        return node ? std::max(GetHeight(node->m_Left), GetHeight(node->m_Right)) + 1 : 0;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator PersistentRedBlackTree<Key, Value>::GetBegin(const Node* root) {
+        ConstIterator iterator;
+
+        iterator.PushLeftSpine(root);
+
+        return iterator;
+    }
+
+    template <typename Key, typename Value>
+    typename PersistentRedBlackTree<Key, Value>::ConstIterator PersistentRedBlackTree<Key, Value>::GetIterator(const Node* root, const Key& key) {
+        // the stack holds the nodes where the descent went left, they come next
+        ConstIterator iterator;
+
+        for (const Node* node = root; node;) {
+            if (key > node->m_Pair.first || node->m_Pair.first > key) {
+                if (node->m_Pair.first > key) {
+                    iterator.m_Stack[iterator.m_Depth++] = node;
+                    node = node->m_Left;
+                } else {
+                    node = node->m_Right;
+                }
+
+                continue;
+            }
+
+            iterator.m_Stack[iterator.m_Depth++] = node;
+
+            return iterator;
+        }
+
+        return ConstIterator();
+    }
+
+    template <typename Key, typename Value>
+    template <typename Function>
+    void PersistentRedBlackTree<Key, Value>::ForEach(const Node* node, Function& function) {
+        if (!node)
+            return;
+
+        ForEach(node->m_Left, function);
+        function(node->m_Pair.first, node->m_Pair.second);
+        ForEach(node->m_Right, function);
+    }
+
+} // namespace DataStructures
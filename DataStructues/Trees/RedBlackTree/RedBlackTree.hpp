@@ -1,87 +1,365 @@
 #pragma once
 
-#include <optional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../Common/ITree.hpp"
+#include "../Common/InterleavedSearch.hpp"
+#include "../Common/KeyCompare.hpp"
+#include "../Common/NodePool.hpp"
+#include "../Common/SubtreeSize.hpp"
+#include "../Common/SubtreeSummary.hpp"
+#include "../Common/ThreadPool.hpp"
+#include "../FrozenTree/FrozenTree.hpp"
+#include "../TreeImage/TreeImage.hpp"
 
 namespace DataStructures {
 
-    template <typename T>
-    class RedBlackTree {
+    template <typename Key,
+              typename Value,
+              bool HasOrderStatistics = false,
+              typename Monoid = void,
+              template <typename> typename Allocator = NodePool,
+              typename Compare = KeyLess<Key>>
+    class RedBlackTree : public ITree<Key, Value> {
     public:
-        class Node {
+        using Pair    = std::pair<const Key, Value>;
+        using Summary = typename SubtreeSummary<Monoid>::Type;
+
+        // The color lives in the low bit of the parent link, so with 64-bit
+        // pointers a node takes sizeof(Pair) rounded up to 8 bytes plus 24 bytes
+        // (32 bytes for int keys and values).
+        class Node : public SubtreeSize<HasOrderStatistics>, public SubtreeSummary<Monoid> {
         public:
             enum class Color : int { Red = 0, Black };
 
-            Node();
-            explicit Node(const T& value,
-                          Node* parent = nullptr,
-                          Node* left = nullptr,
-                          Node* right = nullptr);
-            virtual ~Node();
+            template <typename... Args>
+            explicit Node(Args&&... args);
 
-            [[nodiscard]] inline const T& GetValue() const { return m_Value; }
-            [[nodiscard]] inline const Color& GetColor() const { return m_Color; }
-            [[nodiscard]] inline const Node* GetParent() const { return m_Parent; }
+            [[nodiscard]] inline const Key& GetKey() const { return m_Pair.first; }
+            [[nodiscard]] inline const Value& GetValue() const { return m_Pair.second; }
+            [[nodiscard]] inline Value& GetValue() { return m_Pair.second; }
+            [[nodiscard]] inline Color GetColor() const { return static_cast<Color>(m_ParentAndColor & ColorMask); }
+            [[nodiscard]] inline const Node* GetParent() const { return reinterpret_cast<const Node*>(m_ParentAndColor & ~ColorMask); }
+            [[nodiscard]] inline Node* GetParent() { return reinterpret_cast<Node*>(m_ParentAndColor & ~ColorMask); }
             [[nodiscard]] inline const Node* GetLeft() const { return m_Left; }
             [[nodiscard]] inline const Node* GetRight() const { return m_Right; }
 
             friend class RedBlackTree;
 
         private:
-            void Print() const;
+            static constexpr std::uintptr_t ColorMask = 1;
+
+            inline void SetParent(Node* parent) {
+                m_ParentAndColor = reinterpret_cast<std::uintptr_t>(parent) | (m_ParentAndColor & ColorMask);
+            }
+
+            inline void SetColor(Color color) {
+                m_ParentAndColor = (m_ParentAndColor & ~ColorMask) | static_cast<std::uintptr_t>(color);
+            }
+
+            void Print(std::ostream& ostream) const;
 
         private:
-            T     m_Value;
-            Color m_Color;
-            Node* m_Parent;
-            Node* m_Left;
-            Node* m_Right;
+            Pair           m_Pair;
+            std::uintptr_t m_ParentAndColor;
+            Node*          m_Left;
+            Node*          m_Right;
 
         }; // class Node
 
-        explicit RedBlackTree(const T& value);
-        explicit RedBlackTree(Node* root = nullptr);
-        virtual ~RedBlackTree();
+        class Iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = Pair;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = Pair*;
+            using reference         = Pair&;
+
+            explicit Iterator(Node* node = nullptr, const RedBlackTree* tree = nullptr);
+
+            [[nodiscard]] inline Pair& operator *() const { return m_Node->m_Pair; }
+            [[nodiscard]] inline Pair* operator ->() const { return &m_Node->m_Pair; }
+
+            Iterator& operator ++();
+            Iterator operator ++(int);
+            Iterator& operator --();
+            Iterator operator --(int);
+            Iterator& operator +=(int n);
+
+            bool operator ==(const Iterator& other) const;
+            bool operator !=(const Iterator& other) const;
+
+        private:
+            Node*               m_Node;
+            const RedBlackTree* m_Tree;
+
+        }; // class Iterator
+
+        class ConstIterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = Pair;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Pair*;
+            using reference         = const Pair&;
+
+            explicit ConstIterator(Node* node = nullptr, const RedBlackTree* tree = nullptr);
 
-        [[nodiscard]] inline bool IsEmpty() const  { return m_Size == 0; }
+            [[nodiscard]] inline const Pair& operator *() const { return m_Node->m_Pair; }
+            [[nodiscard]] inline const Pair* operator ->() const { return &m_Node->m_Pair; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+            ConstIterator& operator --();
+            ConstIterator operator --(int);
+            ConstIterator& operator +=(int n);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+        private:
+            Node*               m_Node;
+            const RedBlackTree* m_Tree;
+
+        }; // class ConstIterator
+
+        RedBlackTree();
+        explicit RedBlackTree(const Compare& compare);
+        RedBlackTree(const RedBlackTree& other) = delete;
+        RedBlackTree(RedBlackTree&& other) noexcept;
+        ~RedBlackTree() override;
+
+        RedBlackTree& operator =(const RedBlackTree& other) = delete;
+        RedBlackTree& operator =(RedBlackTree&& other) noexcept;
+
+        // Builds a balanced tree in O(n) from pairs sorted by strictly increasing key.
+        template <typename ForwardIterator>
+        [[nodiscard]] static RedBlackTree FromSorted(ForwardIterator first, ForwardIterator last, const Compare& compare = Compare());
+
+        // Copies the pairs into an immutable pointer-free snapshot in O(n). Like
+        // Save and Load it needs the keys ordered by operator >.
+        [[nodiscard]] FrozenTree<Key, Value> Freeze() const;
+
+        // Save writes the pairs to a TreeImage file. Load maps one and builds the
+        // tree in O(n) with FromSorted, reserving the nodes in one go; to serve
+        // the file without building a tree open it as a TreeImage instead.
+        void Save(const std::string& path) const;
+        [[nodiscard]] static RedBlackTree Load(const std::string& path);
+
+        // Split moves the keys less than key into the first tree and the rest into
+        // the second in O(log n), leaving this tree empty. Join is the inverse and
+        // needs every key of left to be less than every key of right. Without
+        // order statistics the split trees do not know their sizes: GetSize on
+        // them, or on trees joined or combined from them, counts the nodes in
+        // O(n) on every call without writing to the tree, until it is cleared.
+        [[nodiscard]] std::pair<RedBlackTree, RedBlackTree> Split(const Key& key);
+        [[nodiscard]] static RedBlackTree Join(RedBlackTree&& left, RedBlackTree&& right);
+
+        // Detach the keys in [lo, hi] in O(log n): EraseRange frees them in O(k)
+        // and returns their count, ExtractRange hands them over as a tree and
+        // counts them in O(k) to keep both sizes.
+        int EraseRange(const Key& lo, const Key& hi);
+        [[nodiscard]] RedBlackTree ExtractRange(const Key& lo, const Key& hi);
+
+        // Set operations on the keys of two trees by split and join: the root of
+        // rhs splits lhs and the two sides are combined recursively, which takes
+        // O(m log(n / m + 1)) work for sizes m <= n. Both trees are consumed, their
+        // nodes are relinked into the result and the ones left out are freed. For
+        // a key in both trees Union keeps the value of rhs and Intersection the
+        // value of lhs. With a pool the two sides run in parallel while both are
+        // large enough to pay for a task.
+        [[nodiscard]] static RedBlackTree Union(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool = nullptr);
+        [[nodiscard]] static RedBlackTree Intersection(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool = nullptr);
+        [[nodiscard]] static RedBlackTree Difference(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool = nullptr);
+
+        [[nodiscard]] inline bool IsEmpty() const override { return !m_Root; }
+        [[nodiscard]] int GetSize() const override;
         [[nodiscard]] inline const Node* GetRoot() const { return m_Root; }
-        [[nodiscard]] inline int GetSize() const { return m_Size; }
 
-        [[nodiscard]] int GetHeight() const;
-        [[nodiscard]] bool IsExists(const T& value) const;
-        [[nodiscard]] Node* GetNode(const T& value);
-        [[nodiscard]] const Node* GetNode(const T& value) const;
-        [[nodiscard]] std::optional<T> GetMin() const;
-        [[nodiscard]] std::optional<T> GetMax() const;
+        [[nodiscard]] int GetHeight() const override;
+        [[nodiscard]] bool IsExists(const Key& key) const override;
+        [[nodiscard]] Node* GetNode(const Key& key);
+        [[nodiscard]] const Node* GetNode(const Key& key) const;
+        [[nodiscard]] inline const Compare& GetCompare() const { return m_Compare; }
+
+        [[nodiscard]] Value& GetMin();
+        [[nodiscard]] const Value& GetMin() const;
+        [[nodiscard]] Value& GetMax();
+        [[nodiscard]] const Value& GetMax() const;
+
+        [[nodiscard]] Value& Get(const Key& key);
+        [[nodiscard]] const Value& Get(const Key& key) const;
 
-        T& Push(const T& value);
-        void Pop(const T& value);
+        void Clear();
+
+        Value& Push(const Key& key, Value value) override;
+        Value& Push(Key&& key, Value value) override;
+        void Pop(const Key& key) override;
+
+        // With a transparent Compare, like KeyLess<> or std::less<>, these take
+        // anything it compares with Key and never build a Key to look it up.
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] bool IsExists(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] Node* GetNode(const KeyLike& key);
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] const Node* GetNode(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] Value& Get(const KeyLike& key);
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] const Value& Get(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] Iterator Find(const KeyLike& key);
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] ConstIterator Find(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        void Pop(const KeyLike& key);
+
+        // Batched Push, Get and IsExists for many keys at once. The descents run
+        // interleaved and prefetch their next node, so their cache misses overlap.
+        // Missing keys give nullptr and false. PushBatch first walks a group of
+        // keys to pull their paths into the cache and then pushes them one by one.
+        void PushBatch(const Key* keys, const Value* values, std::size_t count);
+        void GetBatch(const Key* keys, std::size_t count, Value** values);
+        void GetBatch(const Key* keys, std::size_t count, const Value** values) const;
+        void ContainsBatch(const Key* keys, std::size_t count, bool* isExists) const;
+
+        template <typename... Args>
+        std::pair<Iterator, bool> Emplace(Args&&... args);
+
+        template <typename... Args>
+        std::pair<Iterator, bool> TryEmplace(const Key& key, Args&&... args);
+
+        template <typename... Args>
+        std::pair<Iterator, bool> TryEmplace(Key&& key, Args&&... args);
+
+        [[nodiscard]] Iterator Find(const Key& key);
+        [[nodiscard]] ConstIterator Find(const Key& key) const;
+
+        // Rank counts the keys less than key and Select returns the element at
+        // a zero-based index; both need HasOrderStatistics.
+        [[nodiscard]] int Rank(const Key& key) const;
+        [[nodiscard]] Iterator Select(int index);
+        [[nodiscard]] ConstIterator Select(int index) const;
+
+        // Folds the Monoid over the keys in [lo, hi]. Values changed in place have
+        // to be followed by Refresh(key) to keep the summaries up to date.
+        [[nodiscard]] Summary RangeQuery(const Key& lo, const Key& hi) const;
+        void Refresh(const Key& key);
+
+        [[nodiscard]] Iterator begin() { return Iterator(GetMinNode(m_Root), this); }
+        [[nodiscard]] Iterator end() { return Iterator(nullptr, this); }
+
+        [[nodiscard]] ConstIterator begin() const { return ConstIterator(GetMinNode(m_Root), this); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(nullptr, this); }
+
+        [[nodiscard]] ConstIterator cbegin() const { return ConstIterator(GetMinNode(m_Root), this); }
+        [[nodiscard]] ConstIterator cend() const { return ConstIterator(nullptr, this); }
+
+        Value& operator [](const Key& key);
+        Value& operator [](Key&& key);
 
         void Print() const;
 
+        template <typename Key_, typename Value_, bool HasOrderStatistics_, typename Monoid_, template <typename> typename Allocator_, typename Compare_>
+        friend std::ostream& operator <<(std::ostream& ostream, const RedBlackTree<Key_, Value_, HasOrderStatistics_, Monoid_, Allocator_, Compare_>& tree);
+
     private:
-        [[nodiscard]] int GetHeight(Node* node) const;
+        static constexpr bool        IsAugmented    = HasOrderStatistics || !std::is_void_v<Monoid>;
+        static constexpr int         UnknownSize    = -1;
+        static constexpr std::size_t BatchGroupSize = 64;
+
+        // a black height of 8 means at least 255 nodes on either side of a fork
+        static constexpr int ForkBlackHeight   = 8;
+        static constexpr int LookupBlackHeight = 3;
 
-        [[nodiscard]] std::optional<T> GetMin(Node* node) const;
-        [[nodiscard]] std::optional<T> GetMax(Node* node) const;
+        enum class SetOperation : int {
+            Union = 0,
+            Intersection,
+            Difference
+        };
+
+        [[nodiscard]] int GetHeight(Node* node) const;
 
         [[nodiscard]] Node* GetMinNode(Node* node) const;
         [[nodiscard]] Node* GetMaxNode(Node* node) const;
 
         [[nodiscard]] Node* GetSuccessor(Node* node) const;
+        [[nodiscard]] Node* GetPredecessor(Node* node) const;
+
+        template <typename KeyLike>
+        [[nodiscard]] Node* FindNode(const KeyLike& key) const;
+        [[nodiscard]] Node* FindNode(const Key& key, Node*& parent) const;
+
+        void Erase(Node* node);
+
+        template <typename KeyArg, typename... Args>
+        std::pair<Node*, bool> TryInsert(KeyArg&& key, Args&&... args);
+        void Attach(Node* node, Node* parent);
+        void Detach(Node* node);
+
+        [[nodiscard]] static int GetSubtreeSize(const Node* node);
+        [[nodiscard]] static int GetIndex(const Node* node);
+        [[nodiscard]] static Node* GetNodeAt(Node* node, int index);
+        [[nodiscard]] static Summary GetSummary(const Node* node);
+
+        static void Update(Node* node);
+        static void UpdatePath(Node* node);
+
+        void Transplant(Node* node, Node* child);
 
         void RotateLeft(Node* node);
         void RotateRight(Node* node);
 
-        void PushFix(Node* node);
-        void PopFix(Node* node);
+        bool PushFix(Node* node);
+        void PopFix(Node* node, Node* parent);
+
+        [[nodiscard]] static int GetBlackHeight(const Node* node);
+        [[nodiscard]] static int GetTreeSize(const Node* root);
+        [[nodiscard]] int CountNodes(Node* root) const;
+        [[nodiscard]] static Node* MakeRoot(Node* node, int& blackHeight);
+
+        void SplitNodes(Node* node, int blackHeight, const Key& key, bool isInclusive, Node*& left, int& leftHeight, Node*& right, int& rightHeight);
+        Node* JoinNodes(Node* left, int leftHeight, Node* middle, Node* right, int rightHeight, int& blackHeight);
+        Node* JoinNodes(Node* left, Node* right);
+        Node* CutRange(const Key& lo, const Key& hi);
+
+        // Splits around key like SplitNodes and hands the node of key out on its own.
+        void SplitNodes(Node* node, int blackHeight, const Key& key, Node*& left, int& leftHeight, Node*& match, Node*& right, int& rightHeight);
+
+        template <SetOperation Operation>
+        [[nodiscard]] static RedBlackTree Combine(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool);
+
+        template <SetOperation Operation>
+        Node* CombineNodes(Node* lhs, int lhsHeight, Node* rhs, int rhsHeight, ThreadPool* pool, int& blackHeight, int& matchCount);
+
+        // Union and Difference with a small rhs, its keys are looked up one by one.
+        template <SetOperation Operation>
+        Node* MergeNodes(Node* lhs, Node* rhs, int& blackHeight, int& matchCount);
+
+        template <typename ForwardIterator>
+        Node* Build(ForwardIterator& iterator, std::size_t count, int depth, int redDepth);
+
+        int Destroy(Node* node);
 
-        void Print(const Node* node, const int& level, const char* caption) const;
+        void Print(const Node* node, int level, const char* caption, std::ostream& ostream) const;
 
-        Node* m_Root;
-        int   m_Size;
+        Allocator<Node> m_Allocator;
+        Compare         m_Compare;
+        Node*           m_Root;
+        int             m_Size;
 
     }; // class RedBlackTree
 
 #include "RedBlackTree.inl"
 
-} // namespace DataStructures
\ No newline at end of file
+} // namespace DataStructures
@@ -1,331 +1,1088 @@
 //////////////////////////////////////////////////////////////////////////////
 /// class RedBlackTree::Node
 //////////////////////////////////////////////////////////////////////////////
-template <typename T>
-RedBlackTree<T>::Node::Node() :
-    m_Value(T()),
-    m_Color(Color::Black),
-    m_Parent(nullptr),
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename... Args>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node::Node(Args&&... args) :
+    m_Pair(std::forward<Args>(args)...),
+    m_ParentAndColor(static_cast<std::uintptr_t>(Color::Red)),
     m_Left(nullptr),
-    m_Right(nullptr) { }
+    m_Right(nullptr) {
 
-template <typename T>
-RedBlackTree<T>::Node::Node(const T& value, Node* parent, Node* left, Node* right) :
-    m_Value(value),
-    m_Color(Node::Color::Red),
-    m_Parent(parent),
-    m_Left(left),
-    m_Right(right) { }
+    static_assert(alignof(Node) > ColorMask, "the color bit has to fit into the parent pointer alignment");
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node::Print(std::ostream& ostream) const {
+    ostream << "Key: " << m_Pair.first << ", Value: " << m_Pair.second << " {C: ";
+
+    ostream << (GetColor() == Color::Black ? "Black" : "Red") << ", L: ";
+
+    if (m_Left)
+        ostream << m_Left->m_Pair.first;
+    else
+        ostream << "Null";
+
+    ostream << ", R: ";
+
+    if (m_Right)
+        ostream << m_Right->m_Pair.first;
+    else
+        ostream << "Null";
+
+    ostream << "}";
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// class RedBlackTree::Iterator
+//////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::Iterator(Node* node, const RedBlackTree* tree) :
+    m_Node(node),
+    m_Tree(tree) { }
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator ++() {
+    m_Node = m_Tree->GetSuccessor(m_Node);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator ++(int) {
+    Iterator old = *this;
+    ++(*this);
+
+    return old;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator --() {
+    m_Node = m_Node ? m_Tree->GetPredecessor(m_Node) : m_Tree->GetMaxNode(m_Tree->m_Root);
 
-template <typename T>
-RedBlackTree<T>::Node::~Node() {
-    delete m_Left;
-    delete m_Right;
+    return *this;
 }
 
-template <typename T>
-void RedBlackTree<T>::Node::Print() const {
-    std::cout << m_Value << " {C:";
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator --(int) {
+    Iterator old = *this;
+    --(*this);
 
-    std::cout << (m_Color == Node::Color::Black ? "Black"                          : "Red" ) << ", L: ";
-    std::cout << (m_Left                        ? std::to_string(m_Left->m_Value)  : "Null") << ", R: ";
-    std::cout << (m_Right                       ? std::to_string(m_Right->m_Value) : "Null") << "}";
+    return old;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator +=(int n) {
+    if constexpr (HasOrderStatistics) {
+        const int index = m_Node ? GetIndex(m_Node) : m_Tree->GetSize();
+
+        m_Node = GetNodeAt(m_Tree->m_Root, index + n);
+
+        return *this;
+    }
+
+    for (; n > 0; --n)
+        ++(*this);
+
+    for (; n < 0; ++n)
+        --(*this);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator ==(const Iterator& other) const {
+    return m_Node == other.m_Node;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator !=(const Iterator& other) const {
+    return m_Node != other.m_Node;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// class RedBlackTree::ConstIterator
+//////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::ConstIterator(Node* node, const RedBlackTree* tree) :
+    m_Node(node),
+    m_Tree(tree) { }
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator ++() {
+    m_Node = m_Tree->GetSuccessor(m_Node);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator ++(int) {
+    ConstIterator old = *this;
+    ++(*this);
+
+    return old;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator --() {
+    m_Node = m_Node ? m_Tree->GetPredecessor(m_Node) : m_Tree->GetMaxNode(m_Tree->m_Root);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator --(int) {
+    ConstIterator old = *this;
+    --(*this);
+
+    return old;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator +=(int n) {
+    if constexpr (HasOrderStatistics) {
+        const int index = m_Node ? GetIndex(m_Node) : m_Tree->GetSize();
+
+        m_Node = GetNodeAt(m_Tree->m_Root, index + n);
+
+        return *this;
+    }
+
+    for (; n > 0; --n)
+        ++(*this);
+
+    for (; n < 0; ++n)
+        --(*this);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator ==(const ConstIterator& other) const {
+    return m_Node == other.m_Node;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator !=(const ConstIterator& other) const {
+    return m_Node != other.m_Node;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 /// class RedBlackTree
 //////////////////////////////////////////////////////////////////////////////
-template <typename T>
-RedBlackTree<T>::RedBlackTree(const T& value) :
-    m_Root(new Node(value)),
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RedBlackTree() :
+    m_Root(nullptr),
+    m_Size(0) { }
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RedBlackTree(const Compare& compare) :
+    m_Compare(compare),
+    m_Root(nullptr),
     m_Size(0) { }
 
-template <typename T>
-RedBlackTree<T>::RedBlackTree(Node* root) :
-    m_Root(root),
-    m_Size(m_Root ? 1 : 0) { }
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RedBlackTree(RedBlackTree&& other) noexcept :
+    m_Allocator(std::move(other.m_Allocator)),
+    m_Compare(std::move(other.m_Compare)),
+    m_Root(std::exchange(other.m_Root, nullptr)),
+    m_Size(std::exchange(other.m_Size, 0)) { }
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::~RedBlackTree() {
+    Clear();
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator =(RedBlackTree&& other) noexcept {
+    if (this == &other)
+        return *this;
+
+    Clear();
+
+    m_Allocator = std::move(other.m_Allocator);
+    m_Compare   = std::move(other.m_Compare);
+    m_Root      = std::exchange(other.m_Root, nullptr);
+    m_Size      = std::exchange(other.m_Size, 0);
+
+    return *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename ForwardIterator>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FromSorted(ForwardIterator first, ForwardIterator last, const Compare& compare) {
+    const auto isNotIncreasing = [&compare](const auto& lhs, const auto& rhs) { return !IsLess(compare, lhs.first, rhs.first); };
+
+    if (std::adjacent_find(first, last, isNotIncreasing) != last)
+        throw std::invalid_argument("Ng::RedBlackTree::FromSorted: keys are not strictly increasing!");
+
+    RedBlackTree tree(compare);
+
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+    if (count == 0)
+        return tree;
+
+    // Every null link of a tree split at the midpoint sits on one of the two
+    // lowest levels, so painting the deepest level red equalizes the black height.
+    int redDepth = 0;
+
+    for (std::size_t n = count; n > 1; n >>= 1)
+        ++redDepth;
+
+    tree.m_Allocator.Reserve(count);
+
+    tree.m_Root = tree.Build(first, count, 0, redDepth);
+    tree.m_Size = static_cast<int>(count);
 
-template <typename T>
-RedBlackTree<T>::~RedBlackTree() {
-    delete m_Root;
+    return tree;
 }
 
-template <typename T>
-int RedBlackTree<T>::GetHeight() const {
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+FrozenTree<Key, Value> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Freeze() const {
+    static_assert(IsNaturalOrder<Compare, Key>, "Ng::RedBlackTree::Freeze: FrozenTree orders keys by operator >!");
+
+    return FrozenTree<Key, Value>::FromSorted(begin(), end());
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Save(const std::string& path) const {
+    static_assert(IsNaturalOrder<Compare, Key>, "Ng::RedBlackTree::Save: TreeImage orders keys by operator >!");
+
+    TreeImage<Key, Value>::Save(path, begin(), end());
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Load(const std::string& path) {
+    static_assert(IsNaturalOrder<Compare, Key>, "Ng::RedBlackTree::Load: TreeImage orders keys by operator >!");
+
+    const TreeImage<Key, Value> image = TreeImage<Key, Value>::Open(path);
+
+    return FromSorted(image.begin(), image.end());
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+std::pair<RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>, RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Split(const Key& key) {
+    std::pair<RedBlackTree, RedBlackTree> trees { RedBlackTree(m_Compare), RedBlackTree(m_Compare) };
+
+    Node* root        = std::exchange(m_Root, nullptr);
+    int   leftHeight  = 0;
+    int   rightHeight = 0;
+
+    // m_Root is the scratch root of the fix-ups while the halves are joined
+    SplitNodes(root, GetBlackHeight(root), key, false, trees.first.m_Root, leftHeight, trees.second.m_Root, rightHeight);
+
+    m_Root = nullptr;
+
+    trees.first.m_Size  = GetTreeSize(trees.first.m_Root);
+    trees.second.m_Size = GetTreeSize(trees.second.m_Root);
+
+    if (m_Size != UnknownSize && !trees.first.m_Root)
+        trees.second.m_Size = m_Size;
+
+    if (m_Size != UnknownSize && !trees.second.m_Root)
+        trees.first.m_Size = m_Size;
+
+    trees.second.m_Allocator = m_Allocator.Share();
+    trees.first.m_Allocator  = std::move(m_Allocator);
+
+    m_Size = 0;
+
+    return trees;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Join(RedBlackTree&& left, RedBlackTree&& right) {
+    if (left.m_Root && right.m_Root && !IsLess(left.m_Compare, left.GetMaxNode(left.m_Root)->m_Pair.first, right.GetMinNode(right.m_Root)->m_Pair.first))
+        throw std::invalid_argument("Ng::RedBlackTree::Join: keys of left are not less than keys of right!");
+
+    RedBlackTree tree(left.m_Compare);
+
+    tree.m_Allocator = std::move(left.m_Allocator);
+    tree.m_Allocator.Adopt(std::move(right.m_Allocator));
+
+    const int leftSize  = std::exchange(left.m_Size, 0);
+    const int rightSize = std::exchange(right.m_Size, 0);
+
+    tree.m_Size = leftSize != UnknownSize && rightSize != UnknownSize ? leftSize + rightSize : UnknownSize;
+
+    tree.m_Root = tree.JoinNodes(std::exchange(left.m_Root, nullptr), std::exchange(right.m_Root, nullptr));
+
+    return tree;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::EraseRange(const Key& lo, const Key& hi) {
+    if (IsLess(m_Compare, hi, lo))
+        return 0;
+
+    const int count = Destroy(CutRange(lo, hi));
+
+    if (m_Size != UnknownSize)
+        m_Size -= count;
+
+    return count;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ExtractRange(const Key& lo, const Key& hi) {
+    RedBlackTree tree(m_Compare);
+
+    if (IsLess(m_Compare, hi, lo))
+        return tree;
+
+    tree.m_Root = CutRange(lo, hi);
+
+    if (!tree.m_Root)
+        return tree;
+
+    tree.m_Allocator = m_Allocator.Share();
+
+    tree.m_Size = CountNodes(tree.m_Root);
+
+    if (m_Size != UnknownSize)
+        m_Size -= tree.m_Size;
+
+    return tree;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Union(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool) {
+    return Combine<SetOperation::Union>(std::move(lhs), std::move(rhs), pool);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Intersection(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool) {
+    return Combine<SetOperation::Intersection>(std::move(lhs), std::move(rhs), pool);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Difference(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool) {
+    return Combine<SetOperation::Difference>(std::move(lhs), std::move(rhs), pool);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSize() const {
+    // counted on every call rather than stored, readers sharing the tree under
+    // a shared lock must not write to it
+    return m_Size != UnknownSize ? m_Size : CountNodes(m_Root);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetHeight() const {
     return GetHeight(m_Root);
 }
 
-template <typename T>
-bool RedBlackTree<T>::IsExists(const T& value) const {
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::IsExists(const Key& key) const {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNode(const Key& key) {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+const typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNode(const Key& key) const {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMin() {
+    if (!m_Root)
+        throw std::out_of_range("Ng::RedBlackTree::GetMin: m_Root is nullptr!");
+
+    return GetMinNode(m_Root)->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+const Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMin() const {
+    if (!m_Root)
+        throw std::out_of_range("Ng::RedBlackTree::GetMin: m_Root is nullptr!");
+
+    return GetMinNode(m_Root)->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMax() {
+    if (!m_Root)
+        throw std::out_of_range("Ng::RedBlackTree::GetMax: m_Root is nullptr!");
+
+    return GetMaxNode(m_Root)->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+const Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMax() const {
+    if (!m_Root)
+        throw std::out_of_range("Ng::RedBlackTree::GetMax: m_Root is nullptr!");
+
+    return GetMaxNode(m_Root)->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const Key& key) {
+    Node* node = FindNode(key);
+
+    if (!node)
+        throw std::out_of_range("Ng::RedBlackTree::Get: key is not exists!");
+
+    return node->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+const Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const Key& key) const {
+    const Node* node = FindNode(key);
+
+    if (!node)
+        throw std::out_of_range("Ng::RedBlackTree::Get: key is not exists!");
+
+    return node->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Clear() {
+    // Nodes without destructors to run are dropped together with the pool chunks,
+    // unless the chunks are shared with split trees and outlive this one.
+    if constexpr (!std::is_trivially_destructible_v<Node> || !Allocator<Node>::IsBulkReleasable)
+        Destroy(m_Root);
+    else if (m_Allocator.IsShared())
+        Destroy(m_Root);
+
+    m_Allocator.Release();
+
+    m_Root = nullptr;
+    m_Size = 0;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Push(const Key& key, Value value) {
+    return TryInsert(key, std::move(value)).first->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Push(Key&& key, Value value) {
+    return TryInsert(std::move(key), std::move(value)).first->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Pop(const Key& key) {
+    if (Node* node = FindNode(key))
+        Erase(node);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::IsExists(const KeyLike& key) const {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNode(const KeyLike& key) {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+const typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNode(const KeyLike& key) const {
+    return FindNode(key);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const KeyLike& key) {
+    Node* node = FindNode(key);
+
+    if (!node)
+        throw std::out_of_range("Ng::RedBlackTree::Get: key is not exists!");
+
+    return node->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+const Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const KeyLike& key) const {
+    const Node* node = FindNode(key);
+
+    if (!node)
+        throw std::out_of_range("Ng::RedBlackTree::Get: key is not exists!");
+
+    return node->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Find(const KeyLike& key) {
+    return Iterator(FindNode(key), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Find(const KeyLike& key) const {
+    return ConstIterator(FindNode(key), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike, typename>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Pop(const KeyLike& key) {
+    if (Node* node = FindNode(key))
+        Erase(node);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::PushBatch(const Key* keys, const Value* values, std::size_t count) {
+    const auto descend = [this](Node* node, const Key& key) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+    };
+
+    // Inserts rebalance the tree, so only the reads run ahead: the descents of
+    // a group pull its paths into the cache, then the new keys are pushed in
+    // order. Nodes are never freed on the way, so the keys found stay found.
+    Node* nodes[BatchGroupSize];
+
+    for (std::size_t first = 0; first < count; first += BatchGroupSize) {
+        const std::size_t size = std::min(BatchGroupSize, count - first);
+
+        InterleavedSearch(m_Root, keys + first, size, descend, [&nodes](std::size_t index, Node* node, int) {
+            nodes[index] = node;
+        });
+
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!nodes[i])
+                TryInsert(keys[first + i], values[first + i]);
+        }
+    }
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetBatch(const Key* keys, std::size_t count, Value** values) {
+    const auto descend = [this](Node* node, const Key& key) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+    };
+
+    InterleavedSearch(m_Root, keys, count, descend, [values](std::size_t index, Node* node, int) {
+        values[index] = node ? &node->m_Pair.second : nullptr;
+    });
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetBatch(const Key* keys, std::size_t count, const Value** values) const {
+    const auto descend = [this](Node* node, const Key& key) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+    };
+
+    InterleavedSearch(m_Root, keys, count, descend, [values](std::size_t index, Node* node, int) {
+        values[index] = node ? &node->m_Pair.second : nullptr;
+    });
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ContainsBatch(const Key* keys, std::size_t count, bool* isExists) const {
+    const auto descend = [this](Node* node, const Key& key) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+    };
+
+    InterleavedSearch(m_Root, keys, count, descend, [isExists](std::size_t index, Node* node, int) {
+        isExists[index] = node != nullptr;
+    });
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Detach(Node* node) {
+    // Keys are immutable, so a node with two children is replaced by relinking
+    // its successor rather than by copying the successor's pair into it.
+    Node*                child        = nullptr;
+    Node*                parent       = nullptr;
+    typename Node::Color removedColor = node->GetColor();
+
+    if (!node->m_Left || !node->m_Right) {
+        child  = node->m_Left ? node->m_Left : node->m_Right;
+        parent = node->GetParent();
+
+        Transplant(node, child);
+    } else {
+        Node* successor = GetMinNode(node->m_Right);
+
+        removedColor = successor->GetColor();
+        child        = successor->m_Right;
+
+        if (successor->GetParent() == node) {
+            parent = successor;
+        } else {
+            parent = successor->GetParent();
+
+            Transplant(successor, child);
+
+            successor->m_Right = node->m_Right;
+            successor->m_Right->SetParent(successor);
+        }
+
+        Transplant(node, successor);
+
+        successor->m_Left = node->m_Left;
+        successor->m_Left->SetParent(successor);
+        successor->SetColor(node->GetColor());
+    }
+
+    UpdatePath(parent);
+
+    // child may be a null leaf, so its parent is passed along explicitly
+    if (removedColor == Node::Color::Black)
+        PopFix(child, parent);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Rank(const Key& key) const {
+    static_assert(HasOrderStatistics, "Ng::RedBlackTree::Rank: the tree does not keep order statistics!");
+
     Node* node = m_Root;
+    int   rank = 0;
 
-    while (node && value != node->m_Value)
-        node = node->m_Value > value ? node->m_Left : node->m_Right;
+    while (node) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        if (order == 0)
+            break;
+
+        if (order < 0) {
+            node = node->m_Left;
+        } else {
+            rank += GetSubtreeSize(node->m_Left) + 1;
+            node  = node->m_Right;
+        }
+    }
+
+    return node ? rank + GetSubtreeSize(node->m_Left) : rank;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Select(int index) {
+    static_assert(HasOrderStatistics, "Ng::RedBlackTree::Select: the tree does not keep order statistics!");
+
+    return Iterator(GetNodeAt(m_Root, index), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Select(int index) const {
+    static_assert(HasOrderStatistics, "Ng::RedBlackTree::Select: the tree does not keep order statistics!");
+
+    return ConstIterator(GetNodeAt(m_Root, index), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Summary RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RangeQuery(const Key& lo, const Key& hi) const {
+    static_assert(!std::is_void_v<Monoid>, "Ng::RedBlackTree::RangeQuery: the tree has no monoid!");
+
+    Node* node = m_Root;
+
+    // descend to the topmost node inside the range, both bounds are then
+    // resolved on its left and right spines
+    while (node && (IsLess(m_Compare, node->m_Pair.first, lo) || IsLess(m_Compare, hi, node->m_Pair.first)))
+        node = IsLess(m_Compare, node->m_Pair.first, lo) ? node->m_Right : node->m_Left;
+
+    if (!node)
+        return Monoid::Identity();
+
+    Summary left  = Monoid::Identity();
+    Summary right = Monoid::Identity();
+
+    for (Node* current = node->m_Left; current; ) {
+        if (IsLess(m_Compare, current->m_Pair.first, lo)) {
+            current = current->m_Right;
+        } else {
+            left    = Monoid::Combine(Monoid::Combine(Monoid::Lift(current->m_Pair.first, current->m_Pair.second), GetSummary(current->m_Right)), left);
+            current = current->m_Left;
+        }
+    }
+
+    for (Node* current = node->m_Right; current; ) {
+        if (IsLess(m_Compare, hi, current->m_Pair.first)) {
+            current = current->m_Left;
+        } else {
+            right   = Monoid::Combine(right, Monoid::Combine(GetSummary(current->m_Left), Monoid::Lift(current->m_Pair.first, current->m_Pair.second)));
+            current = current->m_Right;
+        }
+    }
+
+    return Monoid::Combine(Monoid::Combine(left, Monoid::Lift(node->m_Pair.first, node->m_Pair.second)), right);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Refresh(const Key& key) {
+    UpdatePath(FindNode(key));
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename... Args>
+std::pair<typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Emplace(Args&&... args) {
+    // the key is only known once the pair is built, so a duplicate costs one construction
+    Node* node   = m_Allocator.Allocate(std::forward<Args>(args)...);
+    Node* parent = nullptr;
+
+    if (Node* existing = FindNode(node->m_Pair.first, parent)) {
+        m_Allocator.Deallocate(node);
+
+        return { Iterator(existing, this), false };
+    }
+
+    Attach(node, parent);
+
+    return { Iterator(node, this), true };
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename... Args>
+std::pair<typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryEmplace(const Key& key, Args&&... args) {
+    auto [node, isInserted] = TryInsert(key, std::forward<Args>(args)...);
+
+    return { Iterator(node, this), isInserted };
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename... Args>
+std::pair<typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryEmplace(Key&& key, Args&&... args) {
+    auto [node, isInserted] = TryInsert(std::move(key), std::forward<Args>(args)...);
+
+    return { Iterator(node, this), isInserted };
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Find(const Key& key) {
+    return Iterator(FindNode(key), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Find(const Key& key) const {
+    return ConstIterator(FindNode(key), this);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator [](const Key& key) {
+    return TryInsert(key).first->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+Value& RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator [](Key&& key) {
+    return TryInsert(std::move(key)).first->m_Pair.second;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Print() const {
+    std::cout << *this;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetHeight(Node* node) const {
+    return node ? std::max(GetHeight(node->m_Left), GetHeight(node->m_Right)) + 1 : 0;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMinNode(Node* node) const {
+    while (node && node->m_Left)
+        node = node->m_Left;
+
+    return node;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMaxNode(Node* node) const {
+    while (node && node->m_Right)
+        node = node->m_Right;
 
     return node;
 }
 
-template <typename T>
-typename RedBlackTree<T>::Node* RedBlackTree<T>::GetNode(const T& value) {
-    Node* node = m_Root;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSuccessor(Node* node) const {
+    if (node->m_Right)
+        return GetMinNode(node->m_Right);
+
+    Node* successor = node->GetParent();
+
+    while (successor && successor->m_Right == node) {
+        node      = successor;
+        successor = successor->GetParent();
+    }
+
+    return successor;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetPredecessor(Node* node) const {
+    if (node->m_Left)
+        return GetMaxNode(node->m_Left);
+
+    Node* predecessor = node->GetParent();
 
-    while (node && value != node->m_Value)
-        node = node->m_Value > value ? node->m_Left : node->m_Right;
+    while (predecessor && predecessor->m_Left == node) {
+        node        = predecessor;
+        predecessor = predecessor->GetParent();
+    }
 
-    return node;
+    return predecessor;
 }
 
-template <typename T>
-const typename RedBlackTree<T>::Node* RedBlackTree<T>::GetNode(const T& value) const {
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyLike>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FindNode(const KeyLike& key) const {
     Node* node = m_Root;
 
-    while (node && value != node->m_Value)
-        node = node->m_Value > value ? node->m_Left : node->m_Right;
+    while (node) {
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
 
-    return node;
-}
+        if (order == 0)
+            break;
 
-template <typename T>
-std::optional<T> RedBlackTree<T>::GetMin() const {
-    return GetMin(m_Root);
-}
+        node = order < 0 ? node->m_Left : node->m_Right;
+    }
 
-template <typename T>
-std::optional<T> RedBlackTree<T>::GetMax() const {
-    return GetMax(m_Root);
+    return node;
 }
 
-template <typename T>
-T& RedBlackTree<T>::Push(const T& value) {
-    if (!m_Root) {
-        m_Root = new Node(value);
-        m_Root->m_Color = Node::Color::Black;
-        ++m_Size;
-
-        return m_Root->m_Value;
-    }
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FindNode(const Key& key, Node*& parent) const {
+    Node* node = m_Root;
 
-    Node* node   = m_Root;
-    Node* parent = nullptr;
+    parent = nullptr;
 
     while (node) {
-        if (node->m_Value == value)
-            return node->m_Value;
+        const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+        if (order == 0)
+            break;
 
         parent = node;
-        node   = node->m_Value > value ? node->m_Left : node->m_Right;
+        node   = order < 0 ? node->m_Left : node->m_Right;
     }
 
-    ++m_Size;
-
-    node = new Node(value, parent);
+    return node;
+}
 
-    if (parent->m_Value > value)
-        parent->m_Left = node;
-    else
-        parent->m_Right = node;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Erase(Node* node) {
+    if (m_Size != UnknownSize)
+        --m_Size;
 
-    PushFix(node);
+    Detach(node);
 
-    return node->m_Value;
+    m_Allocator.Deallocate(node);
 }
 
-template <typename T>
-void RedBlackTree<T>::Pop(const T& value) {
-    Node* node = GetNode(value);
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename KeyArg, typename... Args>
+std::pair<typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node*, bool> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryInsert(KeyArg&& key, Args&&... args) {
+    Node* parent = nullptr;
 
-    if (!node)
-        return;
+    if (Node* existing = FindNode(key, parent))
+        return { existing, false };
 
-    --m_Size;
+    Node* node = m_Allocator.Allocate(std::piecewise_construct,
+                                      std::forward_as_tuple(std::forward<KeyArg>(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
 
-    Node* parent = node->m_Parent;
-    Node* child  = nullptr;
+    Attach(node, parent);
 
-    if (node->m_Left && node->m_Right) {
-        Node* successor = GetSuccessor(node);
+    return { node, true };
+}
 
-        node->m_Value = successor->m_Value;
-        parent        = successor->m_Parent;
-        node          = successor;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Attach(Node* node, Node* parent) {
+    if (m_Size != UnknownSize)
+        ++m_Size;
 
-        if (successor->m_Right)
-            child = successor->m_Right;
-    } else if (!node->m_Left && node->m_Right) {
-        child = node->m_Right;
-    } else if (node->m_Left && !node->m_Right) {
-        child = node->m_Left;
-    }
+    Update(node);
 
-    if (parent) {
-        if (parent->m_Left == node)
-            parent->m_Left = child;
-        else
-            parent->m_Right = child;
+    node->SetParent(parent);
 
-        if (child)
-            child->m_Parent = parent;
-    } else {
-        m_Root = child;
+    if (!parent) {
+        m_Root = node;
+        m_Root->SetColor(Node::Color::Black);
 
-        if (m_Root)
-            m_Root->m_Parent = nullptr;
+        return;
     }
 
-    if (node->m_Color == Node::Color::Black && child)
-        PopFix(child);
-
-    node->m_Left  = nullptr;
-    node->m_Right = nullptr;
-
-    delete node;
-}
+    if (IsLess(m_Compare, node->m_Pair.first, parent->m_Pair.first))
+        parent->m_Left = node;
+    else
+        parent->m_Right = node;
 
-template <typename T>
-void RedBlackTree<T>::Print() const {
-    Print(m_Root, 1, "Root");
+    UpdatePath(parent);
+    PushFix(node);
 }
 
-template <typename T>
-int RedBlackTree<T>::GetHeight(Node* node) const {
-    return node ? std::max(GetHeight(node->m_Left), GetHeight(node->m_Right)) + 1 : 0;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSubtreeSize(const Node* node) {
+    return node ? node->m_SubtreeSize : 0;
 }
 
-template <typename T>
-std::optional<T> RedBlackTree<T>::GetMin(Node* node) const {
-    if (!node)
-        return std::nullopt;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetIndex(const Node* node) {
+    int index = GetSubtreeSize(node->m_Left);
 
-    while (node->m_Left)
-        node = node->m_Left;
+    for (const Node* parent = node->GetParent(); parent; node = parent, parent = parent->GetParent()) {
+        if (parent->m_Right == node)
+            index += GetSubtreeSize(parent->m_Left) + 1;
+    }
 
-    return node->m_Value;
+    return index;
 }
 
-template <typename T>
-std::optional<T> RedBlackTree<T>::GetMax(Node* node) const {
-    if (!node)
-        return std::nullopt;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNodeAt(Node* node, int index) {
+    while (node) {
+        const int leftSize = GetSubtreeSize(node->m_Left);
 
-    while (node->m_Right)
-        node = node->m_Right;
+        if (index == leftSize)
+            return node;
 
-    return node->m_Value;
-}
+        if (index < leftSize) {
+            node = node->m_Left;
+        } else {
+            index -= leftSize + 1;
+            node   = node->m_Right;
+        }
+    }
 
-template <typename T>
-typename RedBlackTree<T>::Node* RedBlackTree<T>::GetMinNode(Node* node) const {
-    while (node && node->m_Left)
-        node = node->m_Left;
+    return nullptr;
+}
 
-    return node;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Summary RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSummary(const Node* node) {
+    return node ? node->m_Summary : Monoid::Identity();
 }
 
-template <typename T>
-typename RedBlackTree<T>::Node* RedBlackTree<T>::GetMaxNode(Node* node) const {
-    while (node && node->m_Right)
-        node = node->m_Right;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Update(Node* node) {
+    if constexpr (HasOrderStatistics)
+        node->m_SubtreeSize = GetSubtreeSize(node->m_Left) + GetSubtreeSize(node->m_Right) + 1;
 
-    return node;
+    if constexpr (!std::is_void_v<Monoid>) {
+        node->m_Summary = Monoid::Combine(Monoid::Combine(GetSummary(node->m_Left),
+                                                          Monoid::Lift(node->m_Pair.first, node->m_Pair.second)),
+                                          GetSummary(node->m_Right));
+    }
 }
 
-template <typename T>
-typename RedBlackTree<T>::Node* RedBlackTree<T>::GetSuccessor(Node* node) const {
-    if (node->m_Right)
-        return GetMinNode(node->m_Right);
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::UpdatePath(Node* node) {
+    if constexpr (IsAugmented) {
+        for (; node; node = node->GetParent())
+            Update(node);
+    }
+}
 
-    Node* successor = node->m_Parent;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Transplant(Node* node, Node* child) {
+    Node* parent = node->GetParent();
 
-    while (successor && successor->m_Right == node) {
-        node      = successor;
-        successor = successor->m_Parent;
-    }
+    if (!parent)
+        m_Root = child;
+    else if (parent->m_Left == node)
+        parent->m_Left = child;
+    else
+        parent->m_Right = child;
 
-    return successor;
+    if (child)
+        child->SetParent(parent);
 }
 
-template <typename T>
-void RedBlackTree<T>::RotateLeft(Node* node) {
-    //   c      =>      s
-    //  / \            / \
-    // u   s    =>    c   r
-    //    / \        / \
-    //   l   r  =>  u   l
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RotateLeft(Node* node) {
+    /*   c      =>      s
+        / \            / \
+       u   s    =>    c   r
+          / \        / \
+         l   r  =>  u   l */
 
     Node* right     = node->m_Right;
     Node* rightLeft = right->m_Left;
 
-    right->m_Parent   = node->m_Parent;
+    right->SetParent(node->GetParent());
 
-    if (!node->m_Parent)
+    if (!node->GetParent())
         m_Root = right;
-    else if (node == node->m_Parent->m_Left)
-        node->m_Parent->m_Left = right;
+    else if (node == node->GetParent()->m_Left)
+        node->GetParent()->m_Left = right;
     else
-        node->m_Parent->m_Right = right;
+        node->GetParent()->m_Right = right;
 
-    node->m_Parent = right;
+    node->SetParent(right);
     right->m_Left = node;
     node->m_Right = rightLeft;
 
     if (rightLeft)
-        rightLeft->m_Parent = node;
+        rightLeft->SetParent(node);
+
+    Update(node);
+    Update(right);
 }
 
-template <typename T>
-void RedBlackTree<T>::RotateRight(Node* node) {
-    //     c    =>    u
-    //    / \        / \
-    //   u   s  =>  l   c
-    //  / \            / \
-    // l   r    =>    r   s
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RotateRight(Node* node) {
+    /*     c    =>    u
+          / \        / \
+         u   s  =>  l   c
+        / \            / \
+       l   r    =>    r   s */
 
     Node* left      = node->m_Left;
     Node* leftRight = left->m_Right;
 
-    left->m_Parent   = node->m_Parent;
+    left->SetParent(node->GetParent());
 
-    if (!node->m_Parent)
+    if (!node->GetParent())
         m_Root = left;
-    else if (node == node->m_Parent->m_Left)
-        node->m_Parent->m_Left = left;
+    else if (node == node->GetParent()->m_Left)
+        node->GetParent()->m_Left = left;
     else
-        node->m_Parent->m_Right = left;
+        node->GetParent()->m_Right = left;
 
-    node->m_Parent = left;
+    node->SetParent(left);
     left->m_Right  = node;
     node->m_Left   = leftRight;
 
     if (leftRight)
-        leftRight->m_Parent = node;
+        leftRight->SetParent(node);
+
+    Update(node);
+    Update(left);
 }
 
-template <typename T>
-void RedBlackTree<T>::PushFix(Node* node) {
-    while (node->m_Parent && node->m_Parent->m_Color == Node::Color::Red) {
-        Node* parent = node->m_Parent;
-        Node* uncle  = node->m_Parent->m_Parent && node->m_Parent->m_Parent->m_Left == node->m_Parent ?
-                       node->m_Parent->m_Parent->m_Right :
-                       node->m_Parent->m_Parent->m_Left;
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+bool RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::PushFix(Node* node) {
+    while (node->GetParent() && node->GetParent()->GetColor() == Node::Color::Red) {
+        Node* parent = node->GetParent();
+        Node* uncle  = node->GetParent()->GetParent() && node->GetParent()->GetParent()->m_Left == node->GetParent() ?
+                       node->GetParent()->GetParent()->m_Right :
+                       node->GetParent()->GetParent()->m_Left;
 
         // uncle is leaf => color is black
-        if (!uncle || uncle->m_Color == Node::Color::Black) {
+        if (!uncle || uncle->GetColor() == Node::Color::Black) {
             // if uncle is at right, parent at left.
-            if (parent->m_Parent->m_Left == parent) {
+            if (parent->GetParent()->m_Left == parent) {
                 // from shape triangle to line
                 if (parent->m_Left != node) {
                     RotateLeft(parent);
 
                     node = parent;
-                    parent = node->m_Parent;
+                    parent = node->GetParent();
                 }
 
                 // grand parent rotation from line shape
                 if (parent->m_Left == node) {
-                    parent->m_Color           = Node::Color::Black;
-                    parent->m_Parent->m_Color = Node::Color::Red;
+                    parent->SetColor(Node::Color::Black);
+                    parent->GetParent()->SetColor(Node::Color::Red);
 
-                    RotateRight(parent->m_Parent);
+                    RotateRight(parent->GetParent());
                     // will break because parent color has changed to black.
                 }
             } else {
@@ -334,65 +1091,71 @@ void RedBlackTree<T>::PushFix(Node* node) {
                     RotateRight(parent);
 
                     node = parent;
-                    parent = node->m_Parent;
+                    parent = node->GetParent();
                 }
 
                 // grand parent rotation from line shape
                 if (parent->m_Right == node) {
-                    parent->m_Color           = Node::Color::Black;
-                    parent->m_Parent->m_Color = Node::Color::Red;
+                    parent->SetColor(Node::Color::Black);
+                    parent->GetParent()->SetColor(Node::Color::Red);
 
-                    RotateLeft(parent->m_Parent);
+                    RotateLeft(parent->GetParent());
                 }
             }
-        } else if (uncle->m_Color == Node::Color::Red) {
-            parent->m_Color = Node::Color::Black;
-            uncle->m_Color = Node::Color::Black;
-            parent->m_Parent->m_Color = Node::Color::Red;
+        } else if (uncle->GetColor() == Node::Color::Red) {
+            parent->SetColor(Node::Color::Black);
+            uncle->SetColor(Node::Color::Black);
+            parent->GetParent()->SetColor(Node::Color::Red);
 
-            node = parent->m_Parent;
+            node = parent->GetParent();
         }
 
     }
 
-    m_Root->m_Color = Node::Color::Black;
-}
+    // the root only ends up red after recoloring all the way up, painting it
+    // black then grows the black height
+    const bool isGrown = m_Root->GetColor() == Node::Color::Red;
 
-template <typename T>
-void RedBlackTree<T>::PopFix(Node* node) {
-    while (node != m_Root && node->m_Color == Node::Color::Black) {
-        Node* parent = node->m_Parent;
+    m_Root->SetColor(Node::Color::Black);
+
+    return isGrown;
+}
 
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::PopFix(Node* node, Node* parent) {
+    while (node != m_Root && (!node || node->GetColor() == Node::Color::Black)) {
         if (parent->m_Left == node) {
             Node* sibling = parent->m_Right;
 
-            if (sibling->m_Color == Node::Color::Red) {
-                sibling->m_Color = Node::Color::Black;
-                parent->m_Color  = Node::Color::Red;
+            if (sibling->GetColor() == Node::Color::Red) {
+                sibling->SetColor(Node::Color::Black);
+                parent->SetColor(Node::Color::Red);
 
                 RotateLeft(parent);
                 sibling = parent->m_Right;
             }
 
-            if ((!sibling->m_Left || sibling->m_Left->m_Color == Node::Color::Black) &&
-                (!sibling->m_Right || sibling->m_Right->m_Color == Node::Color::Black)) {
+            if ((!sibling->m_Left || sibling->m_Left->GetColor() == Node::Color::Black) &&
+                (!sibling->m_Right || sibling->m_Right->GetColor() == Node::Color::Black)) {
 
-                sibling->m_Color = Node::Color::Red;
-                node             = parent;
+                sibling->SetColor(Node::Color::Red);
+
+                node   = parent;
+                parent = node->GetParent();
             } else {
-                if (!sibling->m_Right || sibling->m_Right->m_Color == Node::Color::Black) {
-                    sibling->m_Color         = Node::Color::Red;
-                    sibling->m_Left->m_Color = Node::Color::Black;
+                if (!sibling->m_Right || sibling->m_Right->GetColor() == Node::Color::Black) {
+                    sibling->SetColor(Node::Color::Red);
+                    sibling->m_Left->SetColor(Node::Color::Black);
 
                     RotateRight(sibling);
                     sibling = parent->m_Right;
                 }
 
-                sibling->m_Color = parent->m_Color;
-                parent->m_Color  = Node::Color::Black;
+                sibling->SetColor(parent->GetColor());
+                parent->SetColor(Node::Color::Black);
 
                 if (sibling->m_Right)
-                    sibling->m_Right->m_Color = Node::Color::Black;
+                    sibling->m_Right->SetColor(Node::Color::Black);
 
                 RotateLeft(parent);
 
@@ -401,33 +1164,35 @@ void RedBlackTree<T>::PopFix(Node* node) {
         } else {
             Node* sibling = parent->m_Left;
 
-            if (sibling->m_Color == Node::Color::Red) {
-                sibling->m_Color = Node::Color::Black;
-                parent->m_Color  = Node::Color::Red;
+            if (sibling->GetColor() == Node::Color::Red) {
+                sibling->SetColor(Node::Color::Black);
+                parent->SetColor(Node::Color::Red);
 
                 RotateRight(parent);
                 sibling = parent->m_Left;
             }
 
-            if ((!sibling->m_Left || sibling->m_Left->m_Color == Node::Color::Black) &&
-                (!sibling->m_Right || sibling->m_Right->m_Color == Node::Color::Black)) {
+            if ((!sibling->m_Left || sibling->m_Left->GetColor() == Node::Color::Black) &&
+                (!sibling->m_Right || sibling->m_Right->GetColor() == Node::Color::Black)) {
+
+                sibling->SetColor(Node::Color::Red);
 
-                sibling->m_Color = Node::Color::Red;
-                node             = parent;
+                node   = parent;
+                parent = node->GetParent();
             } else {
-                if (!sibling->m_Left || sibling->m_Left->m_Color == Node::Color::Black) {
-                    sibling->m_Color          = Node::Color::Red;
-                    sibling->m_Right->m_Color = Node::Color::Black;
+                if (!sibling->m_Left || sibling->m_Left->GetColor() == Node::Color::Black) {
+                    sibling->SetColor(Node::Color::Red);
+                    sibling->m_Right->SetColor(Node::Color::Black);
 
                     RotateLeft(sibling);
                     sibling = parent->m_Left;
                 }
 
-                sibling->m_Color = parent->m_Color;
-                parent->m_Color  = Node::Color::Black;
+                sibling->SetColor(parent->GetColor());
+                parent->SetColor(Node::Color::Black);
 
                 if (sibling->m_Left)
-                    sibling->m_Left->m_Color = Node::Color::Black;
+                    sibling->m_Left->SetColor(Node::Color::Black);
 
                 RotateRight(parent);
 
@@ -436,34 +1201,516 @@ void RedBlackTree<T>::PopFix(Node* node) {
         }
     }
 
-    node->m_Color = Node::Color::Black;
+    if (node)
+        node->SetColor(Node::Color::Black);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetBlackHeight(const Node* node) {
+    int height = 0;
+
+    for (; node; node = node->m_Left) {
+        if (node->GetColor() == Node::Color::Black)
+            ++height;
+    }
+
+    return height;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetTreeSize(const Node* root) {
+    if (!root)
+        return 0;
+
+    if constexpr (HasOrderStatistics)
+        return GetSubtreeSize(root);
+
+    return UnknownSize;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CountNodes(Node* root) const {
+    if constexpr (HasOrderStatistics)
+        return GetSubtreeSize(root);
+
+    int count = 0;
+
+    for (Node* node = GetMinNode(root); node; node = GetSuccessor(node))
+        ++count;
+
+    return count;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::MakeRoot(Node* node, int& blackHeight) {
+    if (!node)
+        return nullptr;
+
+    node->SetParent(nullptr);
+
+    if (node->GetColor() == Node::Color::Red) {
+        node->SetColor(Node::Color::Black);
+        ++blackHeight;
+    }
+
+    return node;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SplitNodes(Node* node, int blackHeight, const Key& key, bool isInclusive, Node*& left, int& leftHeight, Node*& right, int& rightHeight) {
+    // Every node on the search path joins the pieces split off below it with
+    // its other subtree; the black heights telescope, so the joins sum to O(log n).
+    if (!node) {
+        left        = nullptr;
+        right       = nullptr;
+        leftHeight  = 0;
+        rightHeight = 0;
+
+        return;
+    }
+
+    int childLeftHeight  = blackHeight - (node->GetColor() == Node::Color::Black ? 1 : 0);
+    int childRightHeight = childLeftHeight;
+
+    Node* childLeft  = MakeRoot(node->m_Left, childLeftHeight);
+    Node* childRight = MakeRoot(node->m_Right, childRightHeight);
+
+    // an inclusive split keeps key itself on the left
+    if (isInclusive ? !IsLess(m_Compare, key, node->m_Pair.first) : IsLess(m_Compare, node->m_Pair.first, key)) {
+        Node* middle       = nullptr;
+        int   middleHeight = 0;
+
+        SplitNodes(childRight, childRightHeight, key, isInclusive, middle, middleHeight, right, rightHeight);
+
+        left = JoinNodes(childLeft, childLeftHeight, node, middle, middleHeight, leftHeight);
+    } else {
+        Node* middle       = nullptr;
+        int   middleHeight = 0;
+
+        SplitNodes(childLeft, childLeftHeight, key, isInclusive, left, leftHeight, middle, middleHeight);
+
+        right = JoinNodes(middle, middleHeight, node, childRight, childRightHeight, rightHeight);
+    }
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::JoinNodes(Node* left, int leftHeight, Node* middle, Node* right, int rightHeight, int& blackHeight) {
+    // Both trees have black roots. middle is hung off the taller tree at the
+    // first black node of the shorter tree's black height, painted red and
+    // fixed up like a fresh leaf, which takes O(|leftHeight - rightHeight| + 1).
+    middle->SetParent(nullptr);
+    middle->SetColor(Node::Color::Black);
+
+    if (leftHeight == rightHeight) {
+        middle->m_Left  = left;
+        middle->m_Right = right;
+
+        if (left)
+            left->SetParent(middle);
+
+        if (right)
+            right->SetParent(middle);
+
+        Update(middle);
+
+        blackHeight = leftHeight + 1;
+
+        return middle;
+    }
+
+    const bool isLeftTaller = leftHeight > rightHeight;
+
+    Node* parent = nullptr;
+    Node* node   = isLeftTaller ? left : right;
+    int   height = isLeftTaller ? leftHeight : rightHeight;
+    int   target = isLeftTaller ? rightHeight : leftHeight;
+
+    while (node && (node->GetColor() == Node::Color::Red || height > target)) {
+        if (node->GetColor() == Node::Color::Black)
+            --height;
+
+        parent = node;
+        node   = isLeftTaller ? node->m_Right : node->m_Left;
+    }
+
+    middle->SetParent(parent);
+    middle->SetColor(Node::Color::Red);
+
+    if (isLeftTaller) {
+        parent->m_Right = middle;
+        middle->m_Left  = node;
+        middle->m_Right = right;
+    } else {
+        parent->m_Left  = middle;
+        middle->m_Left  = left;
+        middle->m_Right = node;
+    }
+
+    if (middle->m_Left)
+        middle->m_Left->SetParent(middle);
+
+    if (middle->m_Right)
+        middle->m_Right->SetParent(middle);
+
+    Update(middle);
+    UpdatePath(parent);
+
+    m_Root = isLeftTaller ? left : right;
+
+    blackHeight = (isLeftTaller ? leftHeight : rightHeight) + (PushFix(middle) ? 1 : 0);
+
+    return std::exchange(m_Root, nullptr);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::JoinNodes(Node* left, Node* right) {
+    if (!left || !right)
+        return left ? left : right;
+
+    // the minimum of right becomes the joining node
+    Node* middle = GetMinNode(right);
+
+    m_Root = right;
+    Detach(middle);
+    right = std::exchange(m_Root, nullptr);
+
+    int height = 0;
+
+    return JoinNodes(left, GetBlackHeight(left), middle, right, GetBlackHeight(right), height);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CutRange(const Key& lo, const Key& hi) {
+    Node* root   = std::exchange(m_Root, nullptr);
+    Node* left   = nullptr;
+    Node* rest   = nullptr;
+    Node* middle = nullptr;
+    Node* right  = nullptr;
+
+    int leftHeight   = 0;
+    int restHeight   = 0;
+    int middleHeight = 0;
+    int rightHeight  = 0;
+
+    SplitNodes(root, GetBlackHeight(root), lo, false, left, leftHeight, rest, restHeight);
+    SplitNodes(rest, restHeight, hi, true, middle, middleHeight, right, rightHeight);
+
+    m_Root = JoinNodes(left, right);
+
+    return middle;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SplitNodes(Node* node, int blackHeight, const Key& key, Node*& left, int& leftHeight, Node*& match, Node*& right, int& rightHeight) {
+    if (!node) {
+        left        = nullptr;
+        match       = nullptr;
+        right       = nullptr;
+        leftHeight  = 0;
+        rightHeight = 0;
+
+        return;
+    }
+
+    int childLeftHeight  = blackHeight - (node->GetColor() == Node::Color::Black ? 1 : 0);
+    int childRightHeight = childLeftHeight;
+
+    Node* childLeft  = MakeRoot(node->m_Left, childLeftHeight);
+    Node* childRight = MakeRoot(node->m_Right, childRightHeight);
+
+    Node* middle       = nullptr;
+    int   middleHeight = 0;
+
+    const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+    if (order > 0) {
+        SplitNodes(childRight, childRightHeight, key, middle, middleHeight, match, right, rightHeight);
+
+        left = JoinNodes(childLeft, childLeftHeight, node, middle, middleHeight, leftHeight);
+    } else if (order < 0) {
+        SplitNodes(childLeft, childLeftHeight, key, left, leftHeight, match, middle, middleHeight);
+
+        right = JoinNodes(middle, middleHeight, node, childRight, childRightHeight, rightHeight);
+    } else {
+        left        = childLeft;
+        leftHeight  = childLeftHeight;
+        match       = node;
+        right       = childRight;
+        rightHeight = childRightHeight;
+    }
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SetOperation Operation>
+RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Combine(RedBlackTree&& lhs, RedBlackTree&& rhs, ThreadPool* pool) {
+    RedBlackTree tree(lhs.m_Compare);
+
+    tree.m_Allocator = std::move(lhs.m_Allocator);
+    tree.m_Allocator.Adopt(std::move(rhs.m_Allocator));
+
+    const int lhsSize = std::exchange(lhs.m_Size, 0);
+    const int rhsSize = std::exchange(rhs.m_Size, 0);
+
+    Node* lhsRoot = std::exchange(lhs.m_Root, nullptr);
+    Node* rhsRoot = std::exchange(rhs.m_Root, nullptr);
+
+    int blackHeight = 0;
+    int matchCount  = 0;
+
+    tree.m_Root = tree.template CombineNodes<Operation>(lhsRoot, GetBlackHeight(lhsRoot), rhsRoot, GetBlackHeight(rhsRoot), pool, blackHeight, matchCount);
+
+    if constexpr (Operation == SetOperation::Union)
+        tree.m_Size = lhsSize != UnknownSize && rhsSize != UnknownSize ? lhsSize + rhsSize - matchCount : UnknownSize;
+    else if constexpr (Operation == SetOperation::Intersection)
+        tree.m_Size = matchCount;
+    else
+        tree.m_Size = lhsSize != UnknownSize ? lhsSize - matchCount : UnknownSize;
+
+    return tree;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SetOperation Operation>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CombineNodes(Node* lhs, int lhsHeight, Node* rhs, int rhsHeight, ThreadPool* pool, int& blackHeight, int& matchCount) {
+    // This tree only lends its scratch root to the joins and its allocator to
+    // the nodes that are dropped, a forked side gets a scratch tree of its own.
+    if (!lhs || !rhs) {
+        matchCount  = 0;
+        blackHeight = 0;
+
+        if constexpr (Operation == SetOperation::Union) {
+            blackHeight = lhs ? lhsHeight : rhsHeight;
+
+            return lhs ? lhs : rhs;
+        }
+
+        Destroy(rhs);
+
+        if constexpr (Operation == SetOperation::Difference) {
+            blackHeight = lhsHeight;
+
+            return lhs;
+        }
+
+        Destroy(lhs);
+
+        return nullptr;
+    }
+
+    if (Operation != SetOperation::Intersection && rhsHeight <= LookupBlackHeight)
+        return MergeNodes<Operation>(lhs, rhs, blackHeight, matchCount);
+
+    int rhsLeftHeight  = rhsHeight - 1;
+    int rhsRightHeight = rhsHeight - 1;
+
+    Node* rhsLeft  = MakeRoot(rhs->m_Left, rhsLeftHeight);
+    Node* rhsRight = MakeRoot(rhs->m_Right, rhsRightHeight);
+
+    Node* lhsLeft        = nullptr;
+    Node* lhsRight       = nullptr;
+    Node* match          = nullptr;
+    int   lhsLeftHeight  = 0;
+    int   lhsRightHeight = 0;
+
+    SplitNodes(lhs, lhsHeight, rhs->m_Pair.first, lhsLeft, lhsLeftHeight, match, lhsRight, lhsRightHeight);
+
+    Node* left         = nullptr;
+    Node* right        = nullptr;
+    int   leftHeight   = 0;
+    int   rightHeight  = 0;
+    int   leftMatches  = 0;
+    int   rightMatches = 0;
+
+    if (pool && std::min(lhsHeight, rhsHeight) >= ForkBlackHeight) {
+        RedBlackTree scratch(m_Compare);
+
+        pool->Invoke(
+            [&] { left = CombineNodes<Operation>(lhsLeft, lhsLeftHeight, rhsLeft, rhsLeftHeight, pool, leftHeight, leftMatches); },
+            [&] { right = scratch.template CombineNodes<Operation>(lhsRight, lhsRightHeight, rhsRight, rhsRightHeight, pool, rightHeight, rightMatches); }
+        );
+
+        m_Allocator.Adopt(std::move(scratch.m_Allocator));
+    } else {
+        left  = CombineNodes<Operation>(lhsLeft, lhsLeftHeight, rhsLeft, rhsLeftHeight, pool, leftHeight, leftMatches);
+        right = CombineNodes<Operation>(lhsRight, lhsRightHeight, rhsRight, rhsRightHeight, pool, rightHeight, rightMatches);
+    }
+
+    matchCount = leftMatches + rightMatches + (match ? 1 : 0);
+
+    // the node of the key comes from rhs in a union and from lhs in an intersection
+    if constexpr (Operation == SetOperation::Union) {
+        if (match)
+            m_Allocator.Deallocate(match);
+
+        return JoinNodes(left, leftHeight, rhs, right, rightHeight, blackHeight);
+    }
+
+    m_Allocator.Deallocate(rhs);
+
+    if (Operation == SetOperation::Intersection && match)
+        return JoinNodes(left, leftHeight, match, right, rightHeight, blackHeight);
+
+    if (match)
+        m_Allocator.Deallocate(match);
+
+    Node* root = JoinNodes(left, right);
+
+    blackHeight = GetBlackHeight(root);
+
+    return root;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SetOperation Operation>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::MergeNodes(Node* lhs, Node* rhs, int& blackHeight, int& matchCount) {
+    // Takes the nodes of rhs in order by rotating left children up, like
+    // Destroy, and pushes or pops each of them in lhs.
+    m_Root     = lhs;
+    matchCount = 0;
+
+    while (rhs) {
+        if (rhs->m_Left) {
+            Node* left = rhs->m_Left;
+
+            rhs->m_Left   = left->m_Right;
+            left->m_Right = rhs;
+            rhs           = left;
+
+            continue;
+        }
+
+        Node* node   = std::exchange(rhs, rhs->m_Right);
+        Node* parent = nullptr;
+        Node* match  = FindNode(node->m_Pair.first, parent);
+
+        if (match) {
+            ++matchCount;
+
+            if constexpr (Operation == SetOperation::Union) {
+                match->m_Pair.second = std::move(node->m_Pair.second);
+                UpdatePath(match);
+            } else {
+                Detach(match);
+                m_Allocator.Deallocate(match);
+            }
+        }
+
+        if (Operation == SetOperation::Difference || match) {
+            m_Allocator.Deallocate(node);
+            continue;
+        }
+
+        node->m_Left  = nullptr;
+        node->m_Right = nullptr;
+        node->SetColor(Node::Color::Red);
+
+        Attach(node, parent);
+    }
+
+    blackHeight = GetBlackHeight(m_Root);
+
+    return std::exchange(m_Root, nullptr);
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+template <typename ForwardIterator>
+typename RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Build(ForwardIterator& iterator, std::size_t count, int depth, int redDepth) {
+    if (count == 0)
+        return nullptr;
+
+    const std::size_t leftCount = (count - 1) / 2;
+
+    Node* left = Build(iterator, leftCount, depth + 1, redDepth);
+    Node* node = nullptr;
+
+    try {
+        node = m_Allocator.Allocate((*iterator).first, (*iterator).second);
+    } catch (...) {
+        Destroy(left);
+        throw;
+    }
+
+    ++iterator;
+
+    node->SetColor(depth > 0 && depth == redDepth ? Node::Color::Red : Node::Color::Black);
+    node->m_Left = left;
+
+    if (left)
+        left->SetParent(node);
+
+    try {
+        node->m_Right = Build(iterator, count - leftCount - 1, depth + 1, redDepth);
+    } catch (...) {
+        Destroy(node);
+        throw;
+    }
+
+    if (node->m_Right)
+        node->m_Right->SetParent(node);
+
+    Update(node);
+
+    return node;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+int RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Destroy(Node* node) {
+    // Rotates left children up instead of recursing, so a degenerate tree
+    // is torn down in O(n) without a stack or parent links.
+    int count = 0;
+
+    while (node) {
+        if (node->m_Left) {
+            Node* left = node->m_Left;
+
+            node->m_Left  = left->m_Right;
+            left->m_Right = node;
+            node          = left;
+        } else {
+            Node* right = node->m_Right;
+
+            m_Allocator.Deallocate(node);
+            node = right;
+
+            ++count;
+        }
+    }
+
+    return count;
 }
 
-template <typename T>
-void RedBlackTree<T>::Print(const Node* node, const int& level, const char* caption) const {
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+void RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Print(const Node* node, int level, const char* caption, std::ostream& ostream) const {
     if (!node) {
-        std::cout << caption << ": Null" << std::endl;
+        ostream << caption << ": Null" << std::endl;
         return;
     }
 
-    std::cout << caption << ": ";
-    node->Print();
+    ostream << caption << ": ";
+    node->Print(ostream);
 
     if (node->m_Left || node->m_Right) {
-        std::cout << " (" << std::endl;
+        ostream << " (" << std::endl;
 
         for (int i = 0; i < level; i++)
-            std::cout << "| ";
-        Print(node->m_Left, level + 1, "Left");
+            ostream << "| ";
+        Print(node->m_Left, level + 1, "Left", ostream);
 
         for (int i = 0; i < level; i++)
-            std::cout << "| ";
-        Print(node->m_Right, level + 1, "Right");
+            ostream << "| ";
+        Print(node->m_Right, level + 1, "Right", ostream);
 
         for (int i = 0; i < level - 1; i++)
-            std::cout << "| ";
-        std::cout << ")";
+            ostream << "| ";
+        ostream << ")";
     }
 
-    std::cout << std::endl;
+    ostream << std::endl;
+}
+
+template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+std::ostream& operator <<(std::ostream& ostream, const RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>& tree) {
+    tree.Print(tree.m_Root, 1, "Root", ostream);
+
+    return ostream;
 }
\ No newline at end of file
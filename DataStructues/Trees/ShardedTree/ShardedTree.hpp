@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DataStructures {
+
+    // Splits the keys over independent Engine trees, each behind a lock of its
+    // own, so threads working on different shards never contend. Keys go to a
+    // shard either by a mixed hash of the key or by range: with splitters
+    // s0 < s1 < ... shard i holds the keys in [s(i - 1), s(i)). Only hash
+    // partitioning needs std::hash<Key>, range partitioning needs operator >.
+    //
+    // Any tree with the members of ITree plus Get, Clear and ordered const
+    // iteration over pairs can be the engine: RedBlackTree, SplayTree, BTree.
+    // Lookups copy values out because a reference would outlive the lock.
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    class ShardedTree {
+    public:
+        using Tree = Engine<Key, Value>;
+
+        enum class Partitioning : int {
+            Hash = 0,
+            Range
+        };
+
+        // Counters are cumulative since construction. ContendedCount counts the
+        // operations that found the shard locked and had to wait.
+        struct ShardStatistics {
+            int           Size           = 0;
+            int           Height         = 0;
+            std::uint64_t ReadCount      = 0;
+            std::uint64_t WriteCount     = 0;
+            std::uint64_t ContendedCount = 0;
+        };
+
+        static constexpr int DefaultShardCount = 64;
+
+        explicit ShardedTree(int shardCount = DefaultShardCount);
+        explicit ShardedTree(std::vector<Key> splitters);
+        ShardedTree(const ShardedTree& other) = delete;
+
+        ShardedTree& operator =(const ShardedTree& other) = delete;
+
+        [[nodiscard]] inline Partitioning GetPartitioning() const { return m_Partitioning; }
+        [[nodiscard]] inline int GetShardCount() const { return m_ShardCount; }
+        [[nodiscard]] int GetShardIndex(const Key& key) const;
+
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] int GetSize() const;
+
+        [[nodiscard]] bool IsExists(const Key& key) const;
+        [[nodiscard]] std::optional<Value> Find(const Key& key) const;
+        [[nodiscard]] Value Get(const Key& key) const;
+
+        // Like the engines Push keeps the value of a key that is already there.
+        // Push returns whether the key was new, Pop whether the key was there.
+        bool Push(const Key& key, Value value);
+        bool Push(Key&& key, Value value);
+        bool Pop(const Key& key);
+
+        void Clear();
+
+        // Runs function(Tree&) on the shard of key under its lock.
+        template <typename Function>
+        decltype(auto) Visit(const Key& key, Function&& function);
+
+        // Visits the pairs of all shards in key order. Every shard is locked for
+        // the whole walk, so the pairs form one consistent snapshot.
+        template <typename Function>
+        void ForEach(Function&& function) const;
+
+        [[nodiscard]] std::vector<ShardStatistics> GetStatistics() const;
+
+    private:
+        struct alignas(64) Shard {
+            mutable std::mutex                 Mutex;
+            Tree                               Storage;
+            std::atomic<int>                   Size { 0 };
+            mutable std::atomic<std::uint64_t> ReadCount { 0 };
+            std::atomic<std::uint64_t>         WriteCount { 0 };
+            mutable std::atomic<std::uint64_t> ContendedCount { 0 };
+        };
+
+        // The constructor picks the partition function, so a tree partitioned by
+        // range never instantiates std::hash<Key>.
+        using ShardIndexFunction = int (*)(const ShardedTree& tree, const Key& key);
+
+        template <typename KeyArg>
+        bool Insert(KeyArg&& key, Value&& value);
+
+        [[nodiscard]] static int GetHashShardIndex(const ShardedTree& tree, const Key& key);
+        [[nodiscard]] static int GetRangeShardIndex(const ShardedTree& tree, const Key& key);
+
+        [[nodiscard]] Shard& GetShard(const Key& key) const;
+        [[nodiscard]] std::unique_lock<std::mutex> Lock(const Shard& shard) const;
+        [[nodiscard]] std::vector<std::unique_lock<std::mutex>> LockAll() const;
+
+        template <typename Function>
+        void Merge(Function& function) const;
+
+        // SplitMix64 finalizer, std::hash is the identity for integers and
+        // strided keys would otherwise pile up in a few shards
+        [[nodiscard]] static std::uint64_t Mix(std::uint64_t value);
+
+    private:
+        Partitioning             m_Partitioning;
+        ShardIndexFunction       m_GetShardIndex;
+        int                      m_ShardCount;
+        std::vector<Key>         m_Splitters;
+        std::unique_ptr<Shard[]> m_Shards;
+
+    }; // class ShardedTree
+
+} // namespace DataStructures
+
+#include "ShardedTree.inl"
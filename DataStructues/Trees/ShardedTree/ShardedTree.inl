@@ -0,0 +1,289 @@
+namespace DataStructures {
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    ShardedTree<Engine, Key, Value>::ShardedTree(int shardCount)
+        : m_Partitioning(Partitioning::Hash)
+        , m_GetShardIndex(&GetHashShardIndex)
+        , m_ShardCount(shardCount) {
+        if (shardCount < 1)
+            throw std::invalid_argument("Ng::ShardedTree::ShardedTree: shard count is less than 1!");
+
+        m_Shards = std::make_unique<Shard[]>(static_cast<std::size_t>(shardCount));
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    ShardedTree<Engine, Key, Value>::ShardedTree(std::vector<Key> splitters)
+        : m_Partitioning(Partitioning::Range)
+        , m_GetShardIndex(&GetRangeShardIndex)
+        , m_ShardCount(static_cast<int>(splitters.size()) + 1)
+        , m_Splitters(std::move(splitters)) {
+        for (std::size_t i = 1; i < m_Splitters.size(); ++i) {
+            if (!(m_Splitters[i] > m_Splitters[i - 1]))
+                throw std::invalid_argument("Ng::ShardedTree::ShardedTree: splitters are not increasing!");
+        }
+
+        m_Shards = std::make_unique<Shard[]>(static_cast<std::size_t>(m_ShardCount));
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    int ShardedTree<Engine, Key, Value>::GetShardIndex(const Key& key) const {
+        return m_GetShardIndex(*this, key);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    bool ShardedTree<Engine, Key, Value>::IsEmpty() const {
+        return GetSize() == 0;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    int ShardedTree<Engine, Key, Value>::GetSize() const {
+        int size = 0;
+
+        for (int i = 0; i < m_ShardCount; ++i)
+            size += m_Shards[i].Size.load(std::memory_order_relaxed);
+
+        return size;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    bool ShardedTree<Engine, Key, Value>::IsExists(const Key& key) const {
+        Shard&     shard = GetShard(key);
+        const auto lock  = Lock(shard);
+
+        shard.ReadCount.fetch_add(1, std::memory_order_relaxed);
+
+        return shard.Storage.IsExists(key);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    std::optional<Value> ShardedTree<Engine, Key, Value>::Find(const Key& key) const {
+        Shard&     shard = GetShard(key);
+        const auto lock  = Lock(shard);
+
+        shard.ReadCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (!shard.Storage.IsExists(key))
+            return std::nullopt;
+
+        return shard.Storage.Get(key);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    Value ShardedTree<Engine, Key, Value>::Get(const Key& key) const {
+        std::optional<Value> value = Find(key);
+
+        if (!value)
+            throw std::out_of_range("Ng::ShardedTree::Get: key is not exists!");
+
+        return std::move(*value);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    bool ShardedTree<Engine, Key, Value>::Push(const Key& key, Value value) {
+        return Insert(key, std::move(value));
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    bool ShardedTree<Engine, Key, Value>::Push(Key&& key, Value value) {
+        return Insert(std::move(key), std::move(value));
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    bool ShardedTree<Engine, Key, Value>::Pop(const Key& key) {
+        Shard&     shard = GetShard(key);
+        const auto lock  = Lock(shard);
+
+        shard.WriteCount.fetch_add(1, std::memory_order_relaxed);
+
+        const int size = shard.Storage.GetSize();
+
+        shard.Storage.Pop(key);
+
+        if (shard.Storage.GetSize() == size)
+            return false;
+
+        shard.Size.store(size - 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    void ShardedTree<Engine, Key, Value>::Clear() {
+        for (int i = 0; i < m_ShardCount; ++i) {
+            const auto lock = Lock(m_Shards[i]);
+
+            m_Shards[i].Storage.Clear();
+            m_Shards[i].Size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    template <typename Function>
+    decltype(auto) ShardedTree<Engine, Key, Value>::Visit(const Key& key, Function&& function) {
+        Shard&     shard = GetShard(key);
+        const auto lock  = Lock(shard);
+
+        shard.WriteCount.fetch_add(1, std::memory_order_relaxed);
+
+        // the visitor may change the shard, its size is taken again on the way out
+        struct SizeUpdate {
+            ~SizeUpdate() { Target.Size.store(Target.Storage.GetSize(), std::memory_order_relaxed); }
+
+            Shard& Target;
+        } sizeUpdate { shard };
+
+        return std::forward<Function>(function)(shard.Storage);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    template <typename Function>
+    void ShardedTree<Engine, Key, Value>::ForEach(Function&& function) const {
+        const auto locks = LockAll();
+
+        Merge(function);
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    std::vector<typename ShardedTree<Engine, Key, Value>::ShardStatistics> ShardedTree<Engine, Key, Value>::GetStatistics() const {
+        std::vector<ShardStatistics> statistics(static_cast<std::size_t>(m_ShardCount));
+
+        for (int i = 0; i < m_ShardCount; ++i) {
+            const Shard&     shard   = m_Shards[i];
+            ShardStatistics& current = statistics[static_cast<std::size_t>(i)];
+
+            {
+                std::lock_guard<std::mutex> lock(shard.Mutex);
+
+                current.Size   = shard.Storage.GetSize();
+                current.Height = shard.Storage.GetHeight();
+            }
+
+            current.ReadCount      = shard.ReadCount.load(std::memory_order_relaxed);
+            current.WriteCount     = shard.WriteCount.load(std::memory_order_relaxed);
+            current.ContendedCount = shard.ContendedCount.load(std::memory_order_relaxed);
+        }
+
+        return statistics;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    template <typename KeyArg>
+    bool ShardedTree<Engine, Key, Value>::Insert(KeyArg&& key, Value&& value) {
+        Shard&     shard = GetShard(key);
+        const auto lock  = Lock(shard);
+
+        shard.WriteCount.fetch_add(1, std::memory_order_relaxed);
+
+        const int size = shard.Storage.GetSize();
+
+        shard.Storage.Push(std::forward<KeyArg>(key), std::move(value));
+
+        if (shard.Storage.GetSize() == size)
+            return false;
+
+        shard.Size.store(size + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    typename ShardedTree<Engine, Key, Value>::Shard& ShardedTree<Engine, Key, Value>::GetShard(const Key& key) const {
+        return m_Shards[GetShardIndex(key)];
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    std::unique_lock<std::mutex> ShardedTree<Engine, Key, Value>::Lock(const Shard& shard) const {
+        std::unique_lock<std::mutex> lock(shard.Mutex, std::try_to_lock);
+
+        if (!lock.owns_lock()) {
+            shard.ContendedCount.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+
+        return lock;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    std::vector<std::unique_lock<std::mutex>> ShardedTree<Engine, Key, Value>::LockAll() const {
+        // always in index order, so two walks cannot deadlock
+        std::vector<std::unique_lock<std::mutex>> locks;
+
+        locks.reserve(static_cast<std::size_t>(m_ShardCount));
+
+        for (int i = 0; i < m_ShardCount; ++i)
+            locks.push_back(Lock(m_Shards[i]));
+
+        return locks;
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    template <typename Function>
+    void ShardedTree<Engine, Key, Value>::Merge(Function& function) const {
+        // ranges are already ordered shard after shard
+        if (m_Partitioning == Partitioning::Range) {
+            for (int i = 0; i < m_ShardCount; ++i) {
+                const Tree& tree = m_Shards[i].Storage;
+
+                for (const auto& pair : tree)
+                    function(pair.first, pair.second);
+            }
+
+            return;
+        }
+
+        // hashed shards interleave, a heap of cursors merges them
+        using ConstIterator = decltype(std::declval<const Tree&>().begin());
+        using Cursor        = std::pair<ConstIterator, ConstIterator>;
+
+        const auto isGreater = [](const Cursor& lhs, const Cursor& rhs) { return (*lhs.first).first > (*rhs.first).first; };
+
+        std::vector<Cursor> cursors;
+
+        cursors.reserve(static_cast<std::size_t>(m_ShardCount));
+
+        for (int i = 0; i < m_ShardCount; ++i) {
+            const Tree& tree = m_Shards[i].Storage;
+
+            if (tree.begin() != tree.end())
+                cursors.emplace_back(tree.begin(), tree.end());
+        }
+
+        std::make_heap(cursors.begin(), cursors.end(), isGreater);
+
+        while (!cursors.empty()) {
+            std::pop_heap(cursors.begin(), cursors.end(), isGreater);
+
+            Cursor& cursor = cursors.back();
+
+            function((*cursor.first).first, (*cursor.first).second);
+
+            if (++cursor.first == cursor.second)
+                cursors.pop_back();
+            else
+                std::push_heap(cursors.begin(), cursors.end(), isGreater);
+        }
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    int ShardedTree<Engine, Key, Value>::GetHashShardIndex(const ShardedTree& tree, const Key& key) {
+        return static_cast<int>(Mix(std::hash<Key>()(key)) % static_cast<std::uint64_t>(tree.m_ShardCount));
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    int ShardedTree<Engine, Key, Value>::GetRangeShardIndex(const ShardedTree& tree, const Key& key) {
+        // the first splitter greater than key closes its shard
+        const auto splitter = std::upper_bound(tree.m_Splitters.begin(), tree.m_Splitters.end(), key, [](const Key& lhs, const Key& rhs) { return rhs > lhs; });
+
+        return static_cast<int>(splitter - tree.m_Splitters.begin());
+    }
+
+    template <template <typename, typename> typename Engine, typename Key, typename Value>
+    std::uint64_t ShardedTree<Engine, Key, Value>::Mix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value  = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value  = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+
+        return value ^ (value >> 31);
+    }
+
+} // namespace DataStructures
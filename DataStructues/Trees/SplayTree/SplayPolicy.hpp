@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+namespace DataStructures {
+
+    // Decides whether an access to an existing key splays it:
+    //     Always         - every access, the classic splay tree
+    //     Never          - no access, reads leave the tree untouched
+    //     Probabilistic  - about rate of the accesses
+    //     Periodic       - every period-th access
+    //     DepthThreshold - accesses that find the node deeper than depth, which
+    //                      semi-splay it: the path is about halved instead of the
+    //                      node brought up to the root
+    // The decision only touches an atomic access counter, and only for the
+    // counting modes, so it is safe to make from readers sharing a lock.
+    class SplayPolicy {
+    public:
+        enum class Mode : int {
+            Always = 0,
+            Never,
+            Probabilistic,
+            Periodic,
+            DepthThreshold
+        };
+
+        SplayPolicy()
+            : m_Mode(Mode::Always)
+            , m_Parameter(0)
+            , m_AccessCount(0) {}
+
+        SplayPolicy(const SplayPolicy& other)
+            : m_Mode(other.m_Mode)
+            , m_Parameter(other.m_Parameter)
+            , m_AccessCount(other.m_AccessCount.load(std::memory_order_relaxed)) {}
+
+        SplayPolicy& operator =(const SplayPolicy& other) {
+            m_Mode      = other.m_Mode;
+            m_Parameter = other.m_Parameter;
+
+            m_AccessCount.store(other.m_AccessCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            return *this;
+        }
+
+        [[nodiscard]] static SplayPolicy Always() { return SplayPolicy(Mode::Always, 0); }
+        [[nodiscard]] static SplayPolicy Never() { return SplayPolicy(Mode::Never, 0); }
+
+        [[nodiscard]] static SplayPolicy Probabilistic(double rate) {
+            if (!(rate >= 0.0 && rate <= 1.0))
+                throw std::invalid_argument("Ng::SplayPolicy::Probabilistic: rate is out of [0, 1]!");
+
+            // the rate becomes a threshold for a 64-bit hash, 2^64 itself saturates
+            const double threshold = rate * 18446744073709551616.0;
+
+            return SplayPolicy(Mode::Probabilistic, threshold >= 18446744073709551615.0 ? UINT64_MAX : static_cast<std::uint64_t>(threshold));
+        }
+
+        [[nodiscard]] static SplayPolicy Periodic(int period) {
+            if (period < 1)
+                throw std::invalid_argument("Ng::SplayPolicy::Periodic: period is less than 1!");
+
+            return SplayPolicy(Mode::Periodic, static_cast<std::uint64_t>(period));
+        }
+
+        [[nodiscard]] static SplayPolicy DepthThreshold(int depth) {
+            if (depth < 0)
+                throw std::invalid_argument("Ng::SplayPolicy::DepthThreshold: depth is negative!");
+
+            return SplayPolicy(Mode::DepthThreshold, static_cast<std::uint64_t>(depth));
+        }
+
+        [[nodiscard]] inline Mode GetMode() const { return m_Mode; }
+
+        // depth counts the edges from the root, it is only read by DepthThreshold
+        [[nodiscard]] bool IsSplayNeeded(int depth) const {
+            switch (m_Mode) {
+                case Mode::Always:         return true;
+                case Mode::Never:          return false;
+                case Mode::Probabilistic:  return m_Parameter == UINT64_MAX || Mix(Count()) < m_Parameter;
+                case Mode::Periodic:       return (Count() + 1) % m_Parameter == 0;
+                case Mode::DepthThreshold: return static_cast<std::uint64_t>(depth) > m_Parameter;
+            }
+
+            return true;
+        }
+
+    private:
+        SplayPolicy(Mode mode, std::uint64_t parameter)
+            : m_Mode(mode)
+            , m_Parameter(parameter)
+            , m_AccessCount(0) {}
+
+        [[nodiscard]] std::uint64_t Count() const {
+            return m_AccessCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // SplitMix64 finalizer, consecutive counts map to well spread hashes
+        [[nodiscard]] static std::uint64_t Mix(std::uint64_t value) {
+            value += 0x9E3779B97F4A7C15ull;
+            value  = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value  = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+
+            return value ^ (value >> 31);
+        }
+
+    private:
+        Mode                               m_Mode;
+        std::uint64_t                      m_Parameter;
+        mutable std::atomic<std::uint64_t> m_AccessCount;
+
+    }; // class SplayPolicy
+
+} // namespace DataStructures
@@ -1,24 +1,43 @@
 #pragma once
 
-#include "ITree.hpp"
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "../Common/ITree.hpp"
+#include "../Common/InterleavedSearch.hpp"
+#include "../Common/KeyCompare.hpp"
+#include "../Common/NodePool.hpp"
+#include "../Common/SubtreeSize.hpp"
+#include "../Common/SubtreeSummary.hpp"
+#include "../FrozenTree/FrozenTree.hpp"
+#include "../TreeImage/TreeImage.hpp"
+
+#include "SplayPolicy.hpp"
 
 namespace DataStructures {
 
-    template <typename Key, typename Value>
+    template <typename Key,
+              typename Value,
+              bool HasOrderStatistics = false,
+              typename Monoid = void,
+              template <typename> typename Allocator = NodePool,
+              typename Compare = KeyLess<Key>>
     class SplayTree : public ITree<Key, Value> {
     public:
-        using Pair = std::pair<const Key, Value>;
+        using Pair    = std::pair<const Key, Value>;
+        using Summary = typename SubtreeSummary<Monoid>::Type;
 
-        class Node {
+        // With 64-bit pointers a node takes sizeof(Pair) rounded up to 8 bytes
+        // plus 24 bytes of links (32 bytes for int keys and values).
+        class Node : public SubtreeSize<HasOrderStatistics>, public SubtreeSummary<Monoid> {
         public:
 
-            Node();
-            Node(const Key& key,
-                 const Value& value,
-                 Node* parent = nullptr,
-                 Node* left   = nullptr,
-                 Node* right  = nullptr);
-            virtual ~Node();
+            template <typename... Args>
+            explicit Node(Args&&... args);
 
             [[nodiscard]] inline const Key& GetKey() const { return m_Pair.first; }
             [[nodiscard]] inline const Value& GetValue() const { return m_Pair.second; }
@@ -41,15 +60,22 @@ namespace DataStructures {
 
         class Iterator {
         public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Pair;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = Pair*;
+            using reference         = Pair&;
+
             explicit Iterator(Node* node = nullptr);
             virtual ~Iterator() = default;
 
             [[nodiscard]] inline Pair& operator *() { return m_Node->m_Pair; }
-            [[nodiscard]] inline Pair* operator ->() { return *m_Node->m_Pair; }
+            [[nodiscard]] inline Pair* operator ->() { return &m_Node->m_Pair; }
 
             Iterator& operator ++();
             Iterator& operator +=(int n);
 
+            bool operator ==(const Iterator& other) const;
             bool operator !=(const Iterator& other) const;
 
         private:
@@ -59,15 +85,22 @@ namespace DataStructures {
 
         class ConstIterator {
         public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Pair;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Pair*;
+            using reference         = const Pair&;
+
             explicit ConstIterator(Node* node = nullptr);
             virtual ~ConstIterator() = default;
 
             [[nodiscard]] inline const Pair& operator *() const { return m_Node->m_Pair; }
-            [[nodiscard]] inline const Pair* operator ->() const { return *m_Node->m_Pair; }
+            [[nodiscard]] inline const Pair* operator ->() const { return &m_Node->m_Pair; }
 
             ConstIterator& operator ++();
             ConstIterator& operator +=(int n);
 
+            bool operator ==(const ConstIterator& other) const;
             bool operator !=(const ConstIterator& other) const;
 
         private:
@@ -75,12 +108,48 @@ namespace DataStructures {
 
         }; // class ConstIterator
 
-        explicit SplayTree(Node* root = nullptr);
+        SplayTree();
+        explicit SplayTree(const Compare& compare);
+        SplayTree(const SplayTree& other) = delete;
+        SplayTree(SplayTree&& other) noexcept;
         ~SplayTree() override;
 
-        [[nodiscard]] inline bool IsEmpty() const override { return m_Size == 0; };
-        [[nodiscard]] inline int GetSize() const override { return m_Size; };
+        SplayTree& operator =(const SplayTree& other) = delete;
+        SplayTree& operator =(SplayTree&& other) noexcept;
+
+        // Builds a balanced tree in O(n) from pairs sorted by strictly increasing key.
+        template <typename ForwardIterator>
+        [[nodiscard]] static SplayTree FromSorted(ForwardIterator first, ForwardIterator last, const Compare& compare = Compare());
+
+        // Copies the pairs into an immutable pointer-free snapshot in O(n). Like
+        // Save and Load it needs the keys ordered by operator >.
+        [[nodiscard]] FrozenTree<Key, Value> Freeze() const;
+
+        // Save writes the pairs to a TreeImage file. Load maps one and builds the
+        // tree in O(n) with FromSorted, reserving the nodes in one go; to serve
+        // the file without building a tree open it as a TreeImage instead.
+        void Save(const std::string& path) const;
+        [[nodiscard]] static SplayTree Load(const std::string& path);
+
+        // Split moves the keys less than key into the first tree and the rest into
+        // the second after splaying the boundary, leaving this tree empty. Join is
+        // the inverse and needs every key of left to be less than every key of
+        // right. Without order statistics the split trees do not know their sizes:
+        // GetSize on them, or on trees joined from them, counts the nodes in O(n)
+        // on every call without writing to the tree, until it is cleared.
+        [[nodiscard]] std::pair<SplayTree, SplayTree> Split(const Key& key);
+        [[nodiscard]] static SplayTree Join(SplayTree&& left, SplayTree&& right);
+
+        // Detach the keys in [lo, hi] with two splays: EraseRange frees them in
+        // O(k) and returns their count, ExtractRange hands them over as a tree and
+        // counts them in O(k) to keep both sizes.
+        int EraseRange(const Key& lo, const Key& hi);
+        [[nodiscard]] SplayTree ExtractRange(const Key& lo, const Key& hi);
+
+        [[nodiscard]] inline bool IsEmpty() const override { return !m_Root; };
+        [[nodiscard]] int GetSize() const override;
         [[nodiscard]] inline const Node* GetRoot() const { return m_Root; }
+        [[nodiscard]] inline const Compare& GetCompare() const { return m_Compare; }
 
         [[nodiscard]] bool IsExists(const Key& key) const;
         [[nodiscard]] int GetHeight() const;
@@ -91,10 +160,66 @@ namespace DataStructures {
         [[nodiscard]] Value& Get(const Key& key);
         [[nodiscard]] const Value& Get(const Key& key) const;
 
+        // Accesses to existing keys through Get, Push, operator [], Emplace and
+        // TryEmplace splay as the policy says, inserts and removals always do.
+        // Under SplayPolicy::Never those accesses never write the tree. Peek never
+        // restructures, so readers under a shared lock can use it with any policy:
+        // it returns the value, or nullptr, and whether the policy wants the key
+        // splayed, which is done by Touch once the lock is held exclusively.
+        void SetSplayPolicy(const SplayPolicy& policy) { m_SplayPolicy = policy; }
+        [[nodiscard]] inline const SplayPolicy& GetSplayPolicy() const { return m_SplayPolicy; }
+
+        [[nodiscard]] std::pair<const Value*, bool> Peek(const Key& key) const;
+        void Touch(const Key& key);
+
         void Clear();
 
-        Value& Push(const Key& key, const Value& value);
-        void Pop(const Key& key);
+        Value& Push(const Key& key, Value value) override;
+        Value& Push(Key&& key, Value value) override;
+        void Pop(const Key& key) override;
+
+        // With a transparent Compare, like KeyLess<> or std::less<>, these take
+        // anything it compares with Key and never build a Key to look it up.
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] bool IsExists(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] Value& Get(const KeyLike& key);
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] const Value& Get(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        [[nodiscard]] std::pair<const Value*, bool> Peek(const KeyLike& key) const;
+        template <typename KeyLike, typename = EnableIfTransparent<Compare, KeyLike>>
+        void Pop(const KeyLike& key);
+
+        // Batched Push, Get and IsExists for many keys at once. The descents run
+        // interleaved and prefetch their next node, so their cache misses overlap.
+        // Missing keys give nullptr and false. PushBatch first walks a group of
+        // keys to pull their paths into the cache and then pushes them one by one.
+        // The non-const GetBatch accesses the found keys after the descents of a
+        // group, in key order, as the splay policy says.
+        void PushBatch(const Key* keys, const Value* values, std::size_t count);
+        void GetBatch(const Key* keys, std::size_t count, Value** values);
+        void GetBatch(const Key* keys, std::size_t count, const Value** values) const;
+        void ContainsBatch(const Key* keys, std::size_t count, bool* isExists) const;
+
+        template <typename... Args>
+        std::pair<Iterator, bool> Emplace(Args&&... args);
+
+        template <typename... Args>
+        std::pair<Iterator, bool> TryEmplace(const Key& key, Args&&... args);
+
+        template <typename... Args>
+        std::pair<Iterator, bool> TryEmplace(Key&& key, Args&&... args);
+
+        // Rank counts the keys less than key and Select returns the element at
+        // a zero-based index; both need HasOrderStatistics and splay the node they stop at.
+        [[nodiscard]] int Rank(const Key& key);
+        [[nodiscard]] Iterator Select(int index);
+
+        // Folds the Monoid over the keys in [lo, hi]. Values changed in place have
+        // to be followed by Refresh(key) to keep the summaries up to date.
+        [[nodiscard]] Summary RangeQuery(const Key& lo, const Key& hi);
+        void Refresh(const Key& key);
 
         [[nodiscard]] Iterator begin() { return Iterator(GetMinNode(m_Root)); }
         [[nodiscard]] Iterator end() { return Iterator(); }
@@ -106,11 +231,16 @@ namespace DataStructures {
         [[nodiscard]] ConstIterator cend() const { return ConstIterator(); }
 
         Value& operator [](const Key& key);
+        Value& operator [](Key&& key);
 
-        template <typename Key_, typename Value_>
-        friend std::ostream& operator <<(std::ostream& ostream, const SplayTree<Key_, Value_>& tree);
+        template <typename Key_, typename Value_, bool HasOrderStatistics_, typename Monoid_, template <typename> typename Allocator_, typename Compare_>
+        friend std::ostream& operator <<(std::ostream& ostream, const SplayTree<Key_, Value_, HasOrderStatistics_, Monoid_, Allocator_, Compare_>& tree);
 
     private:
+        static constexpr bool        IsAugmented    = HasOrderStatistics || !std::is_void_v<Monoid>;
+        static constexpr int         UnknownSize    = -1;
+        static constexpr std::size_t BatchGroupSize = 64;
+
         [[nodiscard]] int GetHeight(Node* node) const;
 
         [[nodiscard]] const Value& GetMin(Node* node) const;
@@ -122,7 +252,30 @@ namespace DataStructures {
         [[nodiscard]] Node* GetSuccessor(Node* node) const;
         [[nodiscard]] Node* GetPredecessor(Node* node) const;
 
-        [[nodiscard]] Node* GetNode(const Key& key);
+        template <typename KeyLike>
+        [[nodiscard]] Node* GetNode(const KeyLike& key);
+        template <typename KeyLike>
+        [[nodiscard]] Node* FindNode(const KeyLike& key) const;
+        template <typename KeyLike>
+        [[nodiscard]] Node* FindNode(const KeyLike& key, int& depth) const;
+        [[nodiscard]] Node* FindNode(const Key& key, Node*& parent, int& depth) const;
+
+        template <typename KeyArg, typename... Args>
+        std::pair<Node*, bool> TryInsert(KeyArg&& key, Args&&... args);
+        void Attach(Node* node, Node* parent);
+        // depth is the one the descent found node at
+        void Access(Node* node, int depth);
+        void Restructure(Node* node);
+
+        [[nodiscard]] static int GetSubtreeSize(const Node* node);
+        [[nodiscard]] static int GetIndex(const Node* node);
+        [[nodiscard]] static Node* GetNodeAt(Node* node, int index);
+        [[nodiscard]] static Summary GetSummary(const Node* node);
+        [[nodiscard]] static int GetTreeSize(const Node* root);
+        [[nodiscard]] int CountNodes(Node* root) const;
+
+        static void Update(Node* node);
+        static void UpdatePath(Node* node);
 
         void Transplant(Node* parent, Node* child);
 
@@ -133,14 +286,26 @@ namespace DataStructures {
         void ZigZag(Node* node);
         void ZigZig(Node* node);
         void Splay(Node* node);
+        void SemiSplay(Node* node);
 
+        void Erase(Node* node);
         void Merge(Node* left, Node* right);
+        Node* CutLeft(const Key& key, bool isInclusive);
+        Node* CutRange(const Key& lo, const Key& hi);
+
+        template <typename ForwardIterator>
+        Node* Build(ForwardIterator& iterator, std::size_t count);
+
+        int Destroy(Node* node);
 
         void Print(const Node* node, int level, const char* caption, std::ostream& ostream) const;
 
     private:
-        Node* m_Root;
-        int   m_Size;
+        Allocator<Node> m_Allocator;
+        Compare         m_Compare;
+        SplayPolicy     m_SplayPolicy;
+        Node*           m_Root;
+        int             m_Size;
 
     }; // class SplayTree
 
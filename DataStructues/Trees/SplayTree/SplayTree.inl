@@ -1,32 +1,24 @@
+#include <algorithm>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace DataStructures {
 
     ///////////////////////////////////////////////////////////////////////////////
     /// class SplayTree::Node
     ///////////////////////////////////////////////////////////////////////////////
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::Node::Node()
-        : m_Pair(Key(), Value())
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename... Args>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node::Node(Args&&... args)
+        : m_Pair(std::forward<Args>(args)...)
         , m_Parent(nullptr)
         , m_Left(nullptr)
         , m_Right(nullptr) {}
 
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::Node::Node(const Key& key, const Value& value, Node* parent, Node* left, Node* right)
-        : m_Pair(key, value)
-        , m_Parent(parent)
-        , m_Left(left)
-        , m_Right(right) {}
-
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::Node::~Node() {
-        delete m_Left;
-        delete m_Right;
-    }
-
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Node::Print(std::ostream& ostream) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node::Print(std::ostream& ostream) const {
         ostream << "Key: " << m_Pair.first << ", Value " << m_Pair.second << " {L: ";
 
         ostream << (m_Left  ? m_Left->m_Pair.first  : "Null") << ", R: ";
@@ -36,12 +28,12 @@ namespace DataStructures {
     ///////////////////////////////////////////////////////////////////////////////
     /// class SplayTree::Iterator
     ///////////////////////////////////////////////////////////////////////////////
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::Iterator::Iterator(Node* node)
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::Iterator(Node* node)
         : m_Node(node) {}
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Iterator& SplayTree<Key, Value>::Iterator::operator ++() {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator ++() {
         if (m_Node->m_Right) {
             m_Node = m_Node->m_Right;
 
@@ -61,28 +53,45 @@ namespace DataStructures {
         return *this;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Iterator& SplayTree<Key, Value>::Iterator::operator +=(int n) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator +=(int n) {
+        if constexpr (HasOrderStatistics) {
+            Node* root = m_Node;
+
+            while (root && root->m_Parent)
+                root = root->m_Parent;
+
+            if (m_Node)
+                m_Node = GetNodeAt(root, GetIndex(m_Node) + n);
+
+            return *this;
+        }
+
         for (int i = 0; i < n; i++)
-            (*this)++;
+            ++(*this);
 
         return *this;
     }
 
-    template <typename Key, typename Value>
-    bool SplayTree<Key, Value>::Iterator::operator !=(const Iterator& other) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator ==(const Iterator& other) const {
+        return m_Node == other.m_Node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator::operator !=(const Iterator& other) const {
         return m_Node != other.m_Node;
     }
 
     ///////////////////////////////////////////////////////////////////////////////
     /// class SplayTree::ConstIterator
     ///////////////////////////////////////////////////////////////////////////////
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::ConstIterator::ConstIterator(Node* node)
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::ConstIterator(Node* node)
         : m_Node(node) {}
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::ConstIterator& SplayTree<Key, Value>::ConstIterator::operator ++() {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator ++() {
         if (m_Node->m_Right) {
             m_Node = m_Node->m_Right;
 
@@ -102,84 +111,264 @@ namespace DataStructures {
         return *this;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::ConstIterator& SplayTree<Key, Value>::ConstIterator::operator +=(int n) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator +=(int n) {
+        if constexpr (HasOrderStatistics) {
+            Node* root = m_Node;
+
+            while (root && root->m_Parent)
+                root = root->m_Parent;
+
+            if (m_Node)
+                m_Node = GetNodeAt(root, GetIndex(m_Node) + n);
+
+            return *this;
+        }
+
         for (int i = 0; i < n; i++)
-            (*this)++;
+            ++(*this);
 
         return *this;
     }
 
-    template <typename Key, typename Value>
-    bool SplayTree<Key, Value>::ConstIterator::operator !=(const ConstIterator& other) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Node == other.m_Node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ConstIterator::operator !=(const ConstIterator& other) const {
         return m_Node != other.m_Node;
     }
 
     ///////////////////////////////////////////////////////////////////////////////
     /// class SplayTree
     ///////////////////////////////////////////////////////////////////////////////
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::SplayTree(Node* root)
-        : m_Root(root)
-        , m_Size(root ? 1 : 0) { }
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SplayTree()
+        : m_Root(nullptr)
+        , m_Size(0) {}
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SplayTree(const Compare& compare)
+        : m_Compare(compare)
+        , m_Root(nullptr)
+        , m_Size(0) {}
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SplayTree(SplayTree&& other) noexcept
+        : m_Allocator(std::move(other.m_Allocator))
+        , m_Compare(std::move(other.m_Compare))
+        , m_SplayPolicy(other.m_SplayPolicy)
+        , m_Root(std::exchange(other.m_Root, nullptr))
+        , m_Size(std::exchange(other.m_Size, 0)) {}
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::~SplayTree() {
+        Clear();
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator =(SplayTree&& other) noexcept {
+        if (this == &other)
+            return *this;
 
-    template <typename Key, typename Value>
-    SplayTree<Key, Value>::~SplayTree() {
         Clear();
+
+        m_Allocator   = std::move(other.m_Allocator);
+        m_Compare     = std::move(other.m_Compare);
+        m_SplayPolicy = other.m_SplayPolicy;
+        m_Root        = std::exchange(other.m_Root, nullptr);
+        m_Size        = std::exchange(other.m_Size, 0);
+
+        return *this;
     }
 
-    template <typename Key, typename Value>
-    bool SplayTree<Key, Value>::IsExists(const Key& key) const {
-        Node* node = m_Root;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename ForwardIterator>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FromSorted(ForwardIterator first, ForwardIterator last, const Compare& compare) {
+        const auto isNotIncreasing = [&compare](const auto& lhs, const auto& rhs) { return !IsLess(compare, lhs.first, rhs.first); };
 
-        while (node && key != node->m_Pair.first)
-            node = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+        if (std::adjacent_find(first, last, isNotIncreasing) != last)
+            throw std::invalid_argument("Ng::SplayTree::FromSorted: keys are not strictly increasing!");
 
-        return node;
+        SplayTree tree(compare);
+
+        const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+        tree.m_Allocator.Reserve(count);
+
+        tree.m_Root = tree.Build(first, count);
+        tree.m_Size = static_cast<int>(count);
+
+        return tree;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    FrozenTree<Key, Value> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Freeze() const {
+        static_assert(IsNaturalOrder<Compare, Key>, "Ng::SplayTree::Freeze: FrozenTree orders keys by operator >!");
+
+        return FrozenTree<Key, Value>::FromSorted(begin(), end());
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Save(const std::string& path) const {
+        static_assert(IsNaturalOrder<Compare, Key>, "Ng::SplayTree::Save: TreeImage orders keys by operator >!");
+
+        TreeImage<Key, Value>::Save(path, begin(), end());
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Load(const std::string& path) {
+        static_assert(IsNaturalOrder<Compare, Key>, "Ng::SplayTree::Load: TreeImage orders keys by operator >!");
+
+        const TreeImage<Key, Value> image = TreeImage<Key, Value>::Open(path);
+
+        return FromSorted(image.begin(), image.end());
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    std::pair<SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>, SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Split(const Key& key) {
+        std::pair<SplayTree, SplayTree> trees { SplayTree(m_Compare), SplayTree(m_Compare) };
+
+        trees.first.m_Root  = CutLeft(key, false);
+        trees.second.m_Root = std::exchange(m_Root, nullptr);
+
+        trees.first.m_Size  = GetTreeSize(trees.first.m_Root);
+        trees.second.m_Size = GetTreeSize(trees.second.m_Root);
+
+        if (m_Size != UnknownSize && !trees.first.m_Root)
+            trees.second.m_Size = m_Size;
+
+        if (m_Size != UnknownSize && !trees.second.m_Root)
+            trees.first.m_Size = m_Size;
+
+        trees.second.m_Allocator = m_Allocator.Share();
+        trees.first.m_Allocator  = std::move(m_Allocator);
+
+        trees.first.m_SplayPolicy  = m_SplayPolicy;
+        trees.second.m_SplayPolicy = m_SplayPolicy;
+
+        m_Root = nullptr;
+        m_Size = 0;
+
+        return trees;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Join(SplayTree&& left, SplayTree&& right) {
+        if (left.m_Root && right.m_Root && !IsLess(left.m_Compare, left.GetMaxNode(left.m_Root)->m_Pair.first, right.GetMinNode(right.m_Root)->m_Pair.first))
+            throw std::invalid_argument("Ng::SplayTree::Join: keys of left are not less than keys of right!");
+
+        SplayTree tree(left.m_Compare);
+
+        tree.m_Allocator = std::move(left.m_Allocator);
+        tree.m_Allocator.Adopt(std::move(right.m_Allocator));
+
+        tree.m_SplayPolicy = left.m_SplayPolicy;
+
+        const int leftSize  = std::exchange(left.m_Size, 0);
+        const int rightSize = std::exchange(right.m_Size, 0);
+
+        tree.m_Size = leftSize != UnknownSize && rightSize != UnknownSize ? leftSize + rightSize : UnknownSize;
+
+        Node* leftRoot  = std::exchange(left.m_Root, nullptr);
+        Node* rightRoot = std::exchange(right.m_Root, nullptr);
+
+        if (!leftRoot || !rightRoot)
+            tree.m_Root = leftRoot ? leftRoot : rightRoot;
+        else
+            tree.Merge(leftRoot, rightRoot);
+
+        return tree;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::EraseRange(const Key& lo, const Key& hi) {
+        if (IsLess(m_Compare, hi, lo))
+            return 0;
+
+        const int count = Destroy(CutRange(lo, hi));
+
+        if (m_Size != UnknownSize)
+            m_Size -= count;
+
+        return count;
     }
 
-    template <typename Key, typename Value>
-    int SplayTree<Key, Value>::GetHeight() const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ExtractRange(const Key& lo, const Key& hi) {
+        SplayTree tree(m_Compare);
+
+        tree.m_SplayPolicy = m_SplayPolicy;
+
+        if (IsLess(m_Compare, hi, lo))
+            return tree;
+
+        tree.m_Root = CutRange(lo, hi);
+
+        if (!tree.m_Root)
+            return tree;
+
+        tree.m_Allocator = m_Allocator.Share();
+
+        tree.m_Size = CountNodes(tree.m_Root);
+
+        if (m_Size != UnknownSize)
+            m_Size -= tree.m_Size;
+
+        return tree;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSize() const {
+        // counted on every call rather than stored, readers sharing the tree under
+        // a shared lock must not write to it
+        return m_Size != UnknownSize ? m_Size : CountNodes(m_Root);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::IsExists(const Key& key) const {
+        return FindNode(key);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetHeight() const {
         return GetHeight(m_Root);
     }
 
-    template <typename Key, typename Value>
-    const Value& SplayTree<Key, Value>::GetMin() const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMin() const {
         if (!m_Root)
             throw std::out_of_range("Ng::SplayTree::GetMin: m_Root is nullptr!");
 
         return GetMin(m_Root);
     }
 
-    template <typename Key, typename Value>
-    const Value& SplayTree<Key, Value>::GetMax() const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMax() const {
         if (!m_Root)
             throw std::out_of_range("Ng::SplayTree::GetMax: m_Root is nullptr!");
 
         return GetMax(m_Root);
     }
 
-    template <typename Key, typename Value>
-    Value& SplayTree<Key, Value>::Get(const Key& key) {
-        Node* node = m_Root;
-
-        while (node && key != node->m_Pair.first)
-            node = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const Key& key) {
+        int   depth = 0;
+        Node* node  = FindNode(key, depth);
 
         if (!node)
             throw std::out_of_range("Ng::SplayTree::Get: key is not exists!");
 
-        Splay(node);
+        Access(node, depth);
 
         return node->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    const Value& SplayTree<Key, Value>::Get(const Key& key) const {
-        Node* node = m_Root;
-
-        while (node && key != node->m_Pair.first)
-            node = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const Key& key) const {
+        const Node* node = FindNode(key);
 
         if (!node)
             throw std::out_of_range("Ng::SplayTree::Get: key is not exists!");
@@ -187,116 +376,378 @@ namespace DataStructures {
         return node->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Clear() {
-        delete m_Root;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    std::pair<const Value*, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Peek(const Key& key) const {
+        int         depth = 0;
+        const Node* node  = FindNode(key, depth);
+
+        if (!node)
+            return { nullptr, false };
+
+        return { &node->m_Pair.second, node != m_Root && m_SplayPolicy.IsSplayNeeded(depth) };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Touch(const Key& key) {
+        int   depth = 0;
+        Node* node  = FindNode(key, depth);
+
+        if (node)
+            Restructure(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Clear() {
+        // Nodes without destructors to run are dropped together with the pool chunks,
+        // unless the chunks are shared with split trees and outlive this one.
+        if constexpr (!std::is_trivially_destructible_v<Node> || !Allocator<Node>::IsBulkReleasable)
+            Destroy(m_Root);
+        else if (m_Allocator.IsShared())
+            Destroy(m_Root);
+
+        m_Allocator.Release();
+
         m_Root = nullptr;
+        m_Size = 0;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Push(const Key& key, Value value) {
+        return TryInsert(key, std::move(value)).first->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    Value& SplayTree<Key, Value>::Push(const Key& key, const Value& value) {
-        ++m_Size;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Push(Key&& key, Value value) {
+        return TryInsert(std::move(key), std::move(value)).first->m_Pair.second;
+    }
 
-        if (!m_Root)
-            return (m_Root = new Node(key, value))->m_Pair.second;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Pop(const Key& key) {
+        if (Node* node = GetNode(key))
+            Erase(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike, typename>
+    bool SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::IsExists(const KeyLike& key) const {
+        return FindNode(key);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike, typename>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const KeyLike& key) {
+        int   depth = 0;
+        Node* node  = FindNode(key, depth);
+
+        if (!node)
+            throw std::out_of_range("Ng::SplayTree::Get: key is not exists!");
+
+        Access(node, depth);
+
+        return node->m_Pair.second;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike, typename>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Get(const KeyLike& key) const {
+        const Node* node = FindNode(key);
+
+        if (!node)
+            throw std::out_of_range("Ng::SplayTree::Get: key is not exists!");
+
+        return node->m_Pair.second;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike, typename>
+    std::pair<const Value*, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Peek(const KeyLike& key) const {
+        int         depth = 0;
+        const Node* node  = FindNode(key, depth);
+
+        if (!node)
+            return { nullptr, false };
+
+        return { &node->m_Pair.second, node != m_Root && m_SplayPolicy.IsSplayNeeded(depth) };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike, typename>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Pop(const KeyLike& key) {
+        if (Node* node = GetNode(key))
+            Erase(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::PushBatch(const Key* keys, const Value* values, std::size_t count) {
+        const auto descend = [this](Node* node, const Key& key) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+        };
+
+        // Every push splays, so only the reads run ahead: the descents of a group
+        // pull its paths into the cache, then the group is pushed in order. Keys
+        // found are only accessed, splays move nodes but never free them.
+        Node* nodes[BatchGroupSize];
+        int   depths[BatchGroupSize];
+
+        for (std::size_t first = 0; first < count; first += BatchGroupSize) {
+            const std::size_t size = std::min(BatchGroupSize, count - first);
+
+            InterleavedSearch(m_Root, keys + first, size, descend, [&nodes, &depths](std::size_t index, Node* node, int depth) {
+                nodes[index]  = node;
+                depths[index] = depth;
+            });
+
+            for (std::size_t i = 0; i < size; ++i) {
+                if (nodes[i])
+                    Access(nodes[i], depths[i]);
+                else
+                    Push(keys[first + i], values[first + i]);
+            }
+        }
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetBatch(const Key* keys, std::size_t count, Value** values) {
+        const auto descend = [this](Node* node, const Key& key) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+        };
+
+        // A splay in the middle of the descents would move nodes under the other
+        // lanes, so a group is searched first and accessed afterwards.
+        Node* nodes[BatchGroupSize];
+        int   depths[BatchGroupSize];
+
+        for (std::size_t first = 0; first < count; first += BatchGroupSize) {
+            const std::size_t size = std::min(BatchGroupSize, count - first);
+
+            InterleavedSearch(m_Root, keys + first, size, descend, [&nodes, &depths](std::size_t index, Node* node, int depth) {
+                nodes[index]  = node;
+                depths[index] = depth;
+            });
+
+            for (std::size_t i = 0; i < size; ++i) {
+                values[first + i] = nodes[i] ? &nodes[i]->m_Pair.second : nullptr;
+
+                if (nodes[i])
+                    Access(nodes[i], depths[i]);
+            }
+        }
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetBatch(const Key* keys, std::size_t count, const Value** values) const {
+        const auto descend = [this](Node* node, const Key& key) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+        };
 
-        Node* node   = m_Root;
+        InterleavedSearch(m_Root, keys, count, descend, [values](std::size_t index, Node* node, int) {
+            values[index] = node ? &node->m_Pair.second : nullptr;
+        });
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ContainsBatch(const Key* keys, std::size_t count, bool* isExists) const {
+        const auto descend = [this](Node* node, const Key& key) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            return order < 0 ? node->m_Left : (order > 0 ? node->m_Right : node);
+        };
+
+        InterleavedSearch(m_Root, keys, count, descend, [isExists](std::size_t index, Node* node, int) {
+            isExists[index] = node != nullptr;
+        });
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename... Args>
+    std::pair<typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Emplace(Args&&... args) {
+        // the key is only known once the pair is built, so a duplicate costs one construction
+        Node* node   = m_Allocator.Allocate(std::forward<Args>(args)...);
         Node* parent = nullptr;
+        int   depth  = 0;
+
+        if (Node* existing = FindNode(node->m_Pair.first, parent, depth)) {
+            m_Allocator.Deallocate(node);
+            Access(existing, depth);
+
+            return { Iterator(existing), false };
+        }
+
+        Attach(node, parent);
+
+        return { Iterator(node), true };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename... Args>
+    std::pair<typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryEmplace(const Key& key, Args&&... args) {
+        auto [node, isInserted] = TryInsert(key, std::forward<Args>(args)...);
+
+        return { Iterator(node), isInserted };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename... Args>
+    std::pair<typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryEmplace(Key&& key, Args&&... args) {
+        auto [node, isInserted] = TryInsert(std::move(key), std::forward<Args>(args)...);
+
+        return { Iterator(node), isInserted };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Rank(const Key& key) {
+        static_assert(HasOrderStatistics, "Ng::SplayTree::Rank: the tree does not keep order statistics!");
+
+        Node* node  = m_Root;
+        Node* last  = nullptr;
+        int   order = 0;
 
         while (node) {
-            if (node->m_Pair.first == key) {
-                --m_Size;
-                Splay(node);
-                return node->m_Pair.second;
-            }
+            order = CompareKeys(m_Compare, key, node->m_Pair.first);
 
-            parent = node;
-            node   = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+            if (order == 0)
+                break;
+
+            last = node;
+            node = order < 0 ? node->m_Left : node->m_Right;
         }
 
-        node = new Node(key, value, parent);
+        // the node the descent stopped at becomes the root, so everything
+        // less than key is its left subtree, plus the root itself if it is less
+        if (node) {
+            Splay(node);
+            return GetSubtreeSize(node->m_Left);
+        }
 
-        if (parent->m_Pair.first > key)
-            parent->m_Left = node;
-        else
-            parent->m_Right = node;
+        if (!last)
+            return 0;
 
-        Splay(node);
+        Splay(last);
 
-        return node->m_Pair.second;
+        return GetSubtreeSize(last->m_Left) + (order > 0 ? 1 : 0);
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Pop(const Key& key) {
-        Node* node = GetNode(key);
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Summary SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RangeQuery(const Key& lo, const Key& hi) {
+        static_assert(!std::is_void_v<Monoid>, "Ng::SplayTree::RangeQuery: the tree has no monoid!");
 
-        if (!node)
-            return;
+        Node* node    = m_Root;
+        Node* deepest = nullptr;
 
-        --m_Size;
+        // descend to the topmost node inside the range, both bounds are then
+        // resolved on its left and right spines
+        while (node && (IsLess(m_Compare, node->m_Pair.first, lo) || IsLess(m_Compare, hi, node->m_Pair.first))) {
+            deepest = node;
+            node    = IsLess(m_Compare, node->m_Pair.first, lo) ? node->m_Right : node->m_Left;
+        }
 
-        Node* left  = node->m_Left;
-        Node* right = node->m_Right;
+        if (!node) {
+            Splay(deepest);
+            return Monoid::Identity();
+        }
 
-        if (!left && !right)
-            m_Root = nullptr;
-        else if (!left)
-            Transplant(node, right);
-        else if (!right)
-            Transplant(node, left);
-        else
-            Merge(node->m_Left, node->m_Right);
+        Summary left  = Monoid::Identity();
+        Summary right = Monoid::Identity();
 
-        node->m_Left  = nullptr;
-        node->m_Right = nullptr;
+        for (Node* current = node->m_Left; current; ) {
+            deepest = current;
 
-        delete node;
+            if (IsLess(m_Compare, current->m_Pair.first, lo)) {
+                current = current->m_Right;
+            } else {
+                left    = Monoid::Combine(Monoid::Combine(Monoid::Lift(current->m_Pair.first, current->m_Pair.second), GetSummary(current->m_Right)), left);
+                current = current->m_Left;
+            }
+        }
+
+        for (Node* current = node->m_Right; current; ) {
+            deepest = current;
+
+            if (IsLess(m_Compare, hi, current->m_Pair.first)) {
+                current = current->m_Left;
+            } else {
+                right   = Monoid::Combine(right, Monoid::Combine(GetSummary(current->m_Left), Monoid::Lift(current->m_Pair.first, current->m_Pair.second)));
+                current = current->m_Right;
+            }
+        }
+
+        // the result is already folded, splaying the deepest visited node only pays for the walk
+        Splay(deepest ? deepest : node);
+
+        return Monoid::Combine(Monoid::Combine(left, Monoid::Lift(node->m_Pair.first, node->m_Pair.second)), right);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Refresh(const Key& key) {
+        UpdatePath(GetNode(key));
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Iterator SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Select(int index) {
+        static_assert(HasOrderStatistics, "Ng::SplayTree::Select: the tree does not keep order statistics!");
+
+        Node* node = GetNodeAt(m_Root, index);
+
+        Splay(node);
+
+        return Iterator(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator [](const Key& key) {
+        return TryInsert(key).first->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    Value& SplayTree<Key, Value>::operator [](const Key& key) {
-        return Push(key, Value());
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::operator [](Key&& key) {
+        return TryInsert(std::move(key)).first->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    int SplayTree<Key, Value>::GetHeight(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetHeight(Node* node) const {
         return node ? std::max(GetHeight(node->m_Left), GetHeight(node->m_Right)) + 1 : 0;
     }
 
-    template <typename Key, typename Value>
-    const Value& SplayTree<Key, Value>::GetMin(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMin(Node* node) const {
         while (node && node->m_Left)
             node = node->m_Left;
 
         return node->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    const Value& SplayTree<Key, Value>::GetMax(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    const Value& SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMax(Node* node) const {
         while (node && node->m_Right)
             node = node->m_Right;
 
         return node->m_Pair.second;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::GetMinNode(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMinNode(Node* node) const {
         while (node && node->m_Left)
             node = node->m_Left;
 
         return node;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::GetMaxNode(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetMaxNode(Node* node) const {
         while (node && node->m_Right)
             node = node->m_Right;
 
         return node;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::GetSuccessor(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSuccessor(Node* node) const {
         if (node->m_Right)
             return GetMinNode(node->m_Right);
 
@@ -310,8 +761,8 @@ namespace DataStructures {
         return successor;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::GetPredecessor(Node* node) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetPredecessor(Node* node) const {
         if (node->m_Left)
             return GetMaxNode(node->m_Left);
 
@@ -325,12 +776,10 @@ namespace DataStructures {
         return predecessor;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::GetNode(const Key& key) {
-        Node* node = m_Root;
-
-        while (node && key != node->m_Pair.first)
-            node = node->m_Pair.first > key ? node->m_Left : node->m_Right;
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNode(const KeyLike& key) {
+        Node* node = FindNode(key);
 
         if (node)
             Splay(node);
@@ -338,8 +787,210 @@ namespace DataStructures {
         return node;
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Transplant(Node* parent, Node* child) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FindNode(const KeyLike& key) const {
+        Node* node = m_Root;
+
+        while (node) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            if (order == 0)
+                break;
+
+            node = order < 0 ? node->m_Left : node->m_Right;
+        }
+
+        return node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyLike>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FindNode(const KeyLike& key, int& depth) const {
+        Node* node = m_Root;
+
+        depth = 0;
+
+        while (node) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            if (order == 0)
+                break;
+
+            node = order < 0 ? node->m_Left : node->m_Right;
+            ++depth;
+        }
+
+        return node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::FindNode(const Key& key, Node*& parent, int& depth) const {
+        Node* node = m_Root;
+
+        parent = nullptr;
+        depth  = 0;
+
+        while (node) {
+            const int order = CompareKeys(m_Compare, key, node->m_Pair.first);
+
+            if (order == 0)
+                break;
+
+            parent = node;
+            node   = order < 0 ? node->m_Left : node->m_Right;
+
+            ++depth;
+        }
+
+        return node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename KeyArg, typename... Args>
+    std::pair<typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node*, bool> SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::TryInsert(KeyArg&& key, Args&&... args) {
+        Node* parent = nullptr;
+        int   depth  = 0;
+
+        if (Node* existing = FindNode(key, parent, depth)) {
+            Access(existing, depth);
+
+            return { existing, false };
+        }
+
+        Node* node = m_Allocator.Allocate(std::piecewise_construct,
+                                          std::forward_as_tuple(std::forward<KeyArg>(key)),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+
+        Attach(node, parent);
+
+        return { node, true };
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Access(Node* node, int depth) {
+        if (node != m_Root && m_SplayPolicy.IsSplayNeeded(depth))
+            Restructure(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Restructure(Node* node) {
+        if (m_SplayPolicy.GetMode() == SplayPolicy::Mode::DepthThreshold)
+            SemiSplay(node);
+        else
+            Splay(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Attach(Node* node, Node* parent) {
+        if (m_Size != UnknownSize)
+            ++m_Size;
+
+        Update(node);
+
+        node->m_Parent = parent;
+
+        if (!parent) {
+            m_Root = node;
+            return;
+        }
+
+        if (IsLess(m_Compare, node->m_Pair.first, parent->m_Pair.first))
+            parent->m_Left = node;
+        else
+            parent->m_Right = node;
+
+        UpdatePath(parent);
+        Splay(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSubtreeSize(const Node* node) {
+        return node ? node->m_SubtreeSize : 0;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetIndex(const Node* node) {
+        int index = GetSubtreeSize(node->m_Left);
+
+        for (const Node* parent = node->m_Parent; parent; node = parent, parent = parent->m_Parent) {
+            if (parent->m_Right == node)
+                index += GetSubtreeSize(parent->m_Left) + 1;
+        }
+
+        return index;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetNodeAt(Node* node, int index) {
+        while (node) {
+            const int leftSize = GetSubtreeSize(node->m_Left);
+
+            if (index == leftSize)
+                return node;
+
+            if (index < leftSize) {
+                node = node->m_Left;
+            } else {
+                index -= leftSize + 1;
+                node   = node->m_Right;
+            }
+        }
+
+        return nullptr;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Summary SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetSummary(const Node* node) {
+        return node ? node->m_Summary : Monoid::Identity();
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::GetTreeSize(const Node* root) {
+        if (!root)
+            return 0;
+
+        if constexpr (HasOrderStatistics)
+            return GetSubtreeSize(root);
+
+        return UnknownSize;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CountNodes(Node* root) const {
+        if constexpr (HasOrderStatistics)
+            return GetSubtreeSize(root);
+
+        int count = 0;
+
+        for (Node* node = GetMinNode(root); node; node = GetSuccessor(node))
+            ++count;
+
+        return count;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Update(Node* node) {
+        if constexpr (HasOrderStatistics)
+            node->m_SubtreeSize = GetSubtreeSize(node->m_Left) + GetSubtreeSize(node->m_Right) + 1;
+
+        if constexpr (!std::is_void_v<Monoid>) {
+            node->m_Summary = Monoid::Combine(Monoid::Combine(GetSummary(node->m_Left),
+                                                              Monoid::Lift(node->m_Pair.first, node->m_Pair.second)),
+                                              GetSummary(node->m_Right));
+        }
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::UpdatePath(Node* node) {
+        if constexpr (IsAugmented) {
+            for (; node; node = node->m_Parent)
+                Update(node);
+        }
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Transplant(Node* parent, Node* child) {
         if (!parent->m_Parent)
             m_Root = child;
         else if (parent == parent->m_Parent->m_Left)
@@ -351,13 +1002,13 @@ namespace DataStructures {
             child->m_Parent = parent->m_Parent;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::RotateLeft(Node* node) {
-        //   p      =>      x
-        //  / \            / \
-        // 1   x    =>    p   3
-        //    / \        / \
-        //   2   3  =>  1   2
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RotateLeft(Node* node) {
+        /*   p      =>      x
+            / \            / \
+           1   x    =>    p   3
+              / \        / \
+             2   3  =>  1   2 */
 
         Node* right     = node->m_Right;
         Node* rightLeft = right->m_Left;
@@ -378,16 +1029,19 @@ namespace DataStructures {
         if (rightLeft)
             rightLeft->m_Parent = node;
 
+        Update(node);
+        Update(right);
+
         return right;
     }
 
-    template <typename Key, typename Value>
-    typename SplayTree<Key, Value>::Node* SplayTree<Key, Value>::RotateRight(Node* node) {
-        //     p    =>    x
-        //    / \        / \
-        //   x   3  =>  1   p
-        //  / \            / \
-        // 1   2    =>    2   3
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::RotateRight(Node* node) {
+        /*     p    =>    x
+              / \        / \
+             x   3  =>  1   p
+            / \            / \
+           1   2    =>    2   3 */
 
         Node* left      = node->m_Left;
         Node* leftRight = left->m_Right;
@@ -408,39 +1062,42 @@ namespace DataStructures {
         if (leftRight)
             leftRight->m_Parent = node;
 
+        Update(node);
+        Update(left);
+
         return left;
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Zig(Node* node) {
-        // Root.Left == node
-        //     p    =>    x
-        //    / \        / \
-        //   x   3  =>  1   p
-        //  / \            / \
-        // 1   2    =>    2   3
-        //
-        // Root.Right == node
-        //   p      =>      x
-        //  / \            / \
-        // 1   x    =>    p   3
-        //    / \        / \
-        //   2   3  =>  1   2
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Zig(Node* node) {
+        /* Root.Left == node
+               p    =>    x
+              / \        / \
+             x   3  =>  1   p
+            / \            / \
+           1   2    =>    2   3
+          
+           Root.Right == node
+             p      =>      x
+            / \            / \
+           1   x    =>    p   3
+              / \        / \
+             2   3  =>  1   2 */
         m_Root = m_Root->m_Left == node ? RotateRight(m_Root) : RotateLeft(m_Root);
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::ZigZig(Node* node) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ZigZig(Node* node) {
         Node* parent      = node->m_Parent;
         Node* grandParent = parent->m_Parent;
 
-        //       g          x
-        //      / \   =>   / \
-        //     p   4      1   p
-        //    / \     =>     / \
-        //   x   3          2   g
-        //  / \       =>       / \
-        // 1   2              3   4
+        /*       g          x
+                / \   =>   / \
+               p   4      1   p
+              / \     =>     / \
+             x   3          2   g
+            / \       =>       / \
+           1   2              3   4 */
         if (parent->m_Left == node && grandParent->m_Left == parent) {
             if (grandParent == m_Root) {
                 m_Root = RotateRight(m_Root);
@@ -454,13 +1111,13 @@ namespace DataStructures {
             return Splay(node);
         }
 
-        //   g                  x
-        //  / \       =>       / \
-        // 1   p              p   4
-        //    / \     =>     / \
-        //   2   x          g   3
-        //      / \   =>   / \
-        //     3   4      1   2
+        /*   g                  x
+            / \       =>       / \
+           1   p              p   4
+              / \     =>     / \
+             2   x          g   3
+                / \   =>   / \
+               3   4      1   2 */
         if (parent->m_Right == node && grandParent->m_Right == parent) {
             if (grandParent == m_Root) {
                 m_Root = RotateLeft(m_Root);
@@ -475,18 +1132,18 @@ namespace DataStructures {
         }
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::ZigZag(Node* node) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::ZigZag(Node* node) {
         Node* parent      = node->m_Parent;
         Node* grandParent = parent->m_Parent;
 
-        //     g             x
-        //    / \   =>      / \
-        //   p   4         /   \
-        //  / \     =>    p     g
-        // 1   x         / \   / \
-        //    / \   =>  1   2 3   4
-        //   2   3
+        /*     g             x
+              / \   =>      / \
+             p   4         /   \
+            / \     =>    p     g
+           1   x         / \   / \
+              / \   =>  1   2 3   4
+             2   3 */
         if (parent->m_Right == node && grandParent->m_Left == parent) {
             node   = RotateLeft(parent);
             parent = node->m_Parent;
@@ -501,13 +1158,13 @@ namespace DataStructures {
             return Splay(node);
         }
 
-        //     g             x
-        //    / \    =>     / \
-        //   1   p         /   \
-        //      / \  =>   g     p
-        //     x   4     / \   / \
-        //    / \    => 1   2 3   4
-        //   2   3
+        /*     g             x
+              / \    =>     / \
+             1   p         /   \
+                / \  =>   g     p
+               x   4     / \   / \
+              / \    => 1   2 3   4
+             2   3 */
         if (parent->m_Left == node && grandParent->m_Right == parent) {
             node   = RotateRight(parent);
             parent = node->m_Parent;
@@ -523,8 +1180,8 @@ namespace DataStructures {
         }
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Splay(Node* node) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Splay(Node* node) {
         if (node == m_Root || !node)
             return;
 
@@ -534,27 +1191,194 @@ namespace DataStructures {
         if (parent == m_Root)
             return Zig(node);
 
-        if (parent->m_Left  == node && grandParent->m_Left  == parent ||
-            parent->m_Right == node && grandParent->m_Right == parent)
+        if ((parent->m_Left  == node && grandParent->m_Left  == parent) ||
+            (parent->m_Right == node && grandParent->m_Right == parent))
             return ZigZig(node);
 
-        if (parent->m_Right == node && grandParent->m_Left  == parent ||
-            parent->m_Left  == node && grandParent->m_Right == parent)
+        if ((parent->m_Right == node && grandParent->m_Left  == parent) ||
+            (parent->m_Left  == node && grandParent->m_Right == parent))
             return ZigZag(node);
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Merge(Node* left, Node* right) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::SemiSplay(Node* node) {
+        // A zig-zig only lifts the parent over the grandparent and goes on from
+        // the parent, so the node itself climbs about half of the way and every
+        // node on the path ends up about half as deep. A zig-zag and a zig are
+        // done as in Splay.
+        while (node != m_Root) {
+            Node*      parent = node->m_Parent;
+            const bool isLeft = parent->m_Left == node;
+
+            if (parent == m_Root) {
+                isLeft ? RotateRight(parent) : RotateLeft(parent);
+                return;
+            }
+
+            Node* grandParent = parent->m_Parent;
+
+            if (isLeft == (grandParent->m_Left == parent)) {
+                isLeft ? RotateRight(grandParent) : RotateLeft(grandParent);
+                node = parent;
+            } else {
+                isLeft ? RotateRight(parent) : RotateLeft(parent);
+                isLeft ? RotateLeft(grandParent) : RotateRight(grandParent);
+            }
+        }
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Erase(Node* node) {
+        if (m_Size != UnknownSize)
+            --m_Size;
+
+        Node* left  = node->m_Left;
+        Node* right = node->m_Right;
+
+        if (!left && !right)
+            m_Root = nullptr;
+        else if (!left)
+            Transplant(node, right);
+        else if (!right)
+            Transplant(node, left);
+        else
+            Merge(node->m_Left, node->m_Right);
+
+        m_Allocator.Deallocate(node);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Merge(Node* left, Node* right) {
         Node* leftMax = GetMaxNode(left);
 
+        left->m_Parent = nullptr;
+        m_Root         = left;
+
         Splay(leftMax);
 
         leftMax->m_Right = right;
-        m_Root           = leftMax;
+        right->m_Parent  = leftMax;
+
+        Update(leftMax);
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CutLeft(const Key& key, bool isInclusive) {
+        // Splays the first node past key to the root and cuts off its left subtree,
+        // an inclusive cut takes key itself along. Without such a node the whole
+        // tree is cut off.
+        Node* node  = m_Root;
+        Node* bound = nullptr;
+        Node* last  = nullptr;
+
+        while (node) {
+            last = node;
+
+            if (isInclusive ? !IsLess(m_Compare, key, node->m_Pair.first) : IsLess(m_Compare, node->m_Pair.first, key)) {
+                node = node->m_Right;
+            } else {
+                bound = node;
+                node  = node->m_Left;
+            }
+        }
+
+        Splay(bound ? bound : last);
+
+        if (!bound)
+            return std::exchange(m_Root, nullptr);
+
+        Node* left = std::exchange(bound->m_Left, nullptr);
+
+        if (left)
+            left->m_Parent = nullptr;
+
+        Update(bound);
+
+        return left;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::CutRange(const Key& lo, const Key& hi) {
+        Node* left   = CutLeft(lo, false);
+        Node* middle = CutLeft(hi, true);
+        Node* right  = std::exchange(m_Root, nullptr);
+
+        if (left && right)
+            Merge(left, right);
+        else
+            m_Root = left ? left : right;
+
+        return middle;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    template <typename ForwardIterator>
+    typename SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Node* SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Build(ForwardIterator& iterator, std::size_t count) {
+        if (count == 0)
+            return nullptr;
+
+        const std::size_t leftCount = (count - 1) / 2;
+
+        Node* left = Build(iterator, leftCount);
+        Node* node = nullptr;
+
+        try {
+            node = m_Allocator.Allocate((*iterator).first, (*iterator).second);
+        } catch (...) {
+            Destroy(left);
+            throw;
+        }
+
+        ++iterator;
+
+        node->m_Left = left;
+
+        if (left)
+            left->m_Parent = node;
+
+        try {
+            node->m_Right = Build(iterator, count - leftCount - 1);
+        } catch (...) {
+            Destroy(node);
+            throw;
+        }
+
+        if (node->m_Right)
+            node->m_Right->m_Parent = node;
+
+        Update(node);
+
+        return node;
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    int SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Destroy(Node* node) {
+        // Rotates left children up instead of recursing, so a degenerate tree
+        // is torn down in O(n) without a stack or parent links.
+        int count = 0;
+
+        while (node) {
+            if (node->m_Left) {
+                Node* left = node->m_Left;
+
+                node->m_Left  = left->m_Right;
+                left->m_Right = node;
+                node          = left;
+            } else {
+                Node* right = node->m_Right;
+
+                m_Allocator.Deallocate(node);
+                node = right;
+
+                ++count;
+            }
+        }
+
+        return count;
     }
 
-    template <typename Key, typename Value>
-    void SplayTree<Key, Value>::Print(const Node* node, int level, const char* caption, std::ostream& ostream) const {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    void SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>::Print(const Node* node, int level, const char* caption, std::ostream& ostream) const {
         if (!node) {
             ostream << caption << ": Null" << std::endl;
             return;
@@ -582,8 +1406,8 @@ namespace DataStructures {
         ostream << std::endl;
     }
 
-    template <typename Key, typename Value>
-    std::ostream& operator <<(std::ostream& ostream, const SplayTree<Key, Value>& tree) {
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    std::ostream& operator <<(std::ostream& ostream, const SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>& tree) {
         tree.Print(tree.m_Root, 1, "Root", ostream);
 
         return ostream;
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../Common/MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+
+#define DATA_STRUCTURES_HAS_POSIX_IO
+#endif
+
+namespace DataStructures {
+
+    // Read-only tree served straight from a memory-mapped file. The file holds
+    // the keys in increasing order in one array and the values in a parallel
+    // one, so a lookup is a binary search over the mapping and opening an image
+    // reads nothing but the header.
+    //
+    // Layout, in the byte order of the machine that wrote it:
+    //     Header                       - magic, format version, byte order mark,
+    //                                    key and value sizes, count and offsets
+    //     Key[count]   at KeysOffset   - strictly increasing
+    //     Value[count] at ValuesOffset - in the order of the keys
+    // Both arrays start on a cache line. Keys and values are copied byte for
+    // byte, so they have to be trivially copyable and hold no pointers.
+    template <typename Key, typename Value>
+    class TreeImage {
+    public:
+        static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+                      "Ng::TreeImage: keys and values are stored byte for byte and have to be trivially copyable!");
+
+        static constexpr std::uint32_t FormatVersion = 1;
+
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const Key, Value>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const Key&, const Value&>;
+
+            struct pointer {
+                reference Pair;
+
+                inline reference* operator ->() { return &Pair; }
+            };
+
+            explicit ConstIterator(const TreeImage* image = nullptr, std::size_t index = 0);
+
+            [[nodiscard]] inline reference operator *() const { return { m_Image->m_Keys[m_Index], m_Image->m_Values[m_Index] }; }
+            [[nodiscard]] inline pointer operator ->() const { return { **this }; }
+
+            ConstIterator& operator ++();
+            ConstIterator operator ++(int);
+
+            bool operator ==(const ConstIterator& other) const;
+            bool operator !=(const ConstIterator& other) const;
+
+        private:
+            const TreeImage* m_Image;
+            std::size_t      m_Index;
+
+        }; // class ConstIterator
+
+        TreeImage() = default;
+        TreeImage(const TreeImage& other) = delete;
+        TreeImage(TreeImage&& other) noexcept;
+
+        TreeImage& operator =(const TreeImage& other) = delete;
+        TreeImage& operator =(TreeImage&& other) noexcept;
+
+        // Maps the file at path and checks its header. Throws std::runtime_error
+        // for a file of another format, version, byte order or key and value
+        // type, or one that is cut short.
+        [[nodiscard]] static TreeImage Open(const std::string& path);
+
+        // Writes pairs sorted by strictly increasing key to path in two passes
+        // over [first, last). The file is written next to path, synced and
+        // renamed over it, then the directory is synced, so a crash leaves
+        // either the old image or the new one behind, never a torn one. Where
+        // POSIX I/O is not available nothing is synced and that does not hold.
+        template <typename ForwardIterator>
+        static void Save(const std::string& path, ForwardIterator first, ForwardIterator last);
+
+        [[nodiscard]] inline bool IsEmpty() const { return m_Count == 0; }
+        [[nodiscard]] inline int GetSize() const { return static_cast<int>(m_Count); }
+
+        [[nodiscard]] bool IsExists(const Key& key) const;
+        [[nodiscard]] const Value& Get(const Key& key) const;
+
+        [[nodiscard]] ConstIterator Find(const Key& key) const;
+        [[nodiscard]] ConstIterator LowerBound(const Key& key) const;
+
+        [[nodiscard]] ConstIterator begin() const { return ConstIterator(this, 0); }
+        [[nodiscard]] ConstIterator end() const { return ConstIterator(this, m_Count); }
+
+        [[nodiscard]] ConstIterator cbegin() const { return ConstIterator(this, 0); }
+        [[nodiscard]] ConstIterator cend() const { return ConstIterator(this, m_Count); }
+
+    private:
+        struct Header {
+            char          Magic[8];
+            std::uint32_t Version;
+            std::uint32_t ByteOrder;
+            std::uint32_t KeySize;
+            std::uint32_t ValueSize;
+            std::uint64_t Count;
+            std::uint64_t KeysOffset;
+            std::uint64_t ValuesOffset;
+        };
+
+        static constexpr char          Magic[8]       = { 'N', 'g', 'T', 'r', 'e', 'e', '\0', '\0' };
+        static constexpr std::uint32_t ByteOrderMark  = 0x01020304;
+        static constexpr std::uint64_t ArrayAlignment = 64;
+
+        [[nodiscard]] static std::uint64_t AlignUp(std::uint64_t offset);
+
+        // fsyncs a file or a directory
+        static void Sync(const std::string& path);
+
+        [[nodiscard]] std::size_t GetLowerBound(const Key& key) const;
+        [[nodiscard]] std::size_t GetIndex(const Key& key) const;
+
+    private:
+        MappedFile   m_File;
+        const Key*   m_Keys   = nullptr;
+        const Value* m_Values = nullptr;
+        std::size_t  m_Count  = 0;
+
+    }; // class TreeImage
+
+} // namespace DataStructures
+
+#include "TreeImage.inl"
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace DataStructures {
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class TreeImage::ConstIterator
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    TreeImage<Key, Value>::ConstIterator::ConstIterator(const TreeImage* image, std::size_t index)
+        : m_Image(image)
+        , m_Index(index) {}
+
+    template <typename Key, typename Value>
+    typename TreeImage<Key, Value>::ConstIterator& TreeImage<Key, Value>::ConstIterator::operator ++() {
+        ++m_Index;
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    typename TreeImage<Key, Value>::ConstIterator TreeImage<Key, Value>::ConstIterator::operator ++(int) {
+        ConstIterator old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    template <typename Key, typename Value>
+    bool TreeImage<Key, Value>::ConstIterator::operator ==(const ConstIterator& other) const {
+        return m_Image == other.m_Image && m_Index == other.m_Index;
+    }
+
+    template <typename Key, typename Value>
+    bool TreeImage<Key, Value>::ConstIterator::operator !=(const ConstIterator& other) const {
+        return !(*this == other);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// class TreeImage
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename Key, typename Value>
+    TreeImage<Key, Value>::TreeImage(TreeImage&& other) noexcept
+        : m_File(std::move(other.m_File))
+        , m_Keys(std::exchange(other.m_Keys, nullptr))
+        , m_Values(std::exchange(other.m_Values, nullptr))
+        , m_Count(std::exchange(other.m_Count, 0)) {}
+
+    template <typename Key, typename Value>
+    TreeImage<Key, Value>& TreeImage<Key, Value>::operator =(TreeImage&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        m_File   = std::move(other.m_File);
+        m_Keys   = std::exchange(other.m_Keys, nullptr);
+        m_Values = std::exchange(other.m_Values, nullptr);
+        m_Count  = std::exchange(other.m_Count, 0);
+
+        return *this;
+    }
+
+    template <typename Key, typename Value>
+    TreeImage<Key, Value> TreeImage<Key, Value>::Open(const std::string& path) {
+        TreeImage image;
+
+        image.m_File = MappedFile(path);
+
+        const unsigned char* data = image.m_File.GetData();
+        const std::uint64_t  size = image.m_File.GetSize();
+
+        Header header {};
+
+        if (size < sizeof(Header) || std::memcmp(data, Magic, sizeof(Magic)) != 0)
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " is not a tree image!");
+
+        std::memcpy(&header, data, sizeof(Header));
+
+        if (header.Version != FormatVersion)
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " has format version " + std::to_string(header.Version) + "!");
+
+        if (header.ByteOrder != ByteOrderMark)
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " was written with another byte order!");
+
+        if (header.KeySize != sizeof(Key) || header.ValueSize != sizeof(Value))
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " holds keys or values of another size!");
+
+        // the divisions keep count * size from overflowing on a damaged header
+        const bool isKeysInside   = header.KeysOffset <= size && header.Count <= (size - header.KeysOffset) / sizeof(Key);
+        const bool isValuesInside = header.ValuesOffset <= size && header.Count <= (size - header.ValuesOffset) / sizeof(Value);
+
+        if (!isKeysInside || !isValuesInside)
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " is cut short!");
+
+        if (header.KeysOffset % alignof(Key) != 0 || header.ValuesOffset % alignof(Value) != 0)
+            throw std::runtime_error("Ng::TreeImage::Open: " + path + " has misaligned arrays!");
+
+        image.m_Keys   = reinterpret_cast<const Key*>(data + header.KeysOffset);
+        image.m_Values = reinterpret_cast<const Value*>(data + header.ValuesOffset);
+        image.m_Count  = static_cast<std::size_t>(header.Count);
+
+        return image;
+    }
+
+    template <typename Key, typename Value>
+    template <typename ForwardIterator>
+    void TreeImage<Key, Value>::Save(const std::string& path, ForwardIterator first, ForwardIterator last) {
+        static constexpr char Padding[ArrayAlignment] {};
+
+        const std::string temporary = path + ".tmp";
+
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+        if (!file)
+            throw std::runtime_error("Ng::TreeImage::Save: cannot open " + temporary + "!");
+
+        try {
+            Header header {};
+
+            std::memcpy(header.Magic, Magic, sizeof(Magic));
+
+            header.Version    = FormatVersion;
+            header.ByteOrder  = ByteOrderMark;
+            header.KeySize    = sizeof(Key);
+            header.ValueSize  = sizeof(Value);
+            header.KeysOffset = AlignUp(sizeof(Header));
+
+            std::uint64_t offset = header.KeysOffset;
+
+            // the header is rewritten with the count and the value offset at the end
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            file.write(Padding, static_cast<std::streamsize>(header.KeysOffset - sizeof(Header)));
+
+            for (ForwardIterator it = first, previous = first; it != last; previous = it, ++it) {
+                const Key& key = (*it).first;
+
+                if (it != first && !(key > (*previous).first))
+                    throw std::invalid_argument("Ng::TreeImage::Save: keys are not strictly increasing!");
+
+                file.write(reinterpret_cast<const char*>(&key), sizeof(Key));
+
+                ++header.Count;
+            }
+
+            offset += header.Count * sizeof(Key);
+
+            header.ValuesOffset = AlignUp(offset);
+
+            file.write(Padding, static_cast<std::streamsize>(header.ValuesOffset - offset));
+
+            for (ForwardIterator it = first; it != last; ++it) {
+                const Value& value = (*it).second;
+
+                file.write(reinterpret_cast<const char*>(&value), sizeof(Value));
+            }
+
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            file.close();
+
+            if (!file)
+                throw std::runtime_error("Ng::TreeImage::Save: cannot write " + temporary + "!");
+
+            // the data has to be on disk before the rename can point path at it
+            Sync(temporary);
+
+            std::error_code error;
+
+            std::filesystem::rename(temporary, path, error);
+
+            if (error)
+                throw std::runtime_error("Ng::TreeImage::Save: cannot replace " + path + "!");
+
+            const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+            Sync(directory.empty() ? std::string(".") : directory.string());
+        } catch (...) {
+            file.close();
+            std::remove(temporary.c_str());
+
+            throw;
+        }
+    }
+
+    template <typename Key, typename Value>
+    bool TreeImage<Key, Value>::IsExists(const Key& key) const {
+        return GetIndex(key) != m_Count;
+    }
+
+    template <typename Key, typename Value>
+    const Value& TreeImage<Key, Value>::Get(const Key& key) const {
+        const std::size_t index = GetIndex(key);
+
+        if (index == m_Count)
+            throw std::out_of_range("Ng::TreeImage::Get: key is not exists!");
+
+        return m_Values[index];
+    }
+
+    template <typename Key, typename Value>
+    typename TreeImage<Key, Value>::ConstIterator TreeImage<Key, Value>::Find(const Key& key) const {
+        return ConstIterator(this, GetIndex(key));
+    }
+
+    template <typename Key, typename Value>
+    typename TreeImage<Key, Value>::ConstIterator TreeImage<Key, Value>::LowerBound(const Key& key) const {
+        return ConstIterator(this, GetLowerBound(key));
+    }
+
+    template <typename Key, typename Value>
+    std::uint64_t TreeImage<Key, Value>::AlignUp(std::uint64_t offset) {
+        return (offset + ArrayAlignment - 1) / ArrayAlignment * ArrayAlignment;
+    }
+
+    template <typename Key, typename Value>
+    void TreeImage<Key, Value>::Sync(const std::string& path) {
+#ifdef DATA_STRUCTURES_HAS_POSIX_IO
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+        if (descriptor < 0)
+            throw std::runtime_error("Ng::TreeImage::Sync: cannot open " + path + "!");
+
+        const int result = ::fsync(descriptor);
+
+        ::close(descriptor);
+
+        if (result != 0)
+            throw std::runtime_error("Ng::TreeImage::Sync: cannot sync " + path + "!");
+#else
+        (void)path;
+#endif
+    }
+
+    template <typename Key, typename Value>
+    std::size_t TreeImage<Key, Value>::GetLowerBound(const Key& key) const {
+        if (m_Count == 0)
+            return 0;
+
+        const Key*  base  = m_Keys;
+        std::size_t count = m_Count;
+
+        // Branch-free halving: the step taken depends on the compare only through
+        // a select, and both midpoints of the next step are prefetched meanwhile.
+        while (count > 1) {
+            const std::size_t half = count / 2;
+
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+#endif
+            base   = key > base[half] ? base + half : base;
+            count -= half;
+        }
+
+        return static_cast<std::size_t>(base - m_Keys) + (key > *base ? 1 : 0);
+    }
+
+    template <typename Key, typename Value>
+    std::size_t TreeImage<Key, Value>::GetIndex(const Key& key) const {
+        const std::size_t index = GetLowerBound(key);
+
+        return index != m_Count && !(m_Keys[index] > key) ? index : m_Count;
+    }
+
+} // namespace DataStructures
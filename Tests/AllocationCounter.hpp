@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete to track the bytes in use, so a
+// test can tell whether memory stays bounded. Every block carries its size and
+// the address malloc gave in front of it, which also serves the aligned forms.
+// Include it in one translation unit of a test only.
+namespace Tests {
+
+    inline std::atomic<std::int64_t> g_LiveBytes { 0 };
+    inline std::atomic<std::int64_t> g_AllocationCount { 0 };
+
+    [[nodiscard]] inline std::int64_t GetLiveBytes() { return g_LiveBytes.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline std::int64_t GetAllocationCount() { return g_AllocationCount.load(std::memory_order_relaxed); }
+
+    struct BlockHeader {
+        void*       Raw;
+        std::size_t Size;
+    };
+
+    inline void* Allocate(std::size_t size, std::size_t alignment) noexcept {
+        if (alignment < alignof(BlockHeader))
+            alignment = alignof(BlockHeader);
+
+        void* raw = std::malloc(size + alignment + sizeof(BlockHeader));
+
+        if (!raw)
+            return nullptr;
+
+        const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(raw) + sizeof(BlockHeader);
+        auto*                data  = reinterpret_cast<void*>((first + alignment - 1) / alignment * alignment);
+
+        static_cast<BlockHeader*>(data)[-1] = { raw, size };
+
+        g_LiveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        return data;
+    }
+
+    inline void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+        if (void* data = Allocate(size, alignment))
+            return data;
+
+        throw std::bad_alloc();
+    }
+
+    inline void Free(void* data) noexcept {
+        if (!data)
+            return;
+
+        const BlockHeader header = static_cast<BlockHeader*>(data)[-1];
+
+        g_LiveBytes.fetch_sub(static_cast<std::int64_t>(header.Size), std::memory_order_relaxed);
+
+        std::free(header.Raw);
+    }
+
+} // namespace Tests
+
+void* operator new(std::size_t size) { return Tests::AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size) { return Tests::AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return Tests::AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return Tests::AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Tests::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Tests::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Tests::Allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Tests::Allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* data) noexcept { Tests::Free(data); }
+void operator delete[](void* data) noexcept { Tests::Free(data); }
+void operator delete(void* data, std::size_t) noexcept { Tests::Free(data); }
+void operator delete[](void* data, std::size_t) noexcept { Tests::Free(data); }
+void operator delete(void* data, std::align_val_t) noexcept { Tests::Free(data); }
+void operator delete[](void* data, std::align_val_t) noexcept { Tests::Free(data); }
+void operator delete(void* data, std::size_t, std::align_val_t) noexcept { Tests::Free(data); }
+void operator delete[](void* data, std::size_t, std::align_val_t) noexcept { Tests::Free(data); }
+void operator delete(void* data, const std::nothrow_t&) noexcept { Tests::Free(data); }
+void operator delete[](void* data, const std::nothrow_t&) noexcept { Tests::Free(data); }
+void operator delete(void* data, std::align_val_t, const std::nothrow_t&) noexcept { Tests::Free(data); }
+void operator delete[](void* data, std::align_val_t, const std::nothrow_t&) noexcept { Tests::Free(data); }
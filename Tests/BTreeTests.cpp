@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Trees/BTree/BTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    // Walks the tree checking that every node but the root is at least half
+    // full, the keys are sorted, all leaves are at one depth and every key
+    // block starts a cache line. Returns the number of keys.
+    template <typename Tree>
+    int CheckNode(const typename Tree::Node* node, int depth, int& leafDepth) {
+        CHECK(reinterpret_cast<std::uintptr_t>(&node->GetKey(0)) % Tree::CacheLineSize == 0);
+        CHECK(node->GetCount() <= Tree::MaxKeys);
+        CHECK(!node->GetParent() || node->GetCount() >= Tree::MinKeys);
+
+        for (int i = 1; i < node->GetCount(); ++i)
+            CHECK(node->GetKey(i - 1) < node->GetKey(i));
+
+        if (node->IsLeaf()) {
+            CHECK(leafDepth < 0 || leafDepth == depth);
+
+            leafDepth = depth;
+
+            return node->GetCount();
+        }
+
+        int count = node->GetCount();
+
+        for (int i = 0; i <= node->GetCount(); ++i) {
+            CHECK(node->GetChild(i)->GetParent() == node);
+
+            count += CheckNode<Tree>(node->GetChild(i), depth + 1, leafDepth);
+        }
+
+        return count;
+    }
+
+    // Random pushes and pops against std::map, missing keys included, with the
+    // structure checked now and then.
+    template <typename Tree>
+    void TestBTree(int range) {
+        Tree               tree;
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        for (int i = 0; i < 200000; ++i) {
+            const int key = static_cast<int>(random() % range);
+
+            switch (random() % 3) {
+                case 0:
+                    expected[key] = i;
+                    tree[key]     = i;
+                    break;
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                default: {
+                    const auto it = expected.find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    CHECK(it == expected.end() ? tree.Find(key) == tree.end() : tree.Find(key)->second == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+
+            if (i % 20000 == 0 && tree.GetRoot()) {
+                int leafDepth = -1;
+
+                CHECK(CheckNode<Tree>(tree.GetRoot(), 0, leafDepth) == tree.GetSize());
+            }
+        }
+
+        Pairs pairs;
+
+        for (const auto& [key, value] : tree)
+            pairs.emplace_back(key, value);
+
+        CHECK(pairs == Pairs(expected.begin(), expected.end()));
+        CHECK(tree.GetMin() == expected.begin()->second);
+        CHECK(tree.GetMax() == expected.rbegin()->second);
+
+        // popping everything leaves an empty tree
+        for (const auto& [key, value] : expected)
+            tree.Pop(key);
+
+        CHECK(tree.IsEmpty() && !tree.GetRoot());
+
+        bool isThrown = false;
+
+        try {
+            static_cast<void>(tree.GetMin());
+        } catch (const std::out_of_range&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestBTree<DataStructures::BTree<int, int>>(10000);
+    Tests::TestBTree<DataStructures::BTree<int, int>>(100);
+    Tests::TestBTree<DataStructures::BTree<int, int, 16>>(10000);
+    Tests::TestBTree<DataStructures::BTree<int, int, 4096>>(100000);
+
+    return 0;
+}
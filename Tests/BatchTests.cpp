@@ -0,0 +1,92 @@
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    // Batches of every size around the group size, with repeated and missing
+    // keys, against std::map. Like Push, PushBatch keeps the value of a key
+    // that is already there, so the first of repeated keys wins.
+    template <typename Tree>
+    void TestBatches(Tree& tree) {
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        for (int round = 0; round < 400; ++round) {
+            const std::size_t count = random() % 200;
+
+            std::vector<int> keys(count);
+            std::vector<int> values(count);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                keys[i]   = static_cast<int>(random() % 20000);
+                values[i] = static_cast<int>(random());
+            }
+
+            if (round % 2 == 0) {
+                tree.PushBatch(keys.data(), values.data(), count);
+
+                for (std::size_t i = 0; i < count; ++i)
+                    expected.emplace(keys[i], values[i]);
+            } else {
+                // pop a few to keep missing keys in play
+                for (std::size_t i = 0; i < count / 4; ++i) {
+                    tree.Pop(keys[i]);
+                    expected.erase(keys[i]);
+                }
+            }
+
+            std::vector<int*>       found(count);
+            std::vector<const int*> constFound(count);
+            std::unique_ptr<bool[]> isExists = std::make_unique<bool[]>(count);
+
+            tree.GetBatch(keys.data(), count, found.data());
+            static_cast<const Tree&>(tree).GetBatch(keys.data(), count, constFound.data());
+            tree.ContainsBatch(keys.data(), count, isExists.get());
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto it = expected.find(keys[i]);
+
+                CHECK(isExists[i] == (it != expected.end()));
+                CHECK(it == expected.end() ? !found[i] : *found[i] == it->second);
+                CHECK(it == expected.end() ? !constFound[i] : *constFound[i] == it->second);
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        CHECK(pairs == Pairs(expected.begin(), expected.end()));
+    }
+
+} // namespace Tests
+
+int main() {
+    using DataStructures::SplayPolicy;
+
+    DataStructures::RedBlackTree<int, int> redBlackTree;
+    DataStructures::SplayTree<int, int>    splayTree;
+    DataStructures::SplayTree<int, int>    semiSplayTree;
+
+    semiSplayTree.SetSplayPolicy(SplayPolicy::DepthThreshold(4));
+
+    Tests::TestBatches(redBlackTree);
+    Tests::TestBatches(splayTree);
+    Tests::TestBatches(semiSplayTree);
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+// Unlike assert it stays on in Release builds.
+#define CHECK(condition) ((condition) ? void() : Tests::Fail(#condition, __FILE__, __LINE__))
+
+namespace Tests {
+
+    [[noreturn]] inline void Fail(const char* condition, const char* file, int line) {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+        std::abort();
+    }
+
+    // A file in the temporary directory that is removed again with its owner.
+    class TemporaryFile {
+    public:
+        explicit TemporaryFile(const std::string& name)
+            : m_Path((std::filesystem::temp_directory_path() / name).string()) {
+            std::filesystem::remove(m_Path);
+        }
+
+        TemporaryFile(const TemporaryFile& other) = delete;
+
+        ~TemporaryFile() {
+            std::error_code error;
+            std::filesystem::remove(m_Path, error);
+        }
+
+        TemporaryFile& operator =(const TemporaryFile& other) = delete;
+
+        [[nodiscard]] inline const std::string& GetPath() const { return m_Path; }
+
+    private:
+        std::string m_Path;
+
+    }; // class TemporaryFile
+
+} // namespace Tests
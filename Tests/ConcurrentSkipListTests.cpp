@@ -0,0 +1,230 @@
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Trees/ConcurrentSkipList/ConcurrentSkipList.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    constexpr int ThreadCount = 8;
+    constexpr int KeyCount    = 2000;
+
+    // ConcurrentSkipList::Push and Pop return nothing, these report to the
+    // test what std::map would.
+    struct SkipListOperations {
+        using Tree = DataStructures::ConcurrentSkipList<int, int>;
+
+        static bool Push(Tree& tree, int key, int value) {
+            const bool isNew = !tree.IsExists(key);
+
+            tree.Push(key, value);
+
+            return isNew;
+        }
+
+        static bool Assign(Tree& tree, int key, int value) {
+            const bool isNew = !tree.IsExists(key);
+
+            tree.Assign(key, value);
+
+            return isNew;
+        }
+
+        static bool Pop(Tree& tree, int key) {
+            const bool isFound = tree.IsExists(key);
+
+            tree.Pop(key);
+
+            return isFound;
+        }
+    };
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        tree.ForEach([&pairs](const int& key, const int& value) { pairs.emplace_back(key, value); });
+
+        return pairs;
+    }
+
+    // One thread against std::map, with Assign replacing the value of a key
+    // that is there and Push replacing it only if isPushReplacing.
+    template <typename Operations>
+    void TestSequential(bool isPushReplacing) {
+        typename Operations::Tree tree;
+        std::map<int, int>        expected;
+        std::mt19937              random(1);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % KeyCount);
+
+            switch (random() % 4) {
+                case 0: {
+                    const bool isNew = expected.find(key) == expected.end();
+
+                    CHECK(Operations::Push(tree, key, i) == isNew);
+
+                    if (isNew || isPushReplacing)
+                        expected[key] = i;
+
+                    break;
+                }
+                case 1:
+                    CHECK(Operations::Assign(tree, key, i) == (expected.find(key) == expected.end()));
+                    expected[key] = i;
+                    break;
+                case 2:
+                    CHECK(Operations::Pop(tree, key) == (expected.erase(key) == 1));
+                    break;
+                default: {
+                    const auto found = tree.Find(key);
+                    const auto it    = expected.find(key);
+
+                    CHECK(found.has_value() == (it != expected.end()));
+                    CHECK(!found || *found == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+
+        tree.Clear();
+
+        CHECK(tree.IsEmpty());
+        CHECK(GetPairs(tree).empty());
+    }
+
+    // Every thread owns the keys congruent to its index, so each checks its own
+    // std::map while the list changes under all of them. A reader on the
+    // side may only see values that were written for the key.
+    template <typename Operations>
+    void TestConcurrent() {
+        typename Operations::Tree       tree;
+        std::vector<std::map<int, int>> expected(ThreadCount);
+        std::vector<std::thread>        threads;
+        std::atomic<bool>               isDone { false };
+
+        std::thread reader([&tree, &isDone] {
+            std::mt19937 random(99);
+
+            while (!isDone.load(std::memory_order_relaxed)) {
+                const int  key   = static_cast<int>(random() % (ThreadCount * KeyCount));
+                const auto found = tree.Find(key);
+
+                CHECK(!found || *found % ThreadCount == key % ThreadCount);
+            }
+        });
+
+        for (int thread = 0; thread < ThreadCount; ++thread) {
+            threads.emplace_back([&tree, &expected, thread] {
+                std::map<int, int>& owned = expected[thread];
+                std::mt19937        random(thread + 1);
+
+                for (int i = 0; i < 30000; ++i) {
+                    const int key   = thread + ThreadCount * static_cast<int>(random() % KeyCount);
+                    const int value = key + ThreadCount * i;
+
+                    switch (random() % 3) {
+                        case 0:
+                            CHECK(Operations::Assign(tree, key, value) == (owned.find(key) == owned.end()));
+                            owned[key] = value;
+                            break;
+                        case 1:
+                            CHECK(Operations::Pop(tree, key) == (owned.erase(key) == 1));
+                            break;
+                        default: {
+                            const auto found = tree.Find(key);
+                            const auto it    = owned.find(key);
+
+                            CHECK(found.has_value() == (it != owned.end()));
+                            CHECK(!found || *found == it->second);
+                            break;
+                        }
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        isDone = true;
+        reader.join();
+
+        std::map<int, int> merged;
+
+        for (const std::map<int, int>& owned : expected)
+            merged.insert(owned.begin(), owned.end());
+
+        CHECK(tree.GetSize() == static_cast<int>(merged.size()));
+        CHECK(GetPairs(tree) == Pairs(merged.begin(), merged.end()));
+    }
+
+    // All threads fight over a few keys, with one of them clearing the tree now
+    // and then. Only the invariants that hold under any interleaving are checked.
+    template <typename Operations>
+    void TestContended() {
+        typename Operations::Tree tree;
+        std::vector<std::thread>  threads;
+
+        for (int thread = 0; thread < ThreadCount; ++thread) {
+            threads.emplace_back([&tree, thread] {
+                std::mt19937 random(thread + 100);
+
+                for (int i = 0; i < 20000; ++i) {
+                    const int key = static_cast<int>(random() % 64);
+
+                    switch (random() % 4) {
+                        case 0:
+                            Operations::Assign(tree, key, key);
+                            break;
+                        case 1:
+                            Operations::Pop(tree, key);
+                            break;
+                        default: {
+                            const auto found = tree.Find(key);
+
+                            CHECK(!found || *found == key);
+                            break;
+                        }
+                    }
+
+                    if (thread == 0 && i % 5000 == 4999)
+                        tree.Clear();
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        const Pairs pairs = GetPairs(tree);
+
+        CHECK(tree.GetSize() == static_cast<int>(pairs.size()));
+
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            CHECK(pairs[i].first == pairs[i].second);
+            CHECK(i == 0 || pairs[i - 1].first < pairs[i].first);
+        }
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestSequential<Tests::SkipListOperations>(false);
+    Tests::TestConcurrent<Tests::SkipListOperations>();
+    Tests::TestContended<Tests::SkipListOperations>();
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Move-only values against std::map: Emplace builds the pair in the node,
+    // TryEmplace leaves its arguments alone when the key is already there, and
+    // keys and values pushed as rvalues are moved, not copied.
+    template <typename Tree>
+    void TestEmplace() {
+        Tree                                         tree;
+        std::map<std::string, std::unique_ptr<int>> expected;
+        std::mt19937                                 random(1);
+
+        for (int i = 0; i < 50000; ++i) {
+            const std::string key = "key" + std::to_string(random() % 1000);
+
+            switch (random() % 4) {
+                case 0: {
+                    auto [it, isNew] = tree.Emplace(key, std::make_unique<int>(i));
+
+                    CHECK(isNew == expected.emplace(key, std::make_unique<int>(i)).second);
+                    CHECK(it->first == key && *it->second == *expected[key]);
+                    break;
+                }
+                case 1: {
+                    auto value = std::make_unique<int>(i);
+
+                    auto [it, isNew] = tree.TryEmplace(key, std::move(value));
+
+                    CHECK(isNew == expected.try_emplace(key, std::make_unique<int>(i)).second);
+                    CHECK(isNew == (value == nullptr));
+                    CHECK(*it->second == *expected[key]);
+                    break;
+                }
+                case 2: {
+                    std::string movedKey = key;
+
+                    tree.Push(std::move(movedKey), std::make_unique<int>(i));
+                    expected.emplace(key, std::make_unique<int>(i));
+
+                    CHECK(*tree.Get(key) == *expected[key]);
+                    break;
+                }
+                default:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        auto it = expected.begin();
+
+        for (auto& pair : tree) {
+            CHECK(pair.first == it->first && *pair.second == *it->second);
+            ++it;
+        }
+
+        CHECK(it == expected.end());
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestEmplace<DataStructures::RedBlackTree<std::string, std::unique_ptr<int>>>();
+    Tests::TestEmplace<DataStructures::SplayTree<std::string, std::unique_ptr<int>>>();
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    // Trees built from sorted runs of every size up to a few thousand against
+    // std::map, balanced from the start and fully usable afterwards.
+    template <typename Tree>
+    void TestFromSorted() {
+        std::mt19937 random(1);
+
+        for (int count = 0; count < 3000; count += 1 + count / 8) {
+            std::map<int, int> expected;
+
+            while (static_cast<int>(expected.size()) < count)
+                expected.emplace(static_cast<int>(random() % 100000), static_cast<int>(random()));
+
+            const Pairs pairs(expected.begin(), expected.end());
+
+            Tree tree = Tree::FromSorted(pairs.begin(), pairs.end());
+
+            CHECK(tree.GetSize() == count);
+            CHECK(GetPairs(tree) == pairs);
+            CHECK(tree.GetHeight() <= 1 + static_cast<int>(std::log2(count + 1)));
+
+            for (int i = 0; i < 50; ++i) {
+                const int  key = static_cast<int>(random() % 100000);
+                const auto it  = expected.find(key);
+
+                CHECK(tree.IsExists(key) == (it != expected.end()));
+                CHECK(it == expected.end() || tree.Get(key) == it->second);
+            }
+
+            for (int i = 0; i < 50; ++i) {
+                const int key = static_cast<int>(random() % 100000);
+
+                if (random() % 2) {
+                    expected.emplace(key, key);
+                    tree.Push(key, key);
+                } else {
+                    expected.erase(key);
+                    tree.Pop(key);
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+            CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+        }
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestFromSorted<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestFromSorted<DataStructures::SplayTree<int, int>>();
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Trees/FrozenTree/FrozenTree.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    // Freezes trees of every size up to a few levels of prefetching and checks
+    // each lookup against std::map, keys between and beyond the stored ones
+    // included.
+    void TestFreeze() {
+        std::mt19937 random(1);
+
+        for (int size = 0; size < 3000; size += 1 + size / 8) {
+            DataStructures::RedBlackTree<int, int> tree;
+            std::map<int, int>                     expected;
+
+            while (static_cast<int>(expected.size()) < size) {
+                const int key = static_cast<int>(random() % 100000) * 2;
+
+                expected[key] = key + 1;
+                tree[key]     = key + 1;
+            }
+
+            const DataStructures::FrozenTree<int, int> frozen = tree.Freeze();
+
+            CHECK(frozen.GetSize() == size);
+            CHECK(frozen.IsEmpty() == (size == 0));
+
+            Pairs pairs;
+
+            for (const auto& [key, value] : frozen)
+                pairs.emplace_back(key, value);
+
+            CHECK(pairs == Pairs(expected.begin(), expected.end()));
+
+            for (int i = 0; i < 1000; ++i) {
+                const int  key   = static_cast<int>(random() % 200010) - 5;
+                const auto it    = expected.find(key);
+                const auto lower = expected.lower_bound(key);
+
+                CHECK(frozen.IsExists(key) == (it != expected.end()));
+                CHECK(it == expected.end() ? frozen.Find(key) == frozen.end() : frozen.Find(key)->second == it->second);
+                CHECK(it == expected.end() || frozen.Get(key) == it->second);
+                CHECK(lower == expected.end() ? frozen.LowerBound(key) == frozen.end() : frozen.LowerBound(key)->first == lower->first);
+            }
+
+            if (size > 0) {
+                CHECK(frozen.GetMin() == expected.begin()->second);
+                CHECK(frozen.GetMax() == expected.rbegin()->second);
+            }
+        }
+    }
+
+    void TestFromSorted() {
+        const Pairs sorted   = { { 1, 10 }, { 2, 20 }, { 5, 50 } };
+        const Pairs unsorted = { { 1, 10 }, { 1, 20 } };
+
+        const auto frozen = DataStructures::FrozenTree<int, int>::FromSorted(sorted.begin(), sorted.end());
+
+        CHECK(frozen.Get(5) == 50);
+
+        bool isThrown = false;
+
+        try {
+            static_cast<void>(DataStructures::FrozenTree<int, int>::FromSorted(unsorted.begin(), unsorted.end()));
+        } catch (const std::invalid_argument&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestFreeze();
+    Tests::TestFromSorted();
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <cctype>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Trees/Common/KeyCompare.hpp"
+#include "Trees/Common/NodePool.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+// Built once as C++17 and, where the compiler has it, once more as C++20, so
+// the <=> path of CompareKeys is covered too.
+namespace Tests {
+
+    inline int g_BoolCallCount = 0;
+    inline int g_ThreeWayCount = 0;
+
+    // descending, through a plain bool comparator
+    struct GreaterBool {
+        bool operator ()(int lhs, int rhs) const {
+            ++g_BoolCallCount;
+            return lhs > rhs;
+        }
+    };
+
+    // descending, through a comparator returning an int
+    struct GreaterThreeWay {
+        int operator ()(int lhs, int rhs) const {
+            ++g_ThreeWayCount;
+            return lhs > rhs ? -1 : (lhs < rhs ? 1 : 0);
+        }
+    };
+
+    // a bool call for the standard algorithms and a compare member for the trees
+    struct CaseInsensitiveLess {
+        static int Compare(const std::string& lhs, const std::string& rhs) {
+            const std::size_t size = std::min(lhs.size(), rhs.size());
+
+            for (std::size_t i = 0; i < size; ++i) {
+                const int l = std::tolower(static_cast<unsigned char>(lhs[i]));
+                const int r = std::tolower(static_cast<unsigned char>(rhs[i]));
+
+                if (l != r)
+                    return l - r;
+            }
+
+            return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+        }
+
+        bool operator ()(const std::string& lhs, const std::string& rhs) const {
+            ++g_BoolCallCount;
+            return Compare(lhs, rhs) < 0;
+        }
+
+        int compare(const std::string& lhs, const std::string& rhs) const {
+            ++g_ThreeWayCount;
+            return Compare(lhs, rhs);
+        }
+    };
+
+    static_assert(!DataStructures::IsThreeWayCompare<GreaterBool, int, int>);
+    static_assert(DataStructures::IsThreeWayCompare<GreaterThreeWay, int, int>);
+    static_assert(!DataStructures::HasThreeWayMember<GreaterBool, int, int>::value);
+    static_assert(DataStructures::HasThreeWayMember<CaseInsensitiveLess, std::string, std::string>::value);
+
+    std::string MakeKey(int index, std::mt19937& random) {
+        std::string key = "Key" + std::to_string(index);
+
+        for (char& symbol : key)
+            symbol = random() % 2 ? static_cast<char>(std::toupper(static_cast<unsigned char>(symbol))) : symbol;
+
+        return key;
+    }
+
+    // Random operations against std::map under the same order. With a
+    // three-way comparator lookups must not call the bool one at all.
+    template <typename Tree, typename Map, typename MakeKey>
+    void TestOrder(MakeKey makeKey, bool isThreeWay) {
+        Tree         tree;
+        Map          expected;
+        std::mt19937 random(1);
+
+        for (int i = 0; i < 50000; ++i) {
+            const auto key = makeKey(static_cast<int>(random() % 2000), random);
+
+            switch (random() % 3) {
+                case 0:
+                    expected.emplace(key, i);
+                    tree.Push(key, i);
+                    break;
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                default: {
+                    const auto it            = expected.find(key);
+                    const int  boolCallCount = g_BoolCallCount;
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    CHECK(!isThreeWay || g_BoolCallCount == boolCallCount);
+                    break;
+                }
+            }
+        }
+
+        CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+
+        auto it = expected.begin();
+
+        for (auto current = tree.begin(); current != tree.end(); ++current, ++it)
+            CHECK(current->first == it->first && current->second == it->second);
+    }
+
+    template <template <typename, typename, bool, typename, template <typename> typename, typename> typename Tree>
+    void TestComparators() {
+        using DataStructures::NodePool;
+
+        const auto makeInt    = [](int index, std::mt19937&) { return index; };
+        const auto makeString = [](int index, std::mt19937& random) { return MakeKey(index, random); };
+
+        TestOrder<Tree<int, int, false, void, NodePool, GreaterBool>, std::map<int, int, std::greater<int>>>(makeInt, false);
+        TestOrder<Tree<int, int, false, void, NodePool, GreaterThreeWay>, std::map<int, int, std::greater<int>>>(makeInt, true);
+        TestOrder<Tree<std::string, int, false, void, NodePool, CaseInsensitiveLess>, std::map<std::string, int, CaseInsensitiveLess>>(makeString, true);
+    }
+
+    void TestCompareKeys() {
+        using DataStructures::CompareKeys;
+
+        CHECK(CompareKeys(DataStructures::KeyLess<int>(), 1, 2) < 0);
+        CHECK(CompareKeys(DataStructures::KeyLess<int>(), 2, 2) == 0);
+        CHECK(CompareKeys(std::less<std::string>(), std::string("b"), std::string("a")) > 0);
+        CHECK(CompareKeys(GreaterBool(), 1, 2) > 0);
+
+        const int threeWayCount = g_ThreeWayCount;
+        const int boolCallCount = g_BoolCallCount;
+
+        CHECK(CompareKeys(CaseInsensitiveLess(), std::string("ABC"), std::string("abd")) < 0);
+        CHECK(CompareKeys(CaseInsensitiveLess(), std::string("ABC"), std::string("abc")) == 0);
+        CHECK(g_ThreeWayCount == threeWayCount + 2);
+        CHECK(g_BoolCallCount == boolCallCount);
+    }
+
+#ifdef DATA_STRUCTURES_HAS_THREE_WAY
+    // A key ordered only by <=>, whose calls are counted: the natural order
+    // then costs a single call per comparison.
+    struct Version {
+        int Major;
+        int Minor;
+
+        std::strong_ordering operator <=>(const Version& other) const {
+            ++g_ThreeWayCount;
+
+            if (const auto order = Major <=> other.Major; order != 0)
+                return order;
+
+            return Minor <=> other.Minor;
+        }
+
+        bool operator ==(const Version& other) const = default;
+    };
+
+    // descending, through a comparator returning a C++20 ordering
+    struct GreaterOrdering {
+        std::weak_ordering operator ()(int lhs, int rhs) const { return rhs <=> lhs; }
+    };
+
+    void TestThreeWayOperator() {
+        using DataStructures::NodePool;
+
+        const int threeWayCount = g_ThreeWayCount;
+
+        CHECK(DataStructures::CompareKeys(DataStructures::KeyLess<Version>(), Version { 1, 2 }, Version { 1, 3 }) < 0);
+        CHECK(g_ThreeWayCount == threeWayCount + 1);
+
+        const auto makeVersion = [](int index, std::mt19937&) { return Version { index / 10, index % 10 }; };
+        const auto makeInt     = [](int index, std::mt19937&) { return index; };
+
+        TestOrder<DataStructures::RedBlackTree<Version, int>, std::map<Version, int>>(makeVersion, false);
+        TestOrder<DataStructures::SplayTree<Version, int>, std::map<Version, int>>(makeVersion, false);
+        TestOrder<DataStructures::RedBlackTree<int, int, false, void, NodePool, GreaterOrdering>, std::map<int, int, std::greater<int>>>(makeInt, true);
+    }
+#endif
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    using RedBlackTree = DataStructures::RedBlackTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>;
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid, template <typename> typename Allocator, typename Compare>
+    using SplayTree = DataStructures::SplayTree<Key, Value, HasOrderStatistics, Monoid, Allocator, Compare>;
+
+} // namespace Tests
+
+int main() {
+    Tests::TestCompareKeys();
+    Tests::TestComparators<Tests::RedBlackTree>();
+    Tests::TestComparators<Tests::SplayTree>();
+
+#ifdef DATA_STRUCTURES_HAS_THREE_WAY
+    Tests::TestThreeWayOperator();
+#endif
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Trees/Common/KeySearch.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Sorted distinct keys spread over the whole range of Key, so the extremes
+    // and the sign bit of unsigned keys are covered.
+    template <typename Key>
+    std::vector<Key> MakeKeys(int count, std::mt19937_64& random) {
+        std::vector<Key> keys;
+
+        keys.push_back(std::numeric_limits<Key>::lowest());
+        keys.push_back(std::numeric_limits<Key>::max());
+
+        while (static_cast<int>(keys.size()) < count)
+            keys.push_back(static_cast<Key>(random()));
+
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        return keys;
+    }
+
+    // LowerBound against std::lower_bound for every count up to a node of 4096
+    // bytes and for needles that are present, missing and out of range.
+    template <typename Key, typename Search>
+    void TestLowerBound(Search search) {
+        std::mt19937_64 random(1);
+
+        const int maxCount = static_cast<int>(4096 / sizeof(Key));
+
+        for (int round = 0; round < 100; ++round) {
+            const std::vector<Key> all = MakeKeys<Key>(maxCount, random);
+
+            for (int count = 0; count <= static_cast<int>(all.size()); count += 1 + count / 16) {
+                const std::vector<Key> keys(all.begin(), all.begin() + count);
+
+                std::vector<Key> needles = { std::numeric_limits<Key>::lowest(), std::numeric_limits<Key>::max() };
+
+                // a sample of the keys with the values on either side
+                for (int i = 0; count > 0 && i < 32; ++i) {
+                    const Key key = keys[random() % count];
+
+                    needles.push_back(key);
+                    needles.push_back(static_cast<Key>(key - 1));
+                    needles.push_back(static_cast<Key>(key + 1));
+                }
+
+                for (int i = 0; i < 8; ++i)
+                    needles.push_back(static_cast<Key>(random()));
+
+                for (const Key needle : needles) {
+                    const int expected = static_cast<int>(std::lower_bound(keys.begin(), keys.end(), needle) - keys.begin());
+
+                    CHECK(search(keys.data(), count, needle) == expected);
+                }
+            }
+        }
+    }
+
+    // The portable search and, on x86, every instruction set the CPU has.
+    template <typename Key>
+    void TestKeySearch() {
+        TestLowerBound<Key>([](const Key* keys, int count, const Key& key) {
+            return DataStructures::KeySearch<Key>::LowerBound(keys, count, key);
+        });
+
+#ifdef DATA_STRUCTURES_X86_SIMD
+        using Search         = DataStructures::KeySearch<Key>;
+        using InstructionSet = typename Search::InstructionSet;
+
+        const InstructionSet widest = Search::GetInstructionSet();
+
+        for (const InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::Sse42, InstructionSet::Avx2 }) {
+            if (static_cast<int>(instructionSet) > static_cast<int>(widest))
+                continue;
+
+            TestLowerBound<Key>([instructionSet](const Key* keys, int count, const Key& key) {
+                return Search::LowerBound(keys, count, key, instructionSet);
+            });
+        }
+#endif
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestKeySearch<std::int8_t>();
+    Tests::TestKeySearch<std::uint8_t>();
+    Tests::TestKeySearch<std::int16_t>();
+    Tests::TestKeySearch<std::uint16_t>();
+    Tests::TestKeySearch<std::int32_t>();
+    Tests::TestKeySearch<std::uint32_t>();
+    Tests::TestKeySearch<std::int64_t>();
+    Tests::TestKeySearch<std::uint64_t>();
+
+    // keys without packed compares take the generic path
+    Tests::TestLowerBound<double>([](const double* keys, int count, const double& key) {
+        return DataStructures::KeySearch<double>::LowerBound(keys, count, key);
+    });
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    constexpr std::size_t GetExpectedSize(std::size_t pairSize) {
+        return (pairSize + 7) / 8 * 8 + 3 * sizeof(void*);
+    }
+
+    // Nodes carry no vtable, and with 64-bit pointers take the pair rounded up
+    // to 8 bytes plus three links; the color of a red-black node hides in one.
+    template <typename Tree>
+    void CheckLayout() {
+        using Node = typename Tree::Node;
+
+        static_assert(!std::is_polymorphic_v<Node>);
+
+        if constexpr (sizeof(void*) == 8)
+            static_assert(sizeof(Node) == GetExpectedSize(sizeof(typename Tree::Pair)));
+    }
+
+    // Walks the links a node exposes: parents match children, keys are in
+    // order and, for the red-black tree, no red node has a red child and every
+    // path holds as many black nodes. Returns the black height.
+    template <typename Node>
+    int CheckNode(const Node* node, const Node* parent, const int* lo, const int* hi) {
+        if (!node)
+            return 1;
+
+        CHECK(node->GetParent() == parent);
+        CHECK(!lo || node->GetKey() > *lo);
+        CHECK(!hi || *hi > node->GetKey());
+
+        const int left  = CheckNode(node->GetLeft(), node, lo, &node->GetKey());
+        const int right = CheckNode(node->GetRight(), node, &node->GetKey(), hi);
+
+        if constexpr (std::is_same_v<Node, typename DataStructures::RedBlackTree<int, int>::Node>) {
+            using Color = typename Node::Color;
+
+            CHECK(left == right);
+
+            if (node->GetColor() == Color::Red) {
+                CHECK(!node->GetLeft() || node->GetLeft()->GetColor() == Color::Black);
+                CHECK(!node->GetRight() || node->GetRight()->GetColor() == Color::Black);
+            }
+
+            return left + (node->GetColor() == Color::Black ? 1 : 0);
+        } else {
+            return 1;
+        }
+    }
+
+    // The packed links against std::map, with the structure checked as it goes.
+    template <typename Tree>
+    void TestLinks() {
+        Tree               tree;
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        for (int i = 0; i < 20000; ++i) {
+            const int key = static_cast<int>(random() % 1000);
+
+            if (random() % 2) {
+                expected.emplace(key, i);
+                tree.Push(key, i);
+            } else {
+                expected.erase(key);
+                tree.Pop(key);
+            }
+
+            if (i % 100 == 0)
+                CheckNode(tree.GetRoot(), static_cast<const typename Tree::Node*>(nullptr), nullptr, nullptr);
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        for (const auto& [key, value] : expected)
+            CHECK(tree.Get(key) == value);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::CheckLayout<DataStructures::RedBlackTree<int, int>>();
+    Tests::CheckLayout<DataStructures::RedBlackTree<std::int64_t, std::string>>();
+    Tests::CheckLayout<DataStructures::SplayTree<int, int>>();
+    Tests::CheckLayout<DataStructures::SplayTree<char, char>>();
+
+    Tests::TestLinks<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestLinks<DataStructures::SplayTree<int, int>>();
+
+    return 0;
+}
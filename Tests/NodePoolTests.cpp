@@ -0,0 +1,157 @@
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Trees/Common/NodePool.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Counts the objects alive, so a pool that loses or destroys one twice shows.
+    struct Counted {
+        static inline int s_LiveCount = 0;
+
+        explicit Counted(int value = 0)
+            : Value(value) {
+            ++s_LiveCount;
+        }
+
+        Counted(const Counted& other)
+            : Value(other.Value) {
+            ++s_LiveCount;
+        }
+
+        ~Counted() {
+            --s_LiveCount;
+        }
+
+        Counted& operator =(const Counted& other) = default;
+
+        int Value;
+    };
+
+    // Slots given back are handed out again before the pool grows, and every
+    // slot stays apart from the others.
+    void TestPool() {
+        DataStructures::NodePool<Counted, 64> pool;
+        std::vector<Counted*>                 objects;
+        std::mt19937                          random(1);
+
+        for (int i = 0; i < 1000; ++i)
+            objects.push_back(pool.Allocate(i));
+
+        CHECK(std::set<Counted*>(objects.begin(), objects.end()).size() == objects.size());
+        CHECK(Counted::s_LiveCount == 1000);
+
+        std::set<Counted*> freed;
+
+        for (int i = 0; i < 500; ++i) {
+            const std::size_t index = random() % objects.size();
+
+            freed.insert(objects[index]);
+            pool.Deallocate(objects[index]);
+
+            objects[index] = objects.back();
+            objects.pop_back();
+        }
+
+        CHECK(Counted::s_LiveCount == 500);
+
+        for (int i = 0; i < 500; ++i) {
+            Counted* object = pool.Allocate(i);
+
+            CHECK(freed.count(object) == 1);
+            objects.push_back(object);
+        }
+
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            objects[i]->Value = static_cast<int>(i);
+
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            CHECK(objects[i]->Value == static_cast<int>(i));
+
+        for (Counted* object : objects)
+            pool.Deallocate(object);
+
+        pool.Release();
+
+        CHECK(Counted::s_LiveCount == 0);
+    }
+
+    using Pairs = std::vector<std::pair<int, std::string>>;
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    // Trees on the pool against std::map, with values that own memory of their
+    // own, so nodes freed without their destructor would leak under ASan.
+    template <typename Tree>
+    void TestTree() {
+        Tree                       tree;
+        std::map<int, std::string> expected;
+        std::mt19937               random(2);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 3000);
+
+            switch (random() % 3) {
+                case 0: {
+                    const std::string value(32, static_cast<char>('a' + i % 26));
+
+                    expected.emplace(key, value);
+                    tree.Push(key, value);
+                    break;
+                }
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                default: {
+                    const auto it = expected.find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+
+        tree.Clear();
+
+        CHECK(tree.IsEmpty());
+
+        // the pool serves the tree again after Clear
+        for (int key = 0; key < 5000; ++key)
+            tree.Push(key, std::to_string(key));
+
+        CHECK(tree.GetSize() == 5000);
+        CHECK(tree.Get(1234) == "1234");
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestPool();
+
+    Tests::TestTree<DataStructures::RedBlackTree<int, std::string>>();
+    Tests::TestTree<DataStructures::SplayTree<int, std::string>>();
+
+    return 0;
+}
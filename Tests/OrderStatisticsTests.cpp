@@ -0,0 +1,71 @@
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Rank and Select against the positions in std::map while the tree keeps
+    // changing, which the subtree sizes have to follow through every rotation.
+    template <typename Tree>
+    void TestOrderStatistics() {
+        Tree               tree;
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 5000);
+
+            switch (random() % 4) {
+                case 0:
+                    expected.emplace(key, i);
+                    tree.Push(key, i);
+                    break;
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                case 2:
+                    CHECK(tree.Rank(key) == static_cast<int>(std::distance(expected.begin(), expected.lower_bound(key))));
+                    break;
+                default: {
+                    if (expected.empty())
+                        break;
+
+                    const int  index = static_cast<int>(random() % expected.size());
+                    const auto it    = std::next(expected.begin(), index);
+                    auto       found = tree.Select(index);
+
+                    CHECK(found->first == it->first && found->second == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        // every position once, and one past the end
+        int index = 0;
+
+        for (const auto& [key, value] : expected) {
+            CHECK(tree.Select(index)->first == key);
+            CHECK(tree.Rank(key) == index);
+            ++index;
+        }
+
+        CHECK(tree.Select(index) == tree.end());
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestOrderStatistics<DataStructures::RedBlackTree<int, int, true>>();
+    Tests::TestOrderStatistics<DataStructures::SplayTree<int, int, true>>();
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Trees/PagedTree/PagedTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<std::int64_t, std::int64_t>>;
+
+    template <typename Container>
+    Pairs GetPairs(const Container& container) {
+        Pairs pairs;
+
+        for (auto it = container.begin(); it != container.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    std::map<std::int64_t, std::int64_t> MakePairs(int count, unsigned seed) {
+        std::map<std::int64_t, std::int64_t> pairs;
+        std::mt19937                         random(seed);
+
+        while (static_cast<int>(pairs.size()) < count)
+            pairs.emplace(static_cast<std::int64_t>(random() % (16 * count)), static_cast<std::int64_t>(random()));
+
+        return pairs;
+    }
+
+    // Far more pages than the pool holds, so lookups and updates keep evicting
+    // and rereading them. The tree is reopened from the file at the end.
+    void TestPagedTree() {
+        using Tree = DataStructures::PagedTree<std::int64_t, std::int64_t>;
+
+        const TemporaryFile                  file("DataStructuresPagedTreeTest.db");
+        std::map<std::int64_t, std::int64_t> expected;
+
+        {
+            Tree         tree(file.GetPath(), std::size_t(64) << 10);
+            std::mt19937 random(5);
+
+            for (int i = 0; i < 200000; ++i) {
+                const std::int64_t key = static_cast<std::int64_t>(random() % 50000);
+
+                switch (random() % 3) {
+                    case 0: {
+                        const auto [it, isNew] = expected.emplace(key, i);
+
+                        CHECK(tree.Push(key, i) == it->second);
+                        CHECK(isNew || tree.Get(key) == it->second);
+                        break;
+                    }
+                    case 1:
+                        expected.erase(key);
+                        tree.Pop(key);
+                        break;
+                    default: {
+                        const auto found = tree.Find(key);
+                        const auto it    = expected.find(key);
+
+                        CHECK(found.has_value() == (it != expected.end()));
+                        CHECK(!found || *found == it->second);
+                        break;
+                    }
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+            CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+            CHECK(tree.GetStatistics().MissCount > 0);
+        }
+
+        {
+            Tree tree(file.GetPath(), std::size_t(64) << 10);
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+            CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+
+            // an iterator left over from before Clear pins nothing afterwards, so
+            // the pool can still evict every frame while the tree fills again
+            Tree::ConstIterator stale = tree.begin();
+
+            tree.Clear();
+
+            CHECK(tree.IsEmpty());
+
+            for (std::int64_t key = 0; key < 20000; ++key)
+                tree.Push(key, -key);
+
+            stale = tree.end();
+
+            CHECK(tree.GetSize() == 20000);
+            CHECK(tree.Get(12345) == -12345);
+        }
+
+        // a file of another key and value type is refused
+        bool isThrown = false;
+
+        try {
+            DataStructures::PagedTree<std::int32_t, std::int32_t> other(file.GetPath());
+        } catch (const std::runtime_error&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+    }
+
+    // Overwrites size bytes at offset of the file with a copy of what lies at
+    // source, as a write cut short by a crash would leave them.
+    void TearFile(const std::string& path, std::streamoff offset, std::streamoff source, std::size_t size) {
+        std::fstream      stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        std::vector<char> bytes(size);
+
+        stream.seekg(source);
+        stream.read(bytes.data(), static_cast<std::streamsize>(size));
+        stream.seekp(offset);
+        stream.write(bytes.data(), static_cast<std::streamsize>(size));
+    }
+
+    // A page torn in the middle, by a crash or otherwise, is caught by its
+    // checksum when the tree reads it, the header page when the tree opens.
+    void TestTornPages() {
+        using Tree = DataStructures::PagedTree<std::int64_t, std::int64_t>;
+
+        constexpr std::streamoff PageSize = 4096;
+
+        const TemporaryFile                        file("DataStructuresTornPageTest.db");
+        const std::map<std::int64_t, std::int64_t> expected = MakePairs(20000, 6);
+
+        {
+            Tree tree(file.GetPath());
+
+            for (const auto& [key, value] : expected)
+                tree.Push(key, value);
+        }
+
+        {
+            const Tree tree(file.GetPath());
+
+            CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+        }
+
+        // the second half of a leaf from another page
+        TearFile(file.GetPath(), 5 * PageSize + PageSize / 2, 9 * PageSize + PageSize / 2, PageSize / 2);
+
+        bool isThrown = false;
+
+        try {
+            const Tree tree(file.GetPath());
+
+            (void)GetPairs(tree);
+        } catch (const std::runtime_error&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+
+        // a header with a few bytes of another page
+        TearFile(file.GetPath(), 16, PageSize + 16, 8);
+
+        isThrown = false;
+
+        try {
+            const Tree tree(file.GetPath());
+        } catch (const std::runtime_error&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestPagedTree();
+    Tests::TestTornPages();
+
+    return 0;
+}
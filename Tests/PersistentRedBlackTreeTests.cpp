@@ -0,0 +1,130 @@
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Trees/PersistentRedBlackTree/PersistentRedBlackTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Tree  = DataStructures::PersistentRedBlackTree<int, int>;
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    template <typename Container>
+    Pairs GetPairs(const Container& container) {
+        Pairs pairs;
+
+        for (const auto& [key, value] : container)
+            pairs.emplace_back(key, value);
+
+        return pairs;
+    }
+
+    // Changes the tree against std::map and keeps a View and a copy of the tree
+    // now and then, each of which has to stay the version it was taken at.
+    void TestVersions() {
+        Tree                                      tree;
+        std::map<int, int>                        expected;
+        std::vector<std::pair<Tree::View, Pairs>> views;
+        std::vector<std::pair<Tree, Pairs>>       copies;
+        std::mt19937                              random(1);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 2000);
+
+            switch (random() % 3) {
+                case 0: {
+                    const bool isNew = expected.emplace(key, i).second;
+
+                    CHECK(tree.Push(key, i) == isNew);
+                    break;
+                }
+                case 1:
+                    CHECK(tree.Pop(key) == (expected.erase(key) == 1));
+                    break;
+                default: {
+                    const auto it = expected.find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    CHECK(it == expected.end() || tree.Find(key)->second == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+
+            if (i % 10000 == 0)
+                views.emplace_back(tree.Snapshot(), Pairs(expected.begin(), expected.end()));
+
+            if (i % 25000 == 0)
+                copies.emplace_back(tree, Pairs(expected.begin(), expected.end()));
+        }
+
+        CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+
+        tree.Clear();
+
+        CHECK(tree.IsEmpty());
+
+        for (const auto& [view, pairs] : views) {
+            CHECK(view.GetSize() == static_cast<int>(pairs.size()));
+            CHECK(GetPairs(view) == pairs);
+        }
+
+        for (const auto& [copy, pairs] : copies)
+            CHECK(GetPairs(copy) == pairs);
+    }
+
+    // One writer and readers taking Snapshots without a lock. Every key holds
+    // its own value, so a View has to be sorted and hold nothing else.
+    void TestConcurrentSnapshots() {
+        Tree                     tree;
+        std::atomic<bool>        isDone { false };
+        std::vector<std::thread> readers;
+
+        for (int reader = 0; reader < 4; ++reader) {
+            readers.emplace_back([&tree, &isDone] {
+                while (!isDone.load(std::memory_order_relaxed)) {
+                    const Tree::View view  = tree.Snapshot();
+                    const Pairs      pairs = GetPairs(view);
+
+                    CHECK(view.GetSize() == static_cast<int>(pairs.size()));
+
+                    for (std::size_t i = 0; i < pairs.size(); ++i) {
+                        CHECK(pairs[i].first == pairs[i].second);
+                        CHECK(i == 0 || pairs[i - 1].first < pairs[i].first);
+                    }
+                }
+            });
+        }
+
+        std::mt19937 random(2);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 1000);
+
+            if (random() % 2)
+                tree.Push(key, key);
+            else
+                tree.Pop(key);
+        }
+
+        isDone = true;
+
+        for (std::thread& reader : readers)
+            reader.join();
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestVersions();
+    Tests::TestConcurrentSnapshots();
+
+    return 0;
+}
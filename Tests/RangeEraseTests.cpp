@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Map   = std::map<int, int>;
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    // ExtractRange and EraseRange against std::map, on ranges that may be empty
+    // or reach past either end of the tree.
+    template <typename Tree>
+    void TestRanges() {
+        std::mt19937 random(4);
+
+        for (int round = 0; round < 200; ++round) {
+            Map  pairs;
+            Tree tree;
+
+            for (int i = static_cast<int>(random() % 3000); i > 0; --i) {
+                const int key = static_cast<int>(random() % 10000);
+
+                if (pairs.emplace(key, -key).second)
+                    tree.Push(key, -key);
+            }
+
+            const int lo = static_cast<int>(random() % 10200) - 100;
+            const int hi = lo + static_cast<int>(random() % 3000) - 100;
+
+            const auto first = pairs.lower_bound(lo);
+            const auto last  = hi < lo ? first : pairs.upper_bound(hi);
+
+            const Pairs inside(first, last);
+
+            pairs.erase(first, last);
+
+            Tree extracted = tree.ExtractRange(lo, hi);
+
+            CHECK(extracted.GetSize() == static_cast<int>(inside.size()));
+            CHECK(GetPairs(extracted) == inside);
+            CHECK(tree.GetSize() == static_cast<int>(pairs.size()));
+            CHECK(GetPairs(tree) == Pairs(pairs.begin(), pairs.end()));
+
+            // the extracted tree stays usable on its own
+            extracted.Push(lo, 0);
+
+            CHECK(extracted.IsExists(lo));
+
+            const int eraseLo = static_cast<int>(random() % 10000);
+            const int eraseHi = eraseLo + static_cast<int>(random() % 2000);
+
+            const auto eraseFirst = pairs.lower_bound(eraseLo);
+            const auto eraseLast  = pairs.upper_bound(eraseHi);
+            const int  count      = static_cast<int>(std::distance(eraseFirst, eraseLast));
+
+            pairs.erase(eraseFirst, eraseLast);
+
+            CHECK(tree.EraseRange(eraseLo, eraseHi) == count);
+            CHECK(tree.GetSize() == static_cast<int>(pairs.size()));
+            CHECK(GetPairs(tree) == Pairs(pairs.begin(), pairs.end()));
+        }
+    }
+
+    // Extracting a range and dropping it, then filling the range again, must
+    // not hold on to the memory of the extracted trees.
+    template <typename Tree>
+    void TestExtractMemory() {
+        constexpr int KeyCount   = 20000;
+        constexpr int RoundCount = 400;
+
+        std::mt19937 random(5);
+
+        Tree         tree;
+        std::int64_t settled = 0;
+
+        for (int key = 0; key < KeyCount; ++key)
+            tree.Push(key, key);
+
+        for (int round = 0; round < RoundCount; ++round) {
+            const int lo = static_cast<int>(random() % KeyCount);
+            const int hi = lo + static_cast<int>(random() % (KeyCount / 2));
+
+            {
+                const Tree extracted = tree.ExtractRange(lo, hi);
+
+                CHECK(extracted.GetSize() + tree.GetSize() == KeyCount);
+            }
+
+            for (int key = lo; key <= hi && key < KeyCount; ++key)
+                tree.Push(key, key);
+
+            CHECK(tree.GetSize() == KeyCount);
+
+            if (round == RoundCount / 4)
+                settled = GetLiveBytes();
+        }
+
+        CHECK(GetLiveBytes() <= settled * 2);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestRanges<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestRanges<DataStructures::RedBlackTree<int, int, true>>();
+    Tests::TestRanges<DataStructures::SplayTree<int, int>>();
+    Tests::TestRanges<DataStructures::SplayTree<int, int, true>>();
+
+    Tests::TestExtractMemory<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestExtractMemory<DataStructures::RedBlackTree<int, int, true>>();
+    Tests::TestExtractMemory<DataStructures::SplayTree<int, int>>();
+    Tests::TestExtractMemory<DataStructures::SplayTree<int, int, true>>();
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+
+#include "Trees/Common/Monoids.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Map = std::map<int, int>;
+
+    struct Sum {
+        using Monoid = DataStructures::SumMonoid<std::int64_t>;
+
+        static std::int64_t Fold(Map::const_iterator first, Map::const_iterator last) {
+            std::int64_t sum = 0;
+
+            for (; first != last; ++first)
+                sum += first->second;
+
+            return sum;
+        }
+    };
+
+    struct Min {
+        using Monoid = DataStructures::MinMonoid<int>;
+
+        static int Fold(Map::const_iterator first, Map::const_iterator last) {
+            int min = std::numeric_limits<int>::max();
+
+            for (; first != last; ++first)
+                min = std::min(min, first->second);
+
+            return min;
+        }
+    };
+
+    struct Max {
+        using Monoid = DataStructures::MaxMonoid<int>;
+
+        static int Fold(Map::const_iterator first, Map::const_iterator last) {
+            int max = std::numeric_limits<int>::lowest();
+
+            for (; first != last; ++first)
+                max = std::max(max, first->second);
+
+            return max;
+        }
+    };
+
+    // RangeQuery against a fold over std::map while the tree changes, values
+    // changed in place through Get included, which Refresh has to bring into
+    // the summaries.
+    template <template <typename, typename, bool, typename> typename Tree, typename Fold>
+    void TestRangeQuery() {
+        Tree<int, int, false, typename Fold::Monoid> tree;
+        Map                                          expected;
+        std::mt19937                                 random(1);
+
+        for (int i = 0; i < 50000; ++i) {
+            const int key   = static_cast<int>(random() % 3000);
+            const int value = static_cast<int>(random() % 2001) - 1000;
+
+            switch (random() % 4) {
+                case 0:
+                    expected[key] = value;
+                    tree[key]     = value;
+                    tree.Refresh(key);
+                    break;
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                case 2:
+                    if (expected.count(key)) {
+                        expected[key] += value;
+                        tree.Get(key) += value;
+                        tree.Refresh(key);
+                    }
+
+                    break;
+                default: {
+                    const int lo = static_cast<int>(random() % 3100) - 50;
+                    const int hi = lo + static_cast<int>(random() % 1000) - 50;
+
+                    const auto first = expected.lower_bound(lo);
+                    const auto last  = hi < lo ? first : expected.upper_bound(hi);
+
+                    CHECK(tree.RangeQuery(lo, hi) == Fold::Fold(first, last));
+                    break;
+                }
+            }
+        }
+
+        CHECK(tree.RangeQuery(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()) == Fold::Fold(expected.begin(), expected.end()));
+    }
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid>
+    using RedBlackTree = DataStructures::RedBlackTree<Key, Value, HasOrderStatistics, Monoid>;
+
+    template <typename Key, typename Value, bool HasOrderStatistics, typename Monoid>
+    using SplayTree = DataStructures::SplayTree<Key, Value, HasOrderStatistics, Monoid>;
+
+} // namespace Tests
+
+int main() {
+    Tests::TestRangeQuery<Tests::RedBlackTree, Tests::Sum>();
+    Tests::TestRangeQuery<Tests::RedBlackTree, Tests::Min>();
+    Tests::TestRangeQuery<Tests::RedBlackTree, Tests::Max>();
+    Tests::TestRangeQuery<Tests::SplayTree, Tests::Sum>();
+    Tests::TestRangeQuery<Tests::SplayTree, Tests::Min>();
+    Tests::TestRangeQuery<Tests::SplayTree, Tests::Max>();
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Tree  = DataStructures::RedBlackTree<int, std::string>;
+    using Map   = std::map<int, std::string>;
+    using Pairs = std::vector<std::pair<int, std::string>>;
+
+    template <typename Iterator>
+    Pairs GetPairs(Iterator first, Iterator last) {
+        Pairs pairs;
+
+        for (; first != last; ++first)
+            pairs.emplace_back(first->first, first->second);
+
+        return pairs;
+    }
+
+    // The map interface against std::map: Push keeps the value of a key that is
+    // there, operator [] inserts a default value, values change in place
+    // through Get and the iterators, which walk both ways.
+    void TestMap() {
+        Tree         tree;
+        Map          expected;
+        std::mt19937 random(1);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 2000);
+
+            switch (random() % 5) {
+                case 0:
+                    expected.emplace(key, std::to_string(i));
+                    CHECK(tree.Push(key, std::to_string(i)) == expected[key]);
+                    break;
+                case 1:
+                    tree[key] += "x";
+                    expected[key] += "x";
+                    break;
+                case 2:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                case 3: {
+                    const auto it    = expected.find(key);
+                    const auto found = tree.Find(key);
+
+                    CHECK((found == tree.end()) == (it == expected.end()));
+                    CHECK(found == tree.end() || found->second == it->second);
+
+                    if (found != tree.end()) {
+                        found->second += "y";
+                        it->second += "y";
+                    }
+
+                    break;
+                }
+                default: {
+                    const auto it = expected.find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+
+                    bool isThrown = false;
+
+                    try {
+                        CHECK(tree.Get(key) == it->second);
+                    } catch (const std::out_of_range&) {
+                        isThrown = true;
+                    }
+
+                    CHECK(isThrown == (it == expected.end()));
+                    break;
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        }
+
+        const Pairs pairs(expected.begin(), expected.end());
+
+        CHECK(GetPairs(tree.begin(), tree.end()) == pairs);
+        CHECK(GetPairs(tree.cbegin(), tree.cend()) == pairs);
+
+        const Tree& constTree = tree;
+
+        CHECK(GetPairs(constTree.begin(), constTree.end()) == pairs);
+        CHECK(tree.GetMin() == expected.begin()->second);
+        CHECK(tree.GetMax() == expected.rbegin()->second);
+
+        // backwards from end
+        Pairs reversed;
+
+        for (auto it = tree.end(); it != tree.begin();) {
+            --it;
+            reversed.emplace_back(it->first, it->second);
+        }
+
+        CHECK(reversed == Pairs(expected.rbegin(), expected.rend()));
+
+        // iterator arithmetic
+        auto it = tree.begin();
+
+        it += static_cast<int>(expected.size() / 2);
+
+        CHECK(it->first == std::next(expected.begin(), static_cast<long>(expected.size() / 2))->first);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestMap();
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/Common/ThreadPool.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Map   = std::map<int, int>;
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    template <typename Tree>
+    Tree MakeTree(const Map& pairs) {
+        Tree tree;
+
+        for (const auto& [key, value] : pairs)
+            tree.Push(key, value);
+
+        return tree;
+    }
+
+    Map MakePairs(int count, int range, int tag, std::mt19937& random) {
+        Map pairs;
+
+        for (int i = 0; i < count; ++i) {
+            const int key = static_cast<int>(random() % range);
+
+            pairs[key] = key * 4 + tag;
+        }
+
+        return pairs;
+    }
+
+    // Union keeps the value of rhs and Intersection the value of lhs, which the
+    // tags of the values tell apart.
+    template <typename Tree>
+    void TestSetOperations(DataStructures::ThreadPool* pool) {
+        std::mt19937 random(1);
+
+        for (int round = 0; round < 40; ++round) {
+            const int range = 1 + static_cast<int>(random() % 100000);
+            const Map lhs   = MakePairs(static_cast<int>(random() % 20000), range, 1, random);
+            const Map rhs   = MakePairs(static_cast<int>(random() % 20000), range, 2, random);
+
+            Map unionPairs = lhs;
+            Map intersectionPairs;
+            Map differencePairs;
+
+            for (const auto& [key, value] : rhs)
+                unionPairs[key] = value;
+
+            for (const auto& [key, value] : lhs) {
+                if (rhs.count(key))
+                    intersectionPairs.emplace(key, value);
+                else
+                    differencePairs.emplace(key, value);
+            }
+
+            const Tree unionTree        = Tree::Union(MakeTree<Tree>(lhs), MakeTree<Tree>(rhs), pool);
+            const Tree intersectionTree = Tree::Intersection(MakeTree<Tree>(lhs), MakeTree<Tree>(rhs), pool);
+            const Tree differenceTree   = Tree::Difference(MakeTree<Tree>(lhs), MakeTree<Tree>(rhs), pool);
+
+            CHECK(unionTree.GetSize() == static_cast<int>(unionPairs.size()));
+            CHECK(GetPairs(unionTree) == Pairs(unionPairs.begin(), unionPairs.end()));
+            CHECK(intersectionTree.GetSize() == static_cast<int>(intersectionPairs.size()));
+            CHECK(GetPairs(intersectionTree) == Pairs(intersectionPairs.begin(), intersectionPairs.end()));
+            CHECK(differenceTree.GetSize() == static_cast<int>(differencePairs.size()));
+            CHECK(GetPairs(differenceTree) == Pairs(differencePairs.begin(), differencePairs.end()));
+        }
+    }
+
+} // namespace Tests
+
+int main() {
+    DataStructures::ThreadPool pool(4);
+
+    Tests::TestSetOperations<DataStructures::RedBlackTree<int, int>>(nullptr);
+    Tests::TestSetOperations<DataStructures::RedBlackTree<int, int>>(&pool);
+    Tests::TestSetOperations<DataStructures::RedBlackTree<int, int, true>>(&pool);
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Trees/BTree/BTree.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/ShardedTree/ShardedTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    // A key without std::hash, which range partitioning has to do without.
+    struct Id {
+        int Value;
+
+        bool operator <(const Id& other) const { return Value < other.Value; }
+        bool operator >(const Id& other) const { return Value > other.Value; }
+        bool operator ==(const Id& other) const { return Value == other.Value; }
+        bool operator !=(const Id& other) const { return Value != other.Value; }
+    };
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        tree.ForEach([&pairs](const auto& key, const auto& value) {
+            pairs.emplace_back(key, value);
+        });
+
+        return pairs;
+    }
+
+    // Random operations against std::map. Push keeps the value of a key that
+    // is there and reports whether the key was new, Pop whether it was there.
+    template <typename Tree>
+    void TestShardedTree(Tree& tree) {
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 5000);
+
+            switch (random() % 3) {
+                case 0:
+                    CHECK(tree.Push(key, i) == expected.emplace(key, i).second);
+                    break;
+                case 1:
+                    CHECK(tree.Pop(key) == (expected.erase(key) == 1));
+                    break;
+                default: {
+                    const auto it    = expected.find(key);
+                    const auto found = tree.Find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(found.has_value() == (it != expected.end()));
+                    CHECK(!found || *found == it->second);
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    break;
+                }
+            }
+
+            CHECK(tree.GetShardIndex(key) >= 0 && tree.GetShardIndex(key) < tree.GetShardCount());
+        }
+
+        CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        CHECK(GetPairs(tree) == Pairs(expected.begin(), expected.end()));
+
+        int size = 0;
+
+        for (const auto& statistics : tree.GetStatistics())
+            size += statistics.Size;
+
+        CHECK(size == tree.GetSize());
+
+        tree.Clear();
+
+        CHECK(tree.IsEmpty());
+    }
+
+    template <template <typename, typename> typename Engine>
+    void TestPartitionings() {
+        using Tree = DataStructures::ShardedTree<Engine, int, int>;
+
+        Tree hashed(16);
+        Tree ranged(std::vector<int> { 500, 1000, 2500, 4000 });
+
+        CHECK(hashed.GetPartitioning() == Tree::Partitioning::Hash);
+        CHECK(ranged.GetPartitioning() == Tree::Partitioning::Range);
+        CHECK(ranged.GetShardCount() == 5);
+        CHECK(ranged.GetShardIndex(499) == 0 && ranged.GetShardIndex(500) == 1 && ranged.GetShardIndex(4000) == 4);
+
+        TestShardedTree(hashed);
+        TestShardedTree(ranged);
+    }
+
+    void TestRangeWithoutHash() {
+        DataStructures::ShardedTree<DataStructures::RedBlackTree, Id, int> tree(std::vector<Id> { { 10 }, { 20 } });
+
+        for (int key = 0; key < 30; ++key)
+            CHECK(tree.Push(Id { key }, key));
+
+        CHECK(tree.GetShardIndex(Id { 9 }) == 0 && tree.GetShardIndex(Id { 10 }) == 1 && tree.GetShardIndex(Id { 29 }) == 2);
+        CHECK(tree.Get(Id { 15 }) == 15);
+        CHECK(tree.Pop(Id { 15 }) && !tree.Pop(Id { 15 }));
+
+        int previous = -1;
+
+        tree.ForEach([&previous](const Id& key, int value) {
+            CHECK(key.Value == value && previous < key.Value);
+
+            previous = key.Value;
+        });
+
+        bool isThrown = false;
+
+        try {
+            DataStructures::ShardedTree<DataStructures::RedBlackTree, Id, int> unsorted(std::vector<Id> { { 2 }, { 1 } });
+        } catch (const std::invalid_argument&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+    }
+
+    // Threads owning disjoint keys push and pop them, every thread knows what
+    // its keys should hold at the end.
+    void TestThreads() {
+        constexpr int ThreadCount = 4;
+
+        DataStructures::ShardedTree<DataStructures::SplayTree, int, int> tree(8);
+        std::vector<std::map<int, int>>                                  expected(ThreadCount);
+        std::vector<std::thread>                                         threads;
+
+        for (int thread = 0; thread < ThreadCount; ++thread) {
+            threads.emplace_back([&tree, &expected, thread] {
+                std::mt19937 random(static_cast<unsigned>(thread));
+
+                for (int i = 0; i < 50000; ++i) {
+                    const int key = static_cast<int>(random() % 2000) * ThreadCount + thread;
+
+                    if (random() % 2) {
+                        CHECK(tree.Push(key, i) == expected[thread].emplace(key, i).second);
+                    } else {
+                        CHECK(tree.Pop(key) == (expected[thread].erase(key) == 1));
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        std::map<int, int> all;
+
+        for (const auto& pairs : expected)
+            all.insert(pairs.begin(), pairs.end());
+
+        CHECK(GetPairs(tree) == Pairs(all.begin(), all.end()));
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestPartitionings<DataStructures::RedBlackTree>();
+    Tests::TestPartitionings<DataStructures::SplayTree>();
+    Tests::TestPartitionings<DataStructures::BTree>();
+    Tests::TestRangeWithoutHash();
+    Tests::TestThreads();
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Tree   = DataStructures::SplayTree<int, int>;
+    using Policy = DataStructures::SplayPolicy;
+
+    // Checks the order and the parent links below node and returns their count.
+    int CheckNode(const Tree::Node* node, const Tree::Node* parent, const int* lo, const int* hi) {
+        if (!node)
+            return 0;
+
+        CHECK(node->GetParent() == parent);
+        CHECK(!lo || *lo < node->GetKey());
+        CHECK(!hi || node->GetKey() < *hi);
+
+        return 1 + CheckNode(node->GetLeft(), node, lo, &node->GetKey()) + CheckNode(node->GetRight(), node, &node->GetKey(), hi);
+    }
+
+    int GetDepth(const Tree& tree, int key) {
+        int depth = 0;
+
+        for (const Tree::Node* node = tree.GetRoot(); node->GetKey() != key; node = key < node->GetKey() ? node->GetLeft() : node->GetRight())
+            ++depth;
+
+        return depth;
+    }
+
+    // Every policy keeps a valid tree that agrees with std::map.
+    void TestPolicy(const Policy& policy) {
+        Tree               tree;
+        std::map<int, int> expected;
+        std::mt19937       random(1);
+
+        tree.SetSplayPolicy(policy);
+
+        for (int i = 0; i < 100000; ++i) {
+            const int key = static_cast<int>(random() % 3000);
+
+            switch (random() % 4) {
+                case 0:
+                    expected[key] = i;
+                    tree[key]     = i;
+                    break;
+                case 1:
+                    expected.erase(key);
+                    tree.Pop(key);
+                    break;
+                case 2: {
+                    const auto it = expected.find(key);
+
+                    CHECK(tree.IsExists(key) == (it != expected.end()));
+                    CHECK(it == expected.end() || tree.Get(key) == it->second);
+                    break;
+                }
+                default: {
+                    const auto it            = expected.find(key);
+                    const auto [value, isHot] = tree.Peek(key);
+
+                    CHECK(it == expected.end() ? !value : *value == it->second);
+                    CHECK(!isHot || value);
+
+                    if (isHot)
+                        tree.Touch(key);
+
+                    break;
+                }
+            }
+
+            if (i % 10000 == 0)
+                CHECK(CheckNode(tree.GetRoot(), nullptr, nullptr, nullptr) == static_cast<int>(expected.size()));
+        }
+
+        CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+        CHECK(CheckNode(tree.GetRoot(), nullptr, nullptr, nullptr) == static_cast<int>(expected.size()));
+    }
+
+    // Ascending pushes leave a chain with the smallest key at the bottom.
+    void MakeChain(Tree& tree, int count) {
+        for (int key = 0; key < count; ++key)
+            tree.Push(key, key);
+
+        CHECK(GetDepth(tree, 0) == count - 1);
+    }
+
+    void TestNever() {
+        Tree tree;
+
+        MakeChain(tree, 100);
+        tree.SetSplayPolicy(Policy::Never());
+
+        const Tree::Node* root = tree.GetRoot();
+
+        for (int key = 0; key < 100; ++key) {
+            CHECK(tree.Get(key) == key);
+            CHECK(tree[key] == key);
+            CHECK(!tree.Peek(key).second);
+        }
+
+        CHECK(tree.GetRoot() == root);
+        CHECK(GetDepth(tree, 0) == 99);
+    }
+
+    // A deep access semi-splays, which about halves the depth of the node and
+    // of the path above it, and a shallow one changes nothing.
+    void TestDepthThreshold() {
+        constexpr int Count     = 1000;
+        constexpr int Threshold = 8;
+
+        Tree tree;
+
+        MakeChain(tree, Count);
+        tree.SetSplayPolicy(Policy::DepthThreshold(Threshold));
+
+        const Tree::Node* root = tree.GetRoot();
+
+        // the chain runs down the left, so depth d holds Count - 1 - d
+        CHECK(tree.Get(Count - 1 - Threshold) == Count - 1 - Threshold);
+        CHECK(tree.GetRoot() == root);
+
+        CHECK(tree.Peek(0).second);
+        CHECK(tree.GetRoot() == root);
+
+        CHECK(tree.Get(0) == 0);
+        CHECK(GetDepth(tree, 0) <= (Count - 1) / 2 + 1);
+        CHECK(tree.GetHeight() <= Count / 2 + 2);
+        CHECK(CheckNode(tree.GetRoot(), nullptr, nullptr, nullptr) == Count);
+
+        // repeated deep accesses keep halving
+        for (int round = 0; round < 20; ++round) {
+            for (int key = 0; key < Count; key += 7)
+                static_cast<void>(tree.Get(key));
+        }
+
+        CHECK(tree.GetHeight() < 64);
+        CHECK(CheckNode(tree.GetRoot(), nullptr, nullptr, nullptr) == Count);
+    }
+
+    void TestArguments() {
+        const auto isThrown = [](auto make) {
+            try {
+                static_cast<void>(make());
+            } catch (const std::invalid_argument&) {
+                return true;
+            }
+
+            return false;
+        };
+
+        CHECK(isThrown([] { return Policy::Probabilistic(1.5); }));
+        CHECK(isThrown([] { return Policy::Periodic(0); }));
+        CHECK(isThrown([] { return Policy::DepthThreshold(-1); }));
+    }
+
+} // namespace Tests
+
+int main() {
+    using Policy = DataStructures::SplayPolicy;
+
+    for (const Policy& policy : { Policy::Always(), Policy::Never(), Policy::Probabilistic(0.25), Policy::Periodic(4), Policy::DepthThreshold(6) })
+        Tests::TestPolicy(policy);
+
+    Tests::TestNever();
+    Tests::TestDepthThreshold();
+    Tests::TestArguments();
+
+    return 0;
+}
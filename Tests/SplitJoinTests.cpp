@@ -0,0 +1,153 @@
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Map   = std::map<int, int>;
+    using Pairs = std::vector<std::pair<int, int>>;
+
+    template <typename Tree>
+    Pairs GetPairs(const Tree& tree) {
+        Pairs pairs;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    template <typename Tree>
+    Tree MakeTree(const Map& pairs) {
+        Tree tree;
+
+        for (const auto& [key, value] : pairs)
+            tree.Push(key, value);
+
+        return tree;
+    }
+
+    Map MakePairs(int count, int range, std::mt19937& random) {
+        Map pairs;
+
+        for (int i = 0; i < count; ++i) {
+            const int key = static_cast<int>(random() % range);
+
+            pairs[key] = key * 4;
+        }
+
+        return pairs;
+    }
+
+    // Split and Join against std::map, sizes included, also after the halves
+    // were changed on their own.
+    template <typename Tree>
+    void TestSplitJoin() {
+        std::mt19937 random(2);
+
+        for (int round = 0; round < 200; ++round) {
+            Map       pairs = MakePairs(static_cast<int>(random() % 3000), 10000, random);
+            const int key   = static_cast<int>(random() % 10100);
+
+            Tree tree = MakeTree<Tree>(pairs);
+
+            auto [left, right] = tree.Split(key);
+
+            const auto middle = pairs.lower_bound(key);
+
+            CHECK(tree.GetSize() == 0);
+            CHECK(left.GetSize() == static_cast<int>(std::distance(pairs.begin(), middle)));
+            CHECK(right.GetSize() == static_cast<int>(std::distance(middle, pairs.end())));
+            CHECK(GetPairs(left) == Pairs(pairs.begin(), middle));
+            CHECK(GetPairs(right) == Pairs(middle, pairs.end()));
+
+            // the halves keep working as trees of their own
+            if (middle != pairs.begin()) {
+                const int first = pairs.begin()->first;
+
+                left.Pop(first);
+                pairs.erase(first);
+            }
+
+            if (key < 10000 && !pairs.count(key)) {
+                right.Push(key, key * 4);
+                pairs.emplace(key, key * 4);
+            }
+
+            Tree joined = Tree::Join(std::move(left), std::move(right));
+
+            CHECK(joined.GetSize() == static_cast<int>(pairs.size()));
+            CHECK(GetPairs(joined) == Pairs(pairs.begin(), pairs.end()));
+
+            for (int i = 0; i < 20; ++i) {
+                const int  probe = static_cast<int>(random() % 10000);
+                const auto it    = pairs.find(probe);
+
+                CHECK(joined.IsExists(probe) == (it != pairs.end()));
+                CHECK(it == pairs.end() || joined.Get(probe) == it->second);
+            }
+        }
+    }
+
+    // A tree that keeps splitting off and dropping a part of itself, then
+    // refilling it, must not hold on to the memory of the dropped parts.
+    template <typename Tree>
+    void TestSplitMemory() {
+        constexpr int KeyCount   = 20000;
+        constexpr int RoundCount = 400;
+
+        std::mt19937 random(3);
+
+        Tree         tree;
+        std::int64_t settled = 0;
+
+        for (int key = 0; key < KeyCount; ++key)
+            tree.Push(key, key);
+
+        for (int round = 0; round < RoundCount; ++round) {
+            const int key = static_cast<int>(random() % KeyCount);
+
+            auto [left, right] = tree.Split(key);
+
+            tree = random() % 2 ? std::move(left) : std::move(right);
+
+            left  = Tree();
+            right = Tree();
+
+            for (int i = 0; i < KeyCount; ++i)
+                tree.Push(i, i);
+
+            CHECK(tree.GetSize() == KeyCount);
+
+            // the pools grow to what the refills need within a few rounds
+            if (round == RoundCount / 4)
+                settled = GetLiveBytes();
+        }
+
+        CHECK(GetLiveBytes() <= settled * 2);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestSplitJoin<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestSplitJoin<DataStructures::RedBlackTree<int, int, true>>();
+    Tests::TestSplitJoin<DataStructures::SplayTree<int, int>>();
+    Tests::TestSplitJoin<DataStructures::SplayTree<int, int, true>>();
+
+    Tests::TestSplitMemory<DataStructures::RedBlackTree<int, int>>();
+    Tests::TestSplitMemory<DataStructures::RedBlackTree<int, int, true>>();
+    Tests::TestSplitMemory<DataStructures::SplayTree<int, int>>();
+    Tests::TestSplitMemory<DataStructures::SplayTree<int, int, true>>();
+
+    return 0;
+}
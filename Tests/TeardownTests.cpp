@@ -0,0 +1,109 @@
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Counts the values alive, so a teardown that skips or repeats a node shows.
+    struct Counted {
+        static inline int s_LiveCount = 0;
+
+        explicit Counted(int value = 0)
+            : Value(value) {
+            ++s_LiveCount;
+        }
+
+        Counted(const Counted& other)
+            : Value(other.Value) {
+            ++s_LiveCount;
+        }
+
+        ~Counted() {
+            --s_LiveCount;
+        }
+
+        Counted& operator =(const Counted& other) = default;
+
+        int Value;
+    };
+
+    // Keys pushed in order leave a splay tree a path as long as the tree, which
+    // a recursive teardown would not survive. Clear, the destructor and a move
+    // assignment over a full tree all have to destroy every value once.
+    template <typename Tree>
+    void TestDeepTeardown(int count) {
+        {
+            Tree tree;
+
+            for (int key = 0; key < count; ++key)
+                tree.Push(key, Counted(key));
+
+            CHECK(Counted::s_LiveCount == count);
+            CHECK(tree.GetSize() == count);
+
+            tree.Clear();
+
+            CHECK(Counted::s_LiveCount == 0);
+            CHECK(tree.IsEmpty());
+
+            for (int key = count; key > 0; --key)
+                tree.Push(key, Counted(key));
+
+            tree = Tree();
+
+            CHECK(Counted::s_LiveCount == 0);
+
+            for (int key = 0; key < count; ++key)
+                tree.Push(key, Counted(key));
+        }
+
+        CHECK(Counted::s_LiveCount == 0);
+    }
+
+    // Teardown after random changes against std::map.
+    template <typename Tree>
+    void TestRandomTeardown() {
+        std::mt19937 random(1);
+
+        for (int round = 0; round < 50; ++round) {
+            Tree               tree;
+            std::map<int, int> expected;
+
+            for (int i = static_cast<int>(random() % 5000); i > 0; --i) {
+                const int key = static_cast<int>(random() % 2000);
+
+                if (random() % 3 == 0) {
+                    expected.erase(key);
+                    tree.Pop(key);
+                } else if (expected.emplace(key, key).second) {
+                    tree.Push(key, Counted(key));
+                }
+            }
+
+            CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+            CHECK(Counted::s_LiveCount == static_cast<int>(expected.size()));
+
+            for (const auto& [key, value] : expected)
+                CHECK(tree.Get(key).Value == value);
+        }
+
+        CHECK(Counted::s_LiveCount == 0);
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestDeepTeardown<DataStructures::SplayTree<int, Tests::Counted>>(1000000);
+    Tests::TestDeepTeardown<DataStructures::RedBlackTree<int, Tests::Counted>>(100000);
+
+    Tests::TestRandomTeardown<DataStructures::SplayTree<int, Tests::Counted>>();
+    Tests::TestRandomTeardown<DataStructures::RedBlackTree<int, Tests::Counted>>();
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Trees/Common/KeyCompare.hpp"
+#include "Trees/Common/NodePool.hpp"
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/SplayTree/SplayTree.hpp"
+
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+
+namespace Tests {
+
+    // Longer than any small string buffer, so building a std::string to look
+    // one up would allocate.
+    std::string MakeKey(int index) {
+        return "a key long enough to live on the heap #" + std::to_string(index);
+    }
+
+    // Lookups by std::string_view and const char* against std::map with
+    // std::less<>, none of which may allocate.
+    template <typename Tree>
+    void TestTransparentLookup() {
+        Tree                                    tree;
+        std::map<std::string, int, std::less<>> expected;
+        std::mt19937                            random(1);
+
+        for (int i = 0; i < 5000; ++i) {
+            const int key = static_cast<int>(random() % 4000);
+
+            expected[MakeKey(key)] = i;
+            tree[MakeKey(key)]     = i;
+        }
+
+        // the keys are built up front, so only the lookups are counted
+        std::vector<std::string> keys;
+
+        for (int key = 0; key < 4100; ++key)
+            keys.push_back(MakeKey(key));
+
+        const std::int64_t allocationCount = GetAllocationCount();
+
+        for (const std::string& key : keys) {
+            const std::string_view view     = key;
+            const char*            pointer  = key.c_str();
+            const auto             it       = expected.find(view);
+            const bool             isExists = it != expected.end();
+
+            CHECK(tree.IsExists(view) == isExists);
+            CHECK(tree.IsExists(pointer) == isExists);
+            CHECK(!isExists || tree.Get(view) == it->second);
+            CHECK(!isExists || tree.Get(pointer) == it->second);
+            CHECK(!isExists || static_cast<const Tree&>(tree).Get(view) == it->second);
+        }
+
+        CHECK(GetAllocationCount() == allocationCount);
+
+        // Pop takes a view too, and frees without building a key
+        for (int key = 0; key < 4100; key += 3) {
+            const std::string& current = keys[static_cast<std::size_t>(key)];
+
+            tree.Pop(std::string_view(current));
+            expected.erase(current);
+        }
+
+        CHECK(tree.GetSize() == static_cast<int>(expected.size()));
+
+        for (const std::string& key : keys)
+            CHECK(tree.IsExists(std::string_view(key)) == (expected.count(key) == 1));
+    }
+
+} // namespace Tests
+
+int main() {
+    using DataStructures::KeyLess;
+    using DataStructures::NodePool;
+
+    Tests::TestTransparentLookup<DataStructures::RedBlackTree<std::string, int, false, void, NodePool, KeyLess<>>>();
+    Tests::TestTransparentLookup<DataStructures::SplayTree<std::string, int, false, void, NodePool, KeyLess<>>>();
+    Tests::TestTransparentLookup<DataStructures::RedBlackTree<std::string, int, false, void, NodePool, std::less<>>>();
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Trees/RedBlackTree/RedBlackTree.hpp"
+#include "Trees/TreeImage/TreeImage.hpp"
+
+#include "Check.hpp"
+
+namespace Tests {
+
+    using Pairs = std::vector<std::pair<std::int64_t, std::int64_t>>;
+
+    template <typename Container>
+    Pairs GetPairs(const Container& container) {
+        Pairs pairs;
+
+        for (auto it = container.begin(); it != container.end(); ++it)
+            pairs.emplace_back((*it).first, (*it).second);
+
+        return pairs;
+    }
+
+    std::map<std::int64_t, std::int64_t> MakePairs(int count, unsigned seed) {
+        std::map<std::int64_t, std::int64_t> pairs;
+        std::mt19937                         random(seed);
+
+        while (static_cast<int>(pairs.size()) < count)
+            pairs.emplace(static_cast<std::int64_t>(random() % (16 * count)), static_cast<std::int64_t>(random()));
+
+        return pairs;
+    }
+
+    // Lookups on a mapped image against std::map, then a second Save over the
+    // same path, which must leave the image already mapped as it was.
+    void TestTreeImage() {
+        using Image = DataStructures::TreeImage<std::int64_t, std::int64_t>;
+
+        const TemporaryFile                        file("DataStructuresTreeImageTest.img");
+        const std::map<std::int64_t, std::int64_t> expected = MakePairs(50000, 1);
+
+        Image::Save(file.GetPath(), expected.begin(), expected.end());
+
+        const Image image = Image::Open(file.GetPath());
+
+        CHECK(image.GetSize() == static_cast<int>(expected.size()));
+        CHECK(GetPairs(image) == Pairs(expected.begin(), expected.end()));
+
+        std::mt19937 random(2);
+
+        for (int i = 0; i < 100000; ++i) {
+            const std::int64_t key   = static_cast<std::int64_t>(random() % (16 * expected.size() + 16));
+            const auto         it    = expected.find(key);
+            const auto         lower = expected.lower_bound(key);
+
+            CHECK(image.IsExists(key) == (it != expected.end()));
+            CHECK(it == expected.end() || image.Get(key) == it->second);
+            CHECK(lower == expected.end() ? image.LowerBound(key) == image.end() : (*image.LowerBound(key)).first == lower->first);
+        }
+
+        const std::map<std::int64_t, std::int64_t> replacement = MakePairs(1000, 3);
+
+        Image::Save(file.GetPath(), replacement.begin(), replacement.end());
+
+        CHECK(GetPairs(image) == Pairs(expected.begin(), expected.end()));
+        CHECK(GetPairs(Image::Open(file.GetPath())) == Pairs(replacement.begin(), replacement.end()));
+
+        // keys out of order are refused and the old file stays
+        const Pairs unsorted { { 2, 0 }, { 1, 0 } };
+        bool        isThrown = false;
+
+        try {
+            Image::Save(file.GetPath(), unsorted.begin(), unsorted.end());
+        } catch (const std::invalid_argument&) {
+            isThrown = true;
+        }
+
+        CHECK(isThrown);
+        CHECK(GetPairs(Image::Open(file.GetPath())) == Pairs(replacement.begin(), replacement.end()));
+    }
+
+    void TestSaveLoad() {
+        using Tree = DataStructures::RedBlackTree<std::int64_t, std::int64_t>;
+
+        const TemporaryFile                        file("DataStructuresSaveLoadTest.img");
+        const std::map<std::int64_t, std::int64_t> expected = MakePairs(20000, 4);
+
+        Tree tree;
+
+        for (const auto& [key, value] : expected)
+            tree.Push(key, value);
+
+        tree.Save(file.GetPath());
+
+        const Tree loaded = Tree::Load(file.GetPath());
+
+        CHECK(loaded.GetSize() == static_cast<int>(expected.size()));
+        CHECK(GetPairs(loaded) == Pairs(expected.begin(), expected.end()));
+    }
+
+} // namespace Tests
+
+int main() {
+    Tests::TestTreeImage();
+    Tests::TestSaveLoad();
+
+    return 0;
+}